@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../events.hpp"
+#include "../profiler.hpp"
 
 /* Implementation, NOT to be passed around */
 
@@ -104,6 +105,29 @@ private:
 	DynamicArray<Entry> entries;
 };
 
+/// Records a dispatch's time to a tick profiler section, only the outermost one when a handler dispatches the same event again
+class DispatchProfile final
+{
+public:
+	DispatchProfile(ITickProfiler* profiler, int section, unsigned& depth)
+		: depth_(depth)
+		, profile_(depth_++ == 0 ? profiler : nullptr, section)
+	{
+	}
+
+	~DispatchProfile()
+	{
+		--depth_;
+	}
+
+	DispatchProfile(const DispatchProfile&) = delete;
+	DispatchProfile& operator=(const DispatchProfile&) = delete;
+
+private:
+	unsigned& depth_;
+	ScopedTickProfile profile_;
+};
+
 template <class EventHandlerType>
 struct DefaultEventDispatcher final : public IEventDispatcher<EventHandlerType>, public NoCopy
 {
@@ -124,9 +148,19 @@ struct DefaultEventDispatcher final : public IEventDispatcher<EventHandlerType>,
 		return handlers.has(handler, priority);
 	}
 
+	/// Record the time spent in every dispatch to a tick profiler section
+	/// @param profiler The profiler to record to, or nullptr to stop recording
+	/// @param name The name of the section
+	void setProfiler(ITickProfiler* profiler, StringView name)
+	{
+		profiler_ = profiler;
+		section_ = profiler ? profiler->addSection(name) : -1;
+	}
+
 	template <typename Return, typename... Params, typename... Args>
 	void dispatch(Return (EventHandlerType::*mf)(Params...), Args&&... args)
 	{
+		DispatchProfile profile(profiler_, section_, depth_);
 		for (const typename Storage::Entry& storage : handlers)
 		{
 			EventHandlerType* handler = storage.handler;
@@ -137,18 +171,21 @@ struct DefaultEventDispatcher final : public IEventDispatcher<EventHandlerType>,
 	template <typename Fn>
 	void all(Fn fn)
 	{
+		DispatchProfile profile(profiler_, section_, depth_);
 		std::for_each(handlers.begin(), handlers.end(), typename Storage::template Func<void, Fn>(fn));
 	}
 
 	template <typename Fn>
 	auto stopAtFalse(Fn fn)
 	{
+		DispatchProfile profile(profiler_, section_, depth_);
 		return std::all_of(handlers.begin(), handlers.end(), typename Storage::template Func<bool, Fn>(fn));
 	}
 
 	template <typename Fn>
 	auto anyTrue(Fn fn)
 	{
+		DispatchProfile profile(profiler_, section_, depth_);
 		// `anyTrue` should still CALL them call, don't short-circuit.
 		bool ret = false;
 		std::for_each(handlers.begin(), handlers.end(), typename Storage::template Func<bool, Fn>([&fn, &ret]()
@@ -161,12 +198,14 @@ struct DefaultEventDispatcher final : public IEventDispatcher<EventHandlerType>,
 	template <typename Fn>
 	auto stopAtTrue(Fn fn)
 	{
+		DispatchProfile profile(profiler_, section_, depth_);
 		return std::any_of(handlers.begin(), handlers.end(), typename Storage::template Func<bool, Fn>(fn));
 	}
 
 	template <typename Fn>
 	auto allTrue(Fn fn)
 	{
+		DispatchProfile profile(profiler_, section_, depth_);
 		bool ret = true;
 		std::for_each(handlers.begin(), handlers.end(), typename Storage::template Func<bool, Fn>([&fn, &ret]()
 															{
@@ -182,6 +221,9 @@ struct DefaultEventDispatcher final : public IEventDispatcher<EventHandlerType>,
 
 private:
 	Storage handlers;
+	ITickProfiler* profiler_ = nullptr;
+	int section_ = -1;
+	unsigned depth_ = 0;
 };
 
 template <class EventHandlerType>
@@ -235,6 +277,15 @@ struct DefaultIndexedEventDispatcher final : public IIndexedEventDispatcher<Even
 		return handlers[index].has(handler, priority);
 	}
 
+	/// Record the time spent in every dispatch, whatever the index, to a tick profiler section
+	/// @param profiler The profiler to record to, or nullptr to stop recording
+	/// @param name The name of the section
+	void setProfiler(ITickProfiler* profiler, StringView name)
+	{
+		profiler_ = profiler;
+		section_ = profiler ? profiler->addSection(name) : -1;
+	}
+
 	template <typename Return, typename... Params, typename... Args>
 	void dispatch(size_t index, Return (EventHandlerType::*mf)(Params...), Args&&... args)
 	{
@@ -242,6 +293,7 @@ struct DefaultIndexedEventDispatcher final : public IIndexedEventDispatcher<Even
 		{
 			return;
 		}
+		DispatchProfile profile(profiler_, section_, depth_);
 		for (const typename Storage::Entry& storage : handlers[index])
 		{
 			EventHandlerType* handler = storage.handler;
@@ -252,17 +304,22 @@ struct DefaultIndexedEventDispatcher final : public IIndexedEventDispatcher<Even
 	template <typename Fn>
 	void all(size_t index, Fn fn)
 	{
+		DispatchProfile profile(profiler_, section_, depth_);
 		std::for_each(handlers[index].begin(), handlers[index].end(), typename Storage::template Func<void, Fn>(fn));
 	}
 
 	template <typename Fn>
 	bool stopAtFalse(size_t index, Fn fn)
 	{
+		DispatchProfile profile(profiler_, section_, depth_);
 		return std::all_of(handlers[index].begin(), handlers[index].end(), typename Storage::template Func<bool, Fn>(fn));
 	}
 
 private:
 	DynamicArray<Storage> handlers;
+	ITickProfiler* profiler_ = nullptr;
+	int section_ = -1;
+	unsigned depth_ = 0;
 };
 
 }
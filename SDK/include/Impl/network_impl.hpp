@@ -26,6 +26,19 @@ struct Network : public INetwork, public NoCopy
 	{
 	}
 
+	/// Record the time spent in the network's dispatches to tick profiler sections
+	/// @param profiler The profiler to record to, or nullptr to stop recording
+	void setProfiler(ITickProfiler* profiler)
+	{
+		networkEventDispatcher.setProfiler(profiler, "NetworkEventHandler");
+		inEventDispatcher.setProfiler(profiler, "NetworkInEventHandler");
+		rpcInEventDispatcher.setProfiler(profiler, "SingleNetworkInEventHandler (RPC)");
+		packetInEventDispatcher.setProfiler(profiler, "SingleNetworkInEventHandler (packet)");
+		outEventDispatcher.setProfiler(profiler, "NetworkOutEventHandler");
+		rpcOutEventDispatcher.setProfiler(profiler, "SingleNetworkOutEventHandler (RPC)");
+		packetOutEventDispatcher.setProfiler(profiler, "SingleNetworkOutEventHandler (packet)");
+	}
+
 	IEventDispatcher<NetworkEventHandler>& getEventDispatcher() override
 	{
 		return networkEventDispatcher;
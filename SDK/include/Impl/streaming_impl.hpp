@@ -0,0 +1,202 @@
+#pragma once
+
+#include "../core.hpp"
+#include "../player.hpp"
+#include <algorithm>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// Computes per-player stream sets on the core's worker threads and applies the differences on the main thread
+/// Players are queued when their stream timer fires; on update() the implementation snapshots the entities and the
+/// queued players, the desired states are decided in parallel and stream ins/outs are applied in player then entity ID order
+/// @typeparam EntitySnapshot The per-entity state needed to decide streaming, must have an `int id` member
+/// @typeparam ViewerSnapshot The per-player state needed to decide streaming
+template <typename EntitySnapshot, typename ViewerSnapshot>
+struct ParallelStreamer : public IParallelTask, public NoCopy
+{
+	/// Queue a player to have their stream set recomputed on the next update
+	void queue(IPlayer& player)
+	{
+		queued_.set(player.getID());
+	}
+
+	/// Limit how many entities are streamed in for each player per update, the rest follow in the next updates
+	/// @param budget The limit, 0 for none
+	void setStreamInBudget(size_t budget)
+	{
+		streamInBudget_ = budget;
+	}
+
+	/// Forget an entity that is being destroyed, its stream ins/outs still pending in the current update are dropped
+	/// Must be called from the main thread before the entity's ID can be reused
+	/// @param id The ID of the entity
+	void remove(int id)
+	{
+		if (!applying_)
+		{
+			return;
+		}
+
+		auto it = std::lower_bound(entities_.begin(), entities_.end(), id, [](const EntitySnapshot& entity, int id)
+			{
+				return entity.id < id;
+			});
+		if (it != entities_.end() && it->id == id)
+		{
+			removed_[it - entities_.begin()] = true;
+		}
+	}
+
+	/// Snapshot, compute and apply the stream sets of every queued player
+	/// Must be called from the main thread
+	void update(ICore& core)
+	{
+		if (queued_.none())
+		{
+			return;
+		}
+
+		entities_.clear();
+		snapshotEntities(entities_);
+		std::sort(entities_.begin(), entities_.end(), [](const EntitySnapshot& a, const EntitySnapshot& b)
+			{
+				return a.id < b.id;
+			});
+
+		IPlayerPool& players = core.getPlayers();
+		jobCount_ = 0;
+		for (int i = 0; i != PLAYER_POOL_SIZE; ++i)
+		{
+			if (!queued_.test(i))
+			{
+				continue;
+			}
+
+			IPlayer* player = players.get(i);
+			if (player == nullptr)
+			{
+				continue;
+			}
+
+			if (jobCount_ == jobs_.size())
+			{
+				jobs_.emplace_back();
+			}
+
+			Job& job = jobs_[jobCount_];
+			job.playerID = i;
+			job.streamIn.clear();
+			job.streamOut.clear();
+			if (snapshotViewer(*player, job.viewer))
+			{
+				++jobCount_;
+			}
+		}
+		queued_.reset();
+
+		core.runParallel(*this, jobCount_);
+
+		removed_.assign(entities_.size(), false);
+		applying_ = true;
+		for (size_t i = 0; i != jobCount_; ++i)
+		{
+			const Job& job = jobs_[i];
+
+			// Re-resolve the player, stream callbacks can disconnect them.
+			IPlayer* player = players.get(job.playerID);
+			if (player == nullptr)
+			{
+				continue;
+			}
+
+			for (uint32_t index : job.streamOut)
+			{
+				if (!removed_[index])
+				{
+					streamOut(*player, entities_[index]);
+				}
+			}
+			size_t streamIns = job.streamIn.size();
+			if (streamInBudget_ != 0 && streamIns > streamInBudget_)
+			{
+				// Spread a burst over updates, the player's set is recomputed for the rest in the next one.
+				streamIns = streamInBudget_;
+				queued_.set(job.playerID);
+			}
+			for (size_t j = 0; j != streamIns; ++j)
+			{
+				const uint32_t index = job.streamIn[j];
+				if (!removed_[index])
+				{
+					streamIn(*player, entities_[index]);
+				}
+			}
+		}
+		applying_ = false;
+	}
+
+	void process(size_t begin, size_t end) override
+	{
+		const uint32_t count = entities_.size();
+		for (size_t i = begin; i != end; ++i)
+		{
+			Job& job = jobs_[i];
+			for (uint32_t index = 0; index != count; ++index)
+			{
+				const EntitySnapshot& entity = entities_[index];
+				const bool shouldBeStreamedIn = shouldStreamIn(job.viewer, entity);
+				const bool isStreamedIn = streamedIn(job.viewer, entity);
+				if (!isStreamedIn && shouldBeStreamedIn)
+				{
+					job.streamIn.push_back(index);
+				}
+				else if (isStreamedIn && !shouldBeStreamedIn)
+				{
+					job.streamOut.push_back(index);
+				}
+			}
+		}
+	}
+
+protected:
+	/// Fill the entity snapshots, called on the main thread
+	virtual void snapshotEntities(DynamicArray<EntitySnapshot>& entities) = 0;
+
+	/// Fill a player's snapshot, called on the main thread
+	/// @return False to skip recomputing this player's stream set
+	virtual bool snapshotViewer(IPlayer& player, ViewerSnapshot& viewer) = 0;
+
+	/// Whether the entity should be streamed in for the player, called from worker threads
+	virtual bool shouldStreamIn(const ViewerSnapshot& viewer, const EntitySnapshot& entity) const = 0;
+
+	/// Whether the entity is currently streamed in for the player, called from worker threads
+	virtual bool streamedIn(const ViewerSnapshot& viewer, const EntitySnapshot& entity) const = 0;
+
+	/// Stream the entity in for the player, called on the main thread; entities passed to remove() are skipped
+	virtual void streamIn(IPlayer& player, const EntitySnapshot& entity) = 0;
+
+	/// Stream the entity out for the player, called on the main thread; entities passed to remove() are skipped
+	virtual void streamOut(IPlayer& player, const EntitySnapshot& entity) = 0;
+
+private:
+	struct Job
+	{
+		int playerID;
+		ViewerSnapshot viewer;
+		DynamicArray<uint32_t> streamIn;
+		DynamicArray<uint32_t> streamOut;
+	};
+
+	StaticBitset<PLAYER_POOL_SIZE> queued_;
+	DynamicArray<EntitySnapshot> entities_;
+	DynamicArray<bool> removed_;
+	DynamicArray<Job> jobs_;
+	size_t jobCount_ = 0;
+	size_t streamInBudget_ = 0;
+	bool applying_ = false;
+};
+
+}
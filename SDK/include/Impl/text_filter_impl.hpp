@@ -0,0 +1,190 @@
+#pragma once
+
+#include "../types.hpp"
+#include <algorithm>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// Filters player chat and commands in one pass over the text
+/// Formatting the client would render is neutralised: `~k`, `~K` and `%` become `#` and `{RRGGBB}` colour embeds become
+/// a space. Words from an optional list are matched case insensitively with an Aho-Corasick automaton over the filtered
+/// text and replaced with as many `*`. The result is written to a buffer reused between calls.
+class TextFilter final : public NoCopy
+{
+public:
+	/// Build the automaton for a word list, replacing the previous one
+	void setWords(Span<const StringView> words)
+	{
+		classes_.fill(0);
+		transitions_.clear();
+		matchLength_.clear();
+		classCount_ = 1;
+
+		// Only the bytes used by the words get their own column, anything else is class 0 which always leads back to the root.
+		for (StringView word : words)
+		{
+			for (char c : word)
+			{
+				uint8_t& cls = classes_[fold(c)];
+				if (cls == 0)
+				{
+					cls = classCount_++;
+				}
+			}
+		}
+		for (int c = 'A'; c <= 'Z'; ++c)
+		{
+			classes_[c] = classes_[c - 'A' + 'a'];
+		}
+
+		bool empty = true;
+		addNode();
+		for (StringView word : words)
+		{
+			if (word.empty())
+			{
+				continue;
+			}
+			empty = false;
+			int node = 0;
+			for (char c : word)
+			{
+				const size_t edge = node * classCount_ + classes_[uint8_t(c)];
+				if (transitions_[edge] < 0)
+				{
+					// Not a reference as adding the node can move the table.
+					const int child = addNode();
+					transitions_[edge] = child;
+				}
+				node = transitions_[edge];
+			}
+			matchLength_[node] = std::max<int>(matchLength_[node], word.size());
+		}
+
+		if (empty)
+		{
+			transitions_.clear();
+			matchLength_.clear();
+			return;
+		}
+
+		// Breadth first so a node's failure state is complete before its children use it, turning the trie into a DFA.
+		DynamicArray<int> fail(matchLength_.size(), 0);
+		DynamicArray<int> queue;
+		queue.reserve(matchLength_.size());
+		queue.push_back(0);
+		for (size_t i = 0; i != queue.size(); ++i)
+		{
+			const int node = queue[i];
+			for (int cls = 0; cls != classCount_; ++cls)
+			{
+				int& next = transitions_[node * classCount_ + cls];
+				const int fallback = node == 0 ? 0 : transitions_[fail[node] * classCount_ + cls];
+				if (next < 0)
+				{
+					next = fallback;
+				}
+				else
+				{
+					fail[next] = fallback;
+					matchLength_[next] = std::max(matchLength_[next], matchLength_[fallback]);
+					queue.push_back(next);
+				}
+			}
+		}
+	}
+
+	/// Filter text into the reusable buffer
+	/// @param formatting Whether to neutralise formatting codes
+	/// @param censor Whether to replace listed words, which is only wanted for chat as it would break command names
+	/// @return The filtered text, valid and null terminated until the next call
+	StringView filter(StringView text, bool formatting, bool censor)
+	{
+		buffer_.clear();
+		buffer_.reserve(text.size());
+
+		const bool words = censor && !transitions_.empty();
+		int state = 0;
+		for (size_t i = 0, size = text.size(); i < size;)
+		{
+			char c = text[i++];
+			if (formatting)
+			{
+				if (c == '%')
+				{
+					c = '#';
+				}
+				else if (c == '~' && i < size && (text[i] == 'k' || text[i] == 'K'))
+				{
+					c = '#';
+					++i;
+				}
+				else if (c == '{' && isColourEmbed(text, i - 1))
+				{
+					c = ' ';
+					i += 7;
+				}
+			}
+			buffer_.push_back(c);
+
+			if (words)
+			{
+				state = transitions_[state * classCount_ + classes_[uint8_t(c)]];
+				if (matchLength_[state])
+				{
+					std::fill(buffer_.end() - matchLength_[state], buffer_.end(), '*');
+				}
+			}
+		}
+
+		return StringView(buffer_);
+	}
+
+private:
+	static uint8_t fold(char c)
+	{
+		return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : uint8_t(c);
+	}
+
+	static bool isHex(char c)
+	{
+		return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+	}
+
+	static bool isColourEmbed(StringView text, size_t start)
+	{
+		if (start + 8 > text.size() || text[start + 7] != '}')
+		{
+			return false;
+		}
+		for (size_t i = start + 1; i != start + 7; ++i)
+		{
+			if (!isHex(text[i]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	int addNode()
+	{
+		transitions_.resize(transitions_.size() + classCount_, -1);
+		matchLength_.push_back(0);
+		return matchLength_.size() - 1;
+	}
+
+	/// Column of each byte in the transition table
+	StaticArray<uint8_t, 256> classes_ {};
+	int classCount_ = 1;
+	/// Next state for each state and byte class, empty when there's no word list
+	DynamicArray<int> transitions_;
+	/// Length of the longest word ending in each state, 0 for none
+	DynamicArray<int> matchLength_;
+	String buffer_;
+};
+
+}
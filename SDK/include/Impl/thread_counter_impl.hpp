@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../types.hpp"
+#include <atomic>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// A counter that can be added to from any thread without the threads fighting over one cache line
+/// Each thread adds to its own slot with a relaxed atomic, only reading the value sums the slots. Threads beyond the slot
+/// count share slots, which stays correct and only costs some contention.
+class ThreadCounter final : public NoCopy
+{
+public:
+	void add(uint64_t count = 1)
+	{
+		slots_[threadSlot()].value.fetch_add(count, std::memory_order_relaxed);
+	}
+
+	/// Get the sum of every thread's additions, can be called from any thread
+	uint64_t get() const
+	{
+		uint64_t sum = 0;
+		for (const Slot& slot : slots_)
+		{
+			sum += slot.value.load(std::memory_order_relaxed);
+		}
+		return sum;
+	}
+
+private:
+	static constexpr size_t SlotCount = 16;
+
+	struct alignas(64) Slot
+	{
+		std::atomic<uint64_t> value { 0 };
+	};
+
+	static size_t threadSlot()
+	{
+		static std::atomic<size_t> nextSlot { 0 };
+		static thread_local const size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % SlotCount;
+		return slot;
+	}
+
+	StaticArray<Slot, SlotCount> slots_;
+};
+
+}
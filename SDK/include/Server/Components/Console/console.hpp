@@ -8,6 +8,12 @@ struct ConsoleMessageHandler
 	virtual void handleConsoleMessage(StringView message) = 0;
 };
 
+/// A message handler for commands queued with IConsoleComponent::queue, which frees it once the command has run
+struct QueuedConsoleMessageHandler : public ConsoleMessageHandler
+{
+	virtual void free() = 0;
+};
+
 /// The command sender types
 enum class ConsoleCommandSender
 {
@@ -66,6 +72,10 @@ struct IConsoleComponent : public IComponent
 	/// Send a console command
 	virtual void send(StringView command, const ConsoleCommandSenderData& sender = ConsoleCommandSenderData()) = 0;
 	virtual void sendMessage(const ConsoleCommandSenderData& recipient, StringView message) = 0;
+
+	/// Queue a console command to run in the main thread during a later tick, can be called from any thread
+	/// @param handler The handler to send the command's output to, freed once the command has run, or nullptr for the console
+	virtual void queue(StringView command, QueuedConsoleMessageHandler* handler = nullptr) = 0;
 };
 
 static const UID PlayerConsoleData_UID = UID(0x9f8d20f2f471cbae);
@@ -116,6 +116,79 @@ struct IDatabaseResultSet : public IExtensible, public IIDProvider
 	virtual LegacyDBResult& getLegacyDBResult() = 0;
 };
 
+/// A compiled SQL statement, executed with values bound to its parameters instead of formatted in to the SQL
+struct IDatabaseStatement : public IExtensible, public IIDProvider
+{
+
+	/// Gets the index of a named parameter, such as ":name" or "?1"
+	/// @param parameterName Parameter name, including its prefix
+	/// @returns Parameter index, or 0 if there's no such parameter
+	virtual int getParameterIndex(StringView parameterName) const = 0;
+
+	/// Binds an integer to a parameter
+	/// @param parameterIndex Parameter index, starting at 1
+	/// @param value Integer
+	/// @returns "true" if value has been successfully bound, otherwise "false"
+	virtual bool bindInt(int parameterIndex, long value) = 0;
+
+	/// Binds a floating point number to a parameter
+	/// @param parameterIndex Parameter index, starting at 1
+	/// @param value Floating point number
+	/// @returns "true" if value has been successfully bound, otherwise "false"
+	virtual bool bindFloat(int parameterIndex, double value) = 0;
+
+	/// Binds a copy of a string to a parameter
+	/// @param parameterIndex Parameter index, starting at 1
+	/// @param value String
+	/// @returns "true" if value has been successfully bound, otherwise "false"
+	virtual bool bindString(int parameterIndex, StringView value) = 0;
+
+	/// Binds NULL to a parameter
+	/// @param parameterIndex Parameter index, starting at 1
+	/// @returns "true" if value has been successfully bound, otherwise "false"
+	virtual bool bindNull(int parameterIndex) = 0;
+
+	/// Binds NULL to all parameters
+	virtual void clearBindings() = 0;
+
+	/// Steps through the statement with the currently bound values, bindings are kept for the next execution
+	/// @returns Result set with all rows stepped through, or "nullptr" on error
+	virtual IDatabaseResultSet* execute() = 0;
+};
+
+/// Receives the result of an asynchronous query
+struct DatabaseQueryHandler
+{
+	/// Called on the main thread once the query has executed, in the order the connection's queries were queued
+	/// @param resultSet Result set, only valid during the call, or "nullptr" if the query failed
+	virtual void onDatabaseQueryExecuted(IDatabaseResultSet* resultSet) = 0;
+
+	/// Called instead if the result can't be delivered, because the component is shutting down
+	virtual void onDatabaseQueryCancelled() = 0;
+};
+
+/// Statistics of a connection's write batches
+struct DatabaseWriteBatchStats
+{
+	/// Number of batches executed
+	std::size_t batches;
+
+	/// Number of queued writes executed in the batches
+	std::size_t queries;
+
+	/// Number of queued writes that failed, including those in batches that couldn't be committed
+	std::size_t failedQueries;
+
+	/// Number of writes in the last batch
+	std::size_t lastSize;
+
+	/// Time the last batch took to execute and commit
+	Microseconds lastLatency;
+
+	/// Longest time a batch took to execute and commit
+	Microseconds maxLatency;
+};
+
 struct IDatabaseConnection : public IExtensible, public IIDProvider
 {
 
@@ -127,6 +200,41 @@ struct IDatabaseConnection : public IExtensible, public IIDProvider
 	/// @param query Query to execute
 	/// @returns Result set
 	virtual IDatabaseResultSet* executeQuery(StringView query) = 0;
+
+	/// Prepares a statement, reusing a cached compilation of the same SQL if there is one
+	/// @param query Query with parameters, containing one SQL statement
+	/// @returns Statement if successful, otherwise "nullptr"
+	virtual IDatabaseStatement* prepareStatement(StringView query) = 0;
+
+	/// Queues a query to execute on the connection's worker thread, with its own handle to the database
+	/// Later queries on this connection wait for it, so they run in the order they were made. With WAL mode, see
+	/// `applyDurabilitySettings`, the main thread's handle can keep reading while the worker thread writes.
+	/// In-memory databases can't be shared with another thread, so their queries execute immediately instead
+	/// @param query Query to execute
+	/// @param handler Handler called with the result set in a later tick, or when the connection is closed
+	/// @returns "true" if the query has been queued, "false" if the queue is full or the connection is closed
+	virtual bool executeQueryAsync(StringView query, DatabaseQueryHandler* handler) = 0;
+
+	/// Queues a query that returns no rows, to execute with the other queued writes in one transaction
+	/// The batch is executed every `database.batch_interval` milliseconds, once `database.batch_max_queries` writes are queued,
+	/// when it's flushed, or with `database.flush_writes_before_reads` before any other query on this connection so they see
+	/// its changes. If the batch can't begin, e.g. because another process has the database locked, the writes stay queued.
+	/// @param query Query to execute
+	/// @returns "true" if the query has been queued, otherwise "false"
+	virtual bool queueWrite(StringView query) = 0;
+
+	/// Executes and commits the queued writes now
+	/// @returns "true" if the batch has been committed or there was nothing queued, otherwise "false"
+	virtual bool flushWrites() = 0;
+
+	/// Gets the statistics of this connection's write batches
+	/// @returns Write batch statistics
+	virtual const DatabaseWriteBatchStats& getWriteBatchStats() const = 0;
+
+	/// Applies the `database.synchronous`, `database.wal` and `database.journal_size_limit` settings to this connection
+	/// WAL mode is stored in the database file, so it stays on for later connections too
+	/// @returns "true" if the settings have been applied, otherwise "false"
+	virtual bool applyDurabilitySettings() = 0;
 };
 
 static const UID DatabasesComponent_UID = UID(0x80092e7eb5821a96 /*0x80092e7eb5821a969640def7747a231a*/);
@@ -176,4 +284,23 @@ struct IDatabasesComponent : public IComponent
 	/// @param databaseResultSetID Database result set ID
 	/// @returns Database result set
 	virtual IDatabaseResultSet& getDatabaseResultSetByID(int databaseResultSetID) = 0;
+
+	/// Frees the specified statement
+	/// @param statement Statement
+	/// @returns "true" if statement has been successfully freed, otherwise "false"
+	virtual bool freeStatement(IDatabaseStatement& statement) = 0;
+
+	/// Gets the number of database statements
+	/// @returns Number of statements
+	virtual std::size_t getDatabaseStatementCount() const = 0;
+
+	/// Is database statement ID valid
+	/// @param databaseStatementID Database statement ID
+	/// @returns "true" if database statement ID is valid, otherwise "false"
+	virtual bool isDatabaseStatementIDValid(int databaseStatementID) const = 0;
+
+	/// Gets a database statement by ID
+	/// @param databaseStatementID Database statement ID
+	/// @returns Database statement
+	virtual IDatabaseStatement& getDatabaseStatementByID(int databaseStatementID) = 0;
 };
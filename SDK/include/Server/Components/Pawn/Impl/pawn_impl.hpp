@@ -25,6 +25,7 @@ void setAmxLookups()
 		lookups_.menus = components_->queryComponent<IMenusComponent>();
 		lookups_.objects = components_->queryComponent<IObjectsComponent>();
 		lookups_.pickups = components_->queryComponent<IPickupsComponent>();
+		lookups_.playback = components_->queryComponent<IPlaybackComponent>();
 		lookups_.recordings = components_->queryComponent<IRecordingsComponent>();
 		lookups_.textdraws = components_->queryComponent<ITextDrawsComponent>();
 		lookups_.textlabels = components_->queryComponent<ITextLabelsComponent>();
@@ -789,6 +789,59 @@ private:
 	IDatabaseResultSet* value_;
 };
 
+// Database IDatabaseStatement param lookups
+template <>
+struct ParamLookup<IDatabaseStatement>
+{
+	static IDatabaseStatement* Val(cell ref) noexcept
+	{
+		IDatabasesComponent* databases_component = getAmxLookups()->databases;
+		IDatabaseStatement* statement = nullptr;
+		if (databases_component && databases_component->isDatabaseStatementIDValid(static_cast<int>(ref)))
+		{
+			statement = &databases_component->getDatabaseStatementByID(static_cast<int>(ref));
+		}
+		return statement;
+	}
+};
+
+template <>
+class ParamCast<IDatabaseStatement&>
+{
+public:
+	ParamCast(AMX* amx, cell* params, int idx)
+	{
+		value_ = ParamLookup<IDatabaseStatement>::Val(params[idx]);
+		if (value_ == nullptr)
+		{
+			error_ = true;
+		}
+	}
+
+	~ParamCast()
+	{
+	}
+
+	ParamCast(ParamCast<IDatabaseStatement&> const&) = delete;
+	ParamCast(ParamCast<IDatabaseStatement&>&&) = delete;
+
+	operator IDatabaseStatement&()
+	{
+		return *value_;
+	}
+
+	bool Error() const
+	{
+		return error_;
+	}
+
+	static constexpr int Size = 1;
+
+private:
+	IDatabaseStatement* value_;
+	bool error_ = false;
+};
+
 // Disable the ref version.
 template <>
 class ParamCast<Vector3 const&>
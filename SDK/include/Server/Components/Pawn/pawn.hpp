@@ -17,6 +17,7 @@
 #include <Server/Components/Menus/menus.hpp>
 #include <Server/Components/Objects/objects.hpp>
 #include <Server/Components/Pickups/pickups.hpp>
+#include <Server/Components/Playback/playback.hpp>
 #include <Server/Components/Recordings/recordings.hpp>
 #include <Server/Components/TextDraws/textdraws.hpp>
 #include <Server/Components/TextLabels/textlabels.hpp>
@@ -57,6 +58,7 @@ struct PawnLookup
 	IMenusComponent* menus = nullptr;
 	IObjectsComponent* objects = nullptr;
 	IPickupsComponent* pickups = nullptr;
+	IPlaybackComponent* playback = nullptr;
 	IRecordingsComponent* recordings = nullptr;
 	ITextDrawsComponent* textdraws = nullptr;
 	ITextLabelsComponent* textlabels = nullptr;
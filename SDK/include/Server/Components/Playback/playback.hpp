@@ -0,0 +1,42 @@
+#pragma once
+
+#include <network.hpp>
+#include <player.hpp>
+
+struct PlaybackEventHandler
+{
+	/// Called when a bot's recording ends and it isn't looping
+	virtual void onPlaybackEnd(IPlayer& bot) { }
+};
+
+static const UID PlaybackComponent_UID = UID(0x5C3F1B0E7A29D648);
+/// Plays `.rec` recordings on bots hosted by the server itself, so they don't need an NPC client process each
+/// The bots are players on the component's own network, which sends nothing since there's no client to receive it
+struct IPlaybackComponent : public INetworkComponent
+{
+	PROVIDE_UID(PlaybackComponent_UID);
+
+	/// Connect a bot hosted by the server, which is an NPC that only moves while playing a recording
+	/// @return The bot, or nullptr if the name is invalid or taken or all the bot slots are used
+	virtual IPlayer* connectBot(StringView name) = 0;
+
+	/// Start playing a recording from scriptfiles on a bot, spawning it if needed and replacing what it was playing
+	/// Driver recordings drive the vehicle the bot is in, or the recorded vehicle ID if it's not in one
+	/// @param file The recording's name without the .rec extension
+	/// @param speed How fast to play the recording, 1 being real time and 0 pausing it
+	/// @param loop Whether to start over once the recording ends
+	/// @return false if the player isn't a bot of this component, the speed is negative or the file isn't a valid recording
+	virtual bool startPlayback(IPlayer& bot, StringView file, float speed = 1.f, bool loop = false) = 0;
+
+	/// Stop playing a recording on a bot, leaving it where it is
+	virtual void stopPlayback(IPlayer& bot) = 0;
+
+	/// Get whether a bot is playing a recording
+	virtual bool isPlaying(const IPlayer& bot) const = 0;
+
+	/// Change how fast a bot's recording is played
+	virtual bool setPlaybackSpeed(IPlayer& bot, float speed) = 0;
+
+	// Access to event dispatchers for other components to add handlers to
+	virtual IEventDispatcher<PlaybackEventHandler>& getEventDispatcher() = 0;
+};
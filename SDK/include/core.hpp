@@ -2,8 +2,10 @@
 
 #include "component.hpp"
 #include "events.hpp"
+#include "logging.hpp"
 #include "network.hpp"
 #include "player.hpp"
+#include "profiler.hpp"
 #include "types.hpp"
 #include "values.hpp"
 
@@ -19,6 +21,14 @@ struct HTTPResponseHandler
 	virtual void onHTTPResponse(int status, StringView body) = 0;
 };
 
+/// A task that can be split into ranges and processed on the core's worker threads
+struct IParallelTask
+{
+	/// Process the items in the range [begin, end)
+	/// Called concurrently from several threads so it must only read shared state and write to per-item storage
+	virtual void process(size_t begin, size_t end) = 0;
+};
+
 /// An event handler for core events
 struct CoreEventHandler
 {
@@ -139,14 +149,6 @@ struct IEarlyConfig : public IConfig
 	virtual void setBool(StringView key, bool value) = 0;
 };
 
-enum LogLevel
-{
-	Debug,
-	Message,
-	Warning,
-	Error
-};
-
 /// A basic logger interface
 struct ILogger
 {
@@ -183,6 +185,13 @@ struct ILogger
 	virtual void vlogLnU8(LogLevel level, const char* fmt, va_list args) = 0;
 };
 
+/// Counters of the core's internal state, for monitoring
+struct CoreStats
+{
+	size_t httpRequestsQueued; ///< HTTP requests waiting for or running on a client thread
+	uint64_t allocations; ///< Heap allocations made since the server started, 0 unless built with BUILD_ALLOCATION_COUNTER
+};
+
 /// The core interface
 struct ICore : public IExtensible, public ILogger
 {
@@ -351,6 +360,21 @@ struct ICore : public IExtensible, public ILogger
 	/// @param url The URL
 	/// @param[opt] data The POST data
 	virtual void requestHTTP4(HTTPResponseHandler* handler, HTTPRequestType type, StringView url, StringView data = StringView()) = 0;
+
+	/// Process a task's items on the worker threads and the calling thread, returning once all of them are done
+	/// Must only be called from the main thread; the main thread's state can be safely read from the task while it runs
+	/// @param task The task to run
+	/// @param count The number of items to process
+	virtual void runParallel(IParallelTask& task, size_t count) = 0;
+
+	/// Get the profiler that measures the time spent in each part of the server's ticks
+	virtual ITickProfiler& getTickProfiler() = 0;
+
+	/// Get the logger for records tagged with a subsystem and fields, filtered by `logging.levels`
+	virtual IStructuredLogger& getStructuredLogger() = 0;
+
+	/// Get the current values of the core's internal counters
+	virtual CoreStats getStats() = 0;
 };
 
 /// Helper class to get streamer config properties
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "types.hpp"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <type_traits>
+
+enum LogLevel
+{
+	Debug,
+	Message,
+	Warning,
+	Error
+};
+
+/// The subsystem of records logged by the core itself and by `ICore`'s `ILogger` methods
+static const UID CoreLogSubsystem = 0;
+
+struct ILogger;
+
+/// A named value attached to a structured log record
+struct LogField
+{
+	enum class Type : uint8_t
+	{
+		Int,
+		Float,
+		Bool,
+		String
+	};
+
+	StringView key;
+	Type type;
+	union
+	{
+		int64_t intValue;
+		double floatValue;
+		bool boolValue;
+	};
+	StringView stringValue;
+
+	template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+	LogField(StringView key, T value)
+		: key(key)
+		, type(Type::Int)
+		, intValue(static_cast<int64_t>(value))
+	{
+	}
+
+	LogField(StringView key, double value)
+		: key(key)
+		, type(Type::Float)
+		, floatValue(value)
+	{
+	}
+
+	LogField(StringView key, bool value)
+		: key(key)
+		, type(Type::Bool)
+		, boolValue(value)
+	{
+	}
+
+	LogField(StringView key, StringView value)
+		: key(key)
+		, type(Type::String)
+		, intValue(0)
+		, stringValue(value)
+	{
+	}
+
+	LogField(StringView key, const char* value)
+		: LogField(key, StringView(value))
+	{
+	}
+};
+
+/// Writes log records tagged with a subsystem and typed fields
+/// Records go to the text log like any other line, and to the structured log when `logging.structured_format` is set
+struct IStructuredLogger
+{
+	/// Get whether a record of a subsystem at a level would be written, to skip building it otherwise
+	/// Can be called from any thread
+	virtual bool isLogEnabled(UID subsystem, LogLevel level) const = 0;
+
+	/// Write a record if its subsystem's level allows it
+	/// Can be called from any thread
+	/// @param subsystem The UID of the component logging the record, or CoreLogSubsystem
+	/// @param message The human readable message, as written to the text log
+	/// @param fields Values to attach to the record in the structured log
+	virtual void logRecord(UID subsystem, LogLevel level, StringView message, Span<const LogField> fields) = 0;
+
+	/// Set the minimum level of the records written for a subsystem
+	/// @return false if the subsystem isn't a loaded component or CoreLogSubsystem
+	virtual bool setLogLevel(UID subsystem, LogLevel level) = 0;
+
+	/// Get the minimum level of the records written for a subsystem
+	virtual LogLevel getLogLevel(UID subsystem) const = 0;
+
+	/// Get a logger whose lines are records of a subsystem, so its `logging.levels` entry applies to them
+	/// Components should log through this rather than `ICore`, which logs as CoreLogSubsystem
+	/// Call from the main thread; the logger can be used from any thread and lives as long as the core
+	/// @param subsystem The UID of the component logging
+	virtual ILogger& getLogger(UID subsystem) = 0;
+
+	/// Format a message and write it as a record, only formatting when the record would be written
+	__ATTRIBUTE__((__format__(__printf__, 5, 6)))
+	void logRecordF(UID subsystem, LogLevel level, Span<const LogField> fields, const char* fmt, ...)
+	{
+		if (!isLogEnabled(subsystem, level))
+		{
+			return;
+		}
+
+		char message[1024];
+		va_list args;
+		va_start(args, fmt);
+		const int len = vsnprintf(message, sizeof(message), fmt, args);
+		va_end(args);
+		if (len >= 0)
+		{
+			logRecord(subsystem, level, StringView(message, std::min<size_t>(len, sizeof(message) - 1)), fields);
+		}
+	}
+};
@@ -46,6 +46,8 @@ enum ENetworkType
 {
 	ENetworkType_RakNetLegacy,
 	ENetworkType_ENet,
+	ENetworkType_Playback,
+	ENetworkType_LoadTest,
 
 	ENetworkType_End
 };
@@ -998,6 +998,35 @@ struct PlayerUpdateEventHandler
 	virtual bool onPlayerUpdate(IPlayer& player, TimePoint now) { return true; }
 };
 
+/// A command registered with IPlayerCommands
+struct PlayerCommandHandler
+{
+	/// Called when a player uses the command
+	/// @param name The command's name as registered
+	/// @param params The text after the name, without leading and trailing spaces
+	/// @param args params split on spaces
+	/// @return false to tell the player the command is unknown
+	virtual bool onPlayerCommand(IPlayer& player, StringView name, StringView params, Span<const StringView> args) = 0;
+};
+
+/// Commands looked up by name and run before the text is passed to onPlayerCommandText
+/// Names are case insensitive, and given without the leading /
+struct IPlayerCommands
+{
+	/// Register a command
+	/// @param cooldown How long a player has to wait between two uses, uses within it are ignored, 0 for no limit
+	/// @return false if the name is empty, has spaces or is already registered
+	virtual bool add(StringView name, PlayerCommandHandler& handler, Milliseconds cooldown = Milliseconds(0)) = 0;
+
+	/// Unregister a command
+	/// A handler can remove its own command, but has to stay alive until its onPlayerCommand returns
+	/// @return false if it isn't registered
+	virtual bool remove(StringView name) = 0;
+
+	/// Get a command's handler, nullptr if it isn't registered
+	virtual PlayerCommandHandler* get(StringView name) const = 0;
+};
+
 /// A player pool interface
 struct IPlayerPool : public IExtensible, public IReadOnlyPool<IPlayer>
 {
@@ -1079,4 +1108,15 @@ struct IPlayerPool : public IExtensible, public IReadOnlyPool<IPlayer>
 
 	/// Get the colour assigned to a player ID when it first connects.
 	virtual Colour getDefaultColour(int pid) const = 0;
+
+	/// Get the commands dispatched by name before onPlayerCommandText.
+	virtual IPlayerCommands& getPlayerCommands() = 0;
+
+	/// sendClientMessage for all players within range of a player, including that player
+	/// Within the stream radius only the players the origin is streamed for are in range
+	virtual void sendClientMessageInRange(IPlayer& origin, const Colour& colour, StringView message, float range) = 0;
+
+	/// sendChatMessage for all players within range of the sender, including the sender
+	/// Within the stream radius only the players the sender is streamed for are in range
+	virtual void sendChatMessageInRange(IPlayer& from, StringView message, float range) = 0;
 };
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "types.hpp"
+
+/* Interfaces, to be passed around */
+
+/// The windows tick profiler statistics are aggregated over
+enum TickProfileWindow
+{
+	TickProfileWindow_Second,
+	TickProfileWindow_TenSeconds,
+	TickProfileWindow_Minute,
+	TickProfileWindow_End
+};
+
+/// Per-tick timing statistics of a profiled section
+struct TickProfileStats
+{
+	Microseconds p50; ///< The median time spent in the section per tick
+	Microseconds p99; ///< The 99th percentile time spent in the section per tick
+	Microseconds max; ///< The longest time spent in the section in one tick
+	unsigned ticks; ///< The number of ticks the section ran in
+};
+
+/// A tick profiler section enumerator
+struct TickProfileEnumeratorCallback
+{
+	/// Called for each section that's been added
+	/// @return true to continue enumerating, false to stop
+	virtual bool proc(int section, StringView name) = 0;
+};
+
+/// Measures how much time named sections take in each server tick
+struct ITickProfiler
+{
+	/// Get whether time is being recorded
+	virtual bool isEnabled() const = 0;
+
+	/// Toggle recording time
+	virtual void setEnabled(bool enabled) = 0;
+
+	/// Add a named section or get the existing section with that name
+	/// @return The section's ID to record to
+	virtual int addSection(StringView name) = 0;
+
+	/// Add time spent in a section to the current tick
+	/// Must only be called from the main thread
+	virtual void record(int section, Nanoseconds time) = 0;
+
+	/// Get a section's per-tick statistics over a window
+	/// @return false if the section doesn't exist
+	virtual bool getStats(int section, TickProfileWindow window, TickProfileStats& stats) const = 0;
+
+	/// Enumerate the sections that have been added
+	virtual void enumSections(TickProfileEnumeratorCallback& callback) const = 0;
+
+	/// Clear all the recorded statistics
+	virtual void reset() = 0;
+};
+
+/// Records the time spent in its scope to a tick profiler section
+class ScopedTickProfile final
+{
+public:
+	ScopedTickProfile(ITickProfiler* profiler, int section)
+		: profiler_(profiler != nullptr && profiler->isEnabled() ? profiler : nullptr)
+		, section_(section)
+	{
+		if (profiler_)
+		{
+			start_ = Time::now();
+		}
+	}
+
+	~ScopedTickProfile()
+	{
+		if (profiler_)
+		{
+			profiler_->record(section_, Time::now() - start_);
+		}
+	}
+
+	ScopedTickProfile(const ScopedTickProfile&) = delete;
+	ScopedTickProfile& operator=(const ScopedTickProfile&) = delete;
+
+private:
+	ITickProfiler* profiler_;
+	int section_;
+	TimePoint start_;
+};
@@ -49,6 +49,7 @@ constexpr int INVALID_PICKUP_ID = -1;
 constexpr int INVALID_OBJECT_MODEL_ID = -1;
 constexpr int INVALID_MENU_ITEM_ID = -1;
 constexpr int GANG_ZONE_POOL_SIZE = 1024;
+constexpr int DATABASE_CONNECTION_POOL_SIZE = 1024;
 constexpr int MAX_STREAMED_PLAYERS = 200;
 constexpr int MAX_STREAMED_ACTORS = 50;
 constexpr int MAX_STREAMED_VEHICLES = 700;
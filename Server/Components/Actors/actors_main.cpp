@@ -96,6 +96,8 @@ public:
 		players->getPlayerConnectDispatcher().addEventHandler(this);
 		players->getPlayerUpdateDispatcher().addEventHandler(this);
 		players->getPoolEventDispatcher().addEventHandler(this);
+		eventDispatcher.setProfiler(&core->getTickProfiler(), "ActorEventHandler");
+		storage.getEventDispatcher().setProfiler(&core->getTickProfiler(), "ActorPoolEventHandler");
 		NetCode::RPC::OnPlayerDamageActor::addEventHandler(*core, &playerDamageActorEventHandler);
 		streamConfigHelper = StreamConfigHelper(core->getConfig());
 	}
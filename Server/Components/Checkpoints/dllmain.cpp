@@ -127,6 +127,7 @@ public:
 		core = c;
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
 		core->getPlayers().getPlayerUpdateDispatcher().addEventHandler(&playerCheckpointActionHandler);
+		eventDispatcher.setProfiler(&core->getTickProfiler(), "PlayerCheckpointEventHandler");
 	}
 
 	StringView componentName() const override
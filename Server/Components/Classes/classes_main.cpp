@@ -271,6 +271,8 @@ public:
 		core = c;
 		NetCode::RPC::PlayerRequestClass::addEventHandler(*core, &onPlayerRequestClassHandler);
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		eventDispatcher.setProfiler(&core->getTickProfiler(), "ClassEventHandler");
+		storage.getEventDispatcher().setProfiler(&core->getTickProfiler(), "ClassPoolEventHandler");
 	}
 
 	void onInit(IComponentList* components) override
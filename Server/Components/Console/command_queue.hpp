@@ -0,0 +1,83 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <Server/Components/Console/console.hpp>
+#include <atomic>
+#include <sdk.hpp>
+
+/// A command waiting to be run in the main thread
+struct QueuedCommand
+{
+	String text;
+	ConsoleCommandSenderData sender;
+	/// The sending player's ID, to check they're still connected when it runs
+	int playerID = -1;
+	/// Owned by the queue when the sender is a custom one from another thread
+	QueuedConsoleMessageHandler* queuedHandler = nullptr;
+};
+
+/// Unbounded multiple producer, single consumer queue of console commands
+/// Pushing is one atomic exchange so the stdin, query and network threads never wait on each other or on the main thread;
+/// only the main thread pops. Based on Dmitry Vyukov's intrusive MPSC node queue.
+class ConsoleCommandQueue final : public NoCopy
+{
+public:
+	ConsoleCommandQueue()
+		: head_(new Node())
+		, tail_(head_.load(std::memory_order_relaxed))
+	{
+	}
+
+	~ConsoleCommandQueue()
+	{
+		QueuedCommand command;
+		while (pop(command))
+		{
+		}
+		delete tail_;
+	}
+
+	/// Add a command, can be called from any thread
+	void push(QueuedCommand&& command)
+	{
+		Node* node = new Node();
+		node->command = std::move(command);
+		Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+		prev->next.store(node, std::memory_order_release);
+	}
+
+	/// Take the oldest command, only called from the consuming thread
+	/// @return false if the queue is empty, or the next push hasn't been linked in yet
+	bool pop(QueuedCommand& command)
+	{
+		Node* next = tail_->next.load(std::memory_order_acquire);
+		if (next == nullptr)
+		{
+			return false;
+		}
+		// The popped node becomes the new empty head of the list.
+		command = std::move(next->command);
+		delete tail_;
+		tail_ = next;
+		return true;
+	}
+
+private:
+	struct Node
+	{
+		std::atomic<Node*> next { nullptr };
+		QueuedCommand command;
+	};
+
+	/// The most recently pushed node, swapped by the producers
+	std::atomic<Node*> head_;
+	/// The node before the oldest command, only touched by the consumer
+	Node* tail_;
+};
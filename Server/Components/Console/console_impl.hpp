@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "command_queue.hpp"
 #include <Impl/events_impl.hpp>
 #include <Server/Components/Console/console.hpp>
 #include <utils.hpp>
@@ -15,7 +16,7 @@
 #include <codecvt>
 #include <iostream>
 #include <locale>
-#include <mutex>
+#include <memory>
 #include <netcode.hpp>
 #include <network.hpp>
 #include <sdk.hpp>
@@ -52,19 +53,20 @@ public:
 class ConsoleComponent final : public IConsoleComponent, public CoreEventHandler, public ConsoleEventHandler, public PlayerConnectEventHandler
 {
 private:
-	struct ThreadProcData
+	/// Shared with the stdin thread, which can outlive the component while it waits for a line
+	struct CommandInput
 	{
-		std::atomic_bool valid;
-		ConsoleComponent* component;
+		std::atomic_bool valid { true };
+		ConsoleCommandQueue queue;
 	};
 
 	ICore* core = nullptr;
+	ILogger* logger = nullptr;
 	DefaultEventDispatcher<ConsoleEventHandler> eventDispatcher;
-	std::mutex cmdMutex;
-	std::atomic_bool newCmd = false;
-	String cmd;
-	ThreadProcData* threadData;
+	std::shared_ptr<CommandInput> input;
 	std::thread cinThread;
+	/// Time each tick can spend running queued commands, at least one runs per tick
+	Microseconds tickBudget = Milliseconds(2);
 
 	struct PlayerRconCommandHandler : public SingleNetworkInEventHandler
 	{
@@ -98,9 +100,13 @@ private:
 					return true;
 				}
 
-				self.core->logLn(LogLevel::Warning, "RCON (In-Game): Player [%.*s] sent command: %.*s", PRINT_VIEW(peer.getName()), PRINT_VIEW(command));
+				self.logger->logLn(LogLevel::Warning, "RCON (In-Game): Player [%.*s] sent command: %.*s", PRINT_VIEW(peer.getName()), PRINT_VIEW(command));
 
-				self.send(command, ConsoleCommandSenderData(peer));
+				QueuedCommand queued;
+				queued.text = String(command);
+				queued.sender = ConsoleCommandSenderData(peer);
+				queued.playerID = peer.getID();
+				self.input->queue.push(std::move(queued));
 			}
 			else
 			{
@@ -125,13 +131,13 @@ private:
 							if (password == rconPassword)
 							{
 								pdata->setConsoleAccessibility(true);
-								self.core->logLn(LogLevel::Warning, "RCON (In-Game): Player #%d (%.*s) has logged in.", peer.getID(), PRINT_VIEW(peer.getName()));
+								self.logger->logLn(LogLevel::Warning, "RCON (In-Game): Player #%d (%.*s) has logged in.", peer.getID(), PRINT_VIEW(peer.getName()));
 								peer.sendClientMessage(Colour::White(), "SERVER: You are logged in as admin.");
 								success = true;
 							}
 							else
 							{
-								self.core->logLn(LogLevel::Warning, "RCON (In-Game): Player #%d (%.*s) failed login.", peer.getID(), PRINT_VIEW(peer.getName()));
+								self.logger->logLn(LogLevel::Warning, "RCON (In-Game): Player #%d (%.*s) failed login.", peer.getID(), PRINT_VIEW(peer.getName()));
 								peer.sendClientMessage(Colour::White(), "SERVER: Bad admin password. Repeated attempts will get you banned.");
 								success = false;
 							}
@@ -191,7 +197,7 @@ public:
 	}
 
 	ConsoleComponent()
-		: threadData(nullptr)
+		: input(std::make_shared<CommandInput>())
 		, playerRconCommandHandler(*this)
 	{
 	}
@@ -204,19 +210,22 @@ public:
 	void onLoad(ICore* core) override
 	{
 		this->core = core;
+		logger = &core->getStructuredLogger().getLogger(getUID());
 		core->getEventDispatcher().addEventHandler(this);
 		this->getEventDispatcher().addEventHandler(this);
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		eventDispatcher.setProfiler(&core->getTickProfiler(), "ConsoleEventHandler");
 
 		NetCode::Packet::PlayerRconCommand::addEventHandler(*core, &playerRconCommandHandler);
 
-		threadData = new ThreadProcData { true, this };
-		cinThread = std::thread(ThreadProc, threadData);
+		cinThread = std::thread(ThreadProc, input);
 		cinThread.detach();
 	}
 
 	void onReady() override
 	{
+		tickBudget = Milliseconds(*core->getConfig().getInt("rcon.tick_budget"));
+
 		// Server without a config file has rcon.password empty so we disable rcon manually too.
 		if (core->getConfig().getString("rcon.password") == "")
 		{
@@ -226,43 +235,33 @@ public:
 		// Server exit if rcon.password is set to changeme
 		if (core->getConfig().getString("rcon.password") == "changeme")
 		{
-			core->logLn(LogLevel::Error, "Your rcon password must be changed from the default password, please change it.");
+			logger->logLn(LogLevel::Error, "Your rcon password must be changed from the default password, please change it.");
 			send("exit");
 		}
 	}
 
-	static void ThreadProc(ThreadProcData* threadData)
+	static void ThreadProc(std::shared_ptr<CommandInput> input)
 	{
 		std::wstring line;
-		while (true)
+		while (std::getline(std::wcin, line) && input->valid)
 		{
-			if (
-				std::getline(std::wcin, line)
-				&& threadData->valid)
-			{
-				std::scoped_lock<std::mutex> lock(threadData->component->cmdMutex);
-
-				threadData->component->cmd = std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>, wchar_t>().to_bytes(line);
-				threadData->component->newCmd = true;
-			}
-			else
-			{
-				return;
-			}
+			QueuedCommand command;
+			command.text = std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>, wchar_t>().to_bytes(line);
+			input->queue.push(std::move(command));
 		}
 	}
 
 	~ConsoleComponent()
 	{
-		if (threadData)
+		// The stdin thread is detached and blocked reading, it frees the input once it reads another line or stdin closes.
+		input->valid = false;
+		QueuedCommand command;
+		while (input->queue.pop(command))
 		{
-			threadData->valid = false;
-			if (cinThread.joinable())
+			if (command.queuedHandler)
 			{
-				cinThread.join();
+				command.queuedHandler->free();
 			}
-			delete threadData;
-			threadData = nullptr;
 		}
 		if (core)
 		{
@@ -324,16 +323,48 @@ public:
 		}
 	}
 
+	void queue(StringView command, QueuedConsoleMessageHandler* handler = nullptr) override
+	{
+		QueuedCommand queued;
+		queued.text = String(command);
+		if (handler)
+		{
+			queued.sender = ConsoleCommandSenderData(*handler);
+			queued.queuedHandler = handler;
+		}
+		input->queue.push(std::move(queued));
+	}
+
 	void onTick(Microseconds elapsed, TimePoint now) override
 	{
-		bool expected = true;
-		if (newCmd.compare_exchange_weak(expected, false))
+		const TimePoint start = Time::now();
+		QueuedCommand command;
+		while (input->queue.pop(command))
 		{
-			cmdMutex.lock();
-			String command = cmd;
-			cmdMutex.unlock();
+			if (command.sender.sender == ConsoleCommandSender::Player)
+			{
+				// The player could have left, or someone else taken their slot, since sending it.
+				IPlayer* player = core->getPlayers().get(command.playerID);
+				PlayerConsoleData* pdata = player == command.sender.player ? queryExtension<PlayerConsoleData>(player) : nullptr;
+				if (pdata && pdata->hasConsoleAccess())
+				{
+					send(command.text, command.sender);
+				}
+			}
+			else
+			{
+				send(command.text, command.sender);
+			}
+
+			if (command.queuedHandler)
+			{
+				command.queuedHandler->free();
+			}
 
-			send(command);
+			if (Time::now() - start >= tickBudget)
+			{
+				break;
+			}
 		}
 	}
 
@@ -0,0 +1,182 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include "crc32.hpp"
+#include <atomic>
+#include <fstream>
+#include <ghc/filesystem.hpp>
+#include <sdk.hpp>
+#include <thread>
+
+using namespace Impl;
+
+/// The CRCs of the model files, kept in the models folder between runs so only new or changed files are read
+/// An entry is reused when the file's size and modification time are the ones it was computed for
+class ModelChecksumCache final : public NoCopy
+{
+public:
+	/// The cache's file name in the models folder
+	static constexpr const char* FileName = "checksums.cache";
+
+	void load(StringView modelsPath)
+	{
+		modelsPath_ = String(modelsPath);
+		entries_.clear();
+		dirty_ = false;
+
+		// One `checksum size mtime name` line per file, the name last as it can have spaces.
+		std::ifstream file(modelsPath_ + "/" + FileName);
+		uint32_t checksum;
+		uint64_t size;
+		int64_t mtime;
+		String name;
+		while (file >> std::hex >> checksum >> std::dec >> size >> mtime && std::getline(file >> std::ws, name))
+		{
+			entries_[name] = { checksum, size, mtime };
+		}
+	}
+
+	void save()
+	{
+		if (!dirty_)
+		{
+			return;
+		}
+
+		std::ofstream file(modelsPath_ + "/" + FileName, std::ios::trunc);
+		if (!file.is_open())
+		{
+			return;
+		}
+		for (const auto& it : entries_)
+		{
+			file << std::hex << it.second.checksum << std::dec << ' ' << it.second.size << ' ' << it.second.mtime << ' ' << it.first << '\n';
+		}
+		dirty_ = false;
+	}
+
+	/// Get a file's checksum, reading the file if the cached one is out of date
+	/// @return The file's size, 0 if it doesn't exist
+	size_t get(StringView fileName, uint32_t& checksum)
+	{
+		checksum = 0;
+		FileInfo info;
+		if (!stat(fileName, info))
+		{
+			return 0;
+		}
+
+		String name(fileName);
+		auto it = entries_.find(name);
+		if (it != entries_.end() && it->second.size == info.size && it->second.mtime == info.mtime)
+		{
+			checksum = it->second.checksum;
+			return info.size;
+		}
+
+		const size_t size = GetFileCRC32Checksum(modelsPath_ + "/" + name, checksum);
+		entries_[name] = { checksum, size, info.mtime };
+		dirty_ = true;
+		return size;
+	}
+
+	/// Read the files that aren't in the cache on several threads, so adding thousands of models on the first run isn't
+	/// limited to one core
+	void precompute(Span<const String> fileNames)
+	{
+		struct Pending
+		{
+			const String* name;
+			FileInfo info;
+			uint32_t checksum;
+			size_t size;
+		};
+
+		DynamicArray<Pending> pending;
+		FlatHashSet<String> seen;
+		for (const String& name : fileNames)
+		{
+			FileInfo info;
+			if (!seen.insert(name).second || !stat(name, info))
+			{
+				continue;
+			}
+			auto it = entries_.find(name);
+			if (it == entries_.end() || it->second.size != info.size || it->second.mtime != info.mtime)
+			{
+				pending.push_back({ &name, info, 0, 0 });
+			}
+		}
+
+		if (pending.empty())
+		{
+			return;
+		}
+
+		std::atomic<size_t> next(0);
+		auto work = [this, &pending, &next]()
+		{
+			for (size_t i = next++; i < pending.size(); i = next++)
+			{
+				pending[i].size = GetFileCRC32Checksum(modelsPath_ + "/" + *pending[i].name, pending[i].checksum);
+			}
+		};
+
+		const size_t threadCount = std::min<size_t>(pending.size(), std::max(1u, std::thread::hardware_concurrency())) - 1;
+		DynamicArray<std::thread> threads;
+		threads.reserve(threadCount);
+		for (size_t i = 0; i != threadCount; ++i)
+		{
+			threads.emplace_back(work);
+		}
+		work();
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (const Pending& file : pending)
+		{
+			entries_[*file.name] = { file.checksum, file.size, file.info.mtime };
+		}
+		dirty_ = true;
+	}
+
+private:
+	struct FileInfo
+	{
+		uint64_t size;
+		int64_t mtime;
+	};
+
+	struct Entry
+	{
+		uint32_t checksum;
+		uint64_t size;
+		int64_t mtime;
+	};
+
+	bool stat(StringView fileName, FileInfo& info) const
+	{
+		std::error_code ec;
+		const ghc::filesystem::path path = ghc::filesystem::path(modelsPath_) / ghc::filesystem::path(String(fileName));
+		info.size = ghc::filesystem::file_size(path, ec);
+		if (ec)
+		{
+			return false;
+		}
+		info.mtime = ghc::filesystem::last_write_time(path, ec).time_since_epoch().count();
+		return !ec;
+	}
+
+	String modelsPath_;
+	FlatHashMap<String, Entry> entries_;
+	bool dirty_ = false;
+};
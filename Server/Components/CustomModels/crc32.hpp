@@ -1,3 +1,5 @@
+#pragma once
+
 static uint32_t crc32Table[] = {
 	0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA,
 	0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
@@ -87,12 +89,13 @@ static size_t GetFileCRC32Checksum(StringView filename, uint32_t& checksum)
 		return 0;
 	}
 
-	uint8_t buf[1024];
+	// Model files are megabytes, read them in larger blocks than the default stdio buffer.
+	uint8_t buf[16384];
 	size_t file_size = 0;
 
 	while (!feof(f))
 	{
-		auto read = fread(buf, 1, 1024, f);
+		auto read = fread(buf, 1, sizeof(buf), f);
 		checksum = CRC32(checksum, buf, read);
 		file_size += read;
 	}
@@ -0,0 +1,127 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <ghc/filesystem.hpp>
+#include <sdk.hpp>
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+struct IUnknown;
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// A model file mapped read only, so downloads are written to sockets straight from the page cache
+/// Truncating a mapped file makes reading the lost pages fault, so check `isStale` and map it again when it changed
+class MappedFile final : public NoCopy
+{
+public:
+	~MappedFile()
+	{
+		if (data_ == nullptr)
+		{
+			return;
+		}
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+		UnmapViewOfFile(data_);
+#else
+		munmap(const_cast<char*>(data_), size_);
+#endif
+	}
+
+	/// @return false if the file doesn't exist, is empty or can't be mapped
+	bool open(const ghc::filesystem::path& path)
+	{
+		std::error_code ec;
+		modified_ = ghc::filesystem::last_write_time(path, ec);
+		if (ec)
+		{
+			return false;
+		}
+		path_ = path;
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+		HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		LARGE_INTEGER size;
+		if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+		{
+			HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr)
+			{
+				data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				size_ = size_t(size.QuadPart);
+				// The view keeps the mapping alive.
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+#else
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+		struct stat info;
+		if (fstat(fd, &info) == 0 && info.st_size > 0)
+		{
+			void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			if (data != MAP_FAILED)
+			{
+				data_ = static_cast<const char*>(data);
+				size_ = info.st_size;
+			}
+		}
+		// The mapping stays valid after the descriptor is closed.
+		::close(fd);
+#endif
+		return data_ != nullptr;
+	}
+
+	/// @return true if the file's size or modification time differ from when it was mapped, or it can't be read
+	bool isStale() const
+	{
+		std::error_code ec;
+		const uintmax_t size = ghc::filesystem::file_size(path_, ec);
+		if (ec || size != size_)
+		{
+			return true;
+		}
+		const ghc::filesystem::file_time_type modified = ghc::filesystem::last_write_time(path_, ec);
+		return ec || modified != modified_;
+	}
+
+	const ghc::filesystem::path& path() const
+	{
+		return path_;
+	}
+
+	const char* data() const
+	{
+		return data_;
+	}
+
+	size_t size() const
+	{
+		return size_;
+	}
+
+private:
+	ghc::filesystem::path path_;
+	ghc::filesystem::file_time_type modified_;
+	const char* data_ = nullptr;
+	size_t size_ = 0;
+};
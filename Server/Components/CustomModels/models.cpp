@@ -12,7 +12,8 @@
 #include <netcode.hpp>
 #include <httplib.h>
 #include <ghc/filesystem.hpp>
-#include "crc32.hpp"
+#include "checksum_cache.hpp"
+#include "mapped_file.hpp"
 #include <regex>
 #include <shared_mutex>
 #include "utils.hpp"
@@ -30,9 +31,9 @@ struct ModelFile
 	uint32_t checksum;
 	size_t size;
 
-	ModelFile(StringView modelsPath, StringView fileName)
+	ModelFile(ModelChecksumCache& checksums, StringView fileName)
 		: name(fileName)
-		, size(GetFileCRC32Checksum(String(modelsPath) + "/" + String(fileName), checksum))
+		, size(checksums.get(fileName, checksum))
 	{
 	}
 };
@@ -82,6 +83,14 @@ public:
 	const int32_t getId() { return newId_; }
 };
 
+/// A model file the web server can send, with the ETag clients can revalidate it with
+/// Downloads hold on to the mapping they started with, so it can be replaced while they run
+struct ServedFile
+{
+	std::shared_ptr<const MappedFile> mapping;
+	String etag;
+};
+
 class WebServer
 {
 private:
@@ -92,13 +101,84 @@ private:
 	uint16_t port_ = 0;
 
 	String url = "";
+	String modelsPath_;
 
 	FlatHashMap<uint32_t, uint16_t> allowedIPs_;
 	std::shared_mutex mutex_;
 
+	FlatPtrHashMap<String, ServedFile> files_;
+	std::shared_mutex filesMutex_;
+
+	/// Format the ETag of a file from its CRC and size
+	static String makeETag(uint32_t checksum, size_t size)
+	{
+		char etag[32];
+		snprintf(etag, sizeof(etag), "\"%08x-%zx\"", checksum, size);
+		return etag;
+	}
+
+	void serveFile(const httplib::Request& req, httplib::Response& res)
+	{
+		ServedFile* file = nullptr;
+		std::shared_ptr<const MappedFile> mapping;
+		String etag;
+		{
+			std::shared_lock<std::shared_mutex> lock(filesMutex_);
+			auto itr = files_.find(req.path.substr(1));
+			if (itr != files_.end())
+			{
+				file = itr->second;
+				mapping = file->mapping;
+				etag = file->etag;
+			}
+		}
+
+		if (file == nullptr)
+		{
+			res.status = 404;
+			return;
+		}
+
+		// Map the file again if it was changed on disk, reading past the end of a truncated mapping would crash.
+		if (mapping->isStale())
+		{
+			std::shared_ptr<MappedFile> remapped = std::make_shared<MappedFile>();
+			if (!remapped->open(mapping->path()))
+			{
+				res.status = 404;
+				return;
+			}
+			// The contents changed, so clients must not be told their cached copy is still valid.
+			const uint32_t checksum = CRC32(0, reinterpret_cast<uint8_t*>(const_cast<char*>(remapped->data())), int(remapped->size()));
+			std::unique_lock<std::shared_mutex> lock(filesMutex_);
+			if (file->mapping == mapping)
+			{
+				file->mapping = std::move(remapped);
+				file->etag = makeETag(checksum, file->mapping->size());
+			}
+			mapping = file->mapping;
+			etag = file->etag;
+		}
+
+		res.set_header("ETag", etag);
+		if (req.has_header("If-None-Match") && req.get_header_value("If-None-Match") == etag)
+		{
+			res.status = 304;
+			return;
+		}
+
+		// The provider keeps its mapping alive and writes from it without copying it first. Range requests are split
+		// into offsets by httplib.
+		res.set_content_provider(mapping->size(), "application/octet-stream", [mapping](size_t offset, size_t length, httplib::DataSink& sink)
+			{
+				return sink.write(mapping->data() + offset, length);
+			});
+	}
+
 public:
-	WebServer(ICore* core, StringView modelsPath, StringView bind, uint16_t port, StringView publicAddr, uint16_t threadsCount)
+	WebServer(ILogger* logger, StringView modelsPath, StringView bind, uint16_t port, StringView publicAddr, uint16_t threadsCount)
 		: port_(port)
+		, modelsPath_(modelsPath)
 	{
 
 		if (!bind.empty())
@@ -108,11 +188,11 @@ public:
 
 			if (!publicAddr.empty())
 			{
-				core->logLn(LogLevel::Message, "Using public address %.*s:%d (local: %.*s:%d)", PRINT_VIEW(publicAddr), port, PRINT_VIEW(address_), port);
+				logger->logLn(LogLevel::Message, "Using public address %.*s:%d (local: %.*s:%d)", PRINT_VIEW(publicAddr), port, PRINT_VIEW(address_), port);
 			}
 			else
 			{
-				core->logLn(LogLevel::Warning, "No public address provided. If your public address differs from bind one please provide it in server config.");
+				logger->logLn(LogLevel::Warning, "No public address provided. If your public address differs from bind one please provide it in server config.");
 			}
 		}
 		else
@@ -120,7 +200,7 @@ public:
 			address_ = "127.0.0.1";
 			url = "http://127.0.0.1:" + std::to_string(port) + '/';
 
-			core->logLn(LogLevel::Warning, "No bind address provided. Attempting to start webserver on 127.0.0.1:%d", port);
+			logger->logLn(LogLevel::Warning, "No bind address provided. Attempting to start webserver on 127.0.0.1:%d", port);
 		}
 
 		svr.new_task_queue = [&]
@@ -154,23 +234,47 @@ public:
 				return httplib::Server::HandlerResponse::Unhandled;
 			});
 
-		if (svr.set_mount_point("/", modelsPath.data()))
-		{
-			thread = std::thread(&WebServer::run, this);
-			thread.detach();
+		svr.Get("/.+", [this](const httplib::Request& req, httplib::Response& res)
+			{
+				serveFile(req, res);
+			});
 
-			// Wait some time.
-			std::this_thread::sleep_for(Milliseconds(500));
-		}
-		else
-		{
-			core->logLn(LogLevel::Error, "Failed to start webserver: Unable to mount models path (%.*s).", PRINT_VIEW(modelsPath));
-		}
+		thread = std::thread(&WebServer::run, this);
+		thread.detach();
+
+		// Wait some time.
+		std::this_thread::sleep_for(Milliseconds(500));
 	}
 
 	~WebServer()
 	{
 		stop();
+		for (auto& file : files_)
+		{
+			delete file.second;
+		}
+	}
+
+	/// Make a model file downloadable, mapping it once for all downloads until it changes on disk
+	void addFile(const ModelFile& file)
+	{
+		std::unique_lock lock(filesMutex_);
+		if (files_.find(file.name) != files_.end())
+		{
+			return;
+		}
+
+		std::shared_ptr<MappedFile> mapping = std::make_shared<MappedFile>();
+		if (!mapping->open(ghc::filesystem::path(modelsPath_) / ghc::filesystem::path(file.name)))
+		{
+			return;
+		}
+
+		ServedFile* served = new ServedFile();
+		served->mapping = std::move(mapping);
+
+		served->etag = makeETag(file.checksum, file.size);
+		files_.emplace(file.name, served);
 	}
 
 	void run()
@@ -287,10 +391,12 @@ class CustomModelsComponent final : public ICustomModelsComponent, public Player
 {
 private:
 	ICore* core = nullptr;
+	ILogger* logger = nullptr;
 	IPlayerPool* players = nullptr;
 
 	WebServer* webServer = nullptr;
 
+	ModelChecksumCache checksumCache;
 	std::vector<ModelInfo*> storage;
 	FlatHashMap<uint32_t, uint16_t> baseModels;
 	FlatHashMap<uint32_t, std::pair<ModelDownloadType, ModelInfo*>> checksums;
@@ -406,6 +512,8 @@ public:
 		{
 			delete webServer;
 		}
+
+		checksumCache.save();
 	}
 
 	void provideConfiguration(ILogger& logger, IEarlyConfig& config, bool defaults) override
@@ -457,8 +565,10 @@ public:
 	void onLoad(ICore* core) override
 	{
 		this->core = core;
+		logger = &core->getStructuredLogger().getLogger(getUID());
 		players = &core->getPlayers();
 		players->getPlayerConnectDispatcher().addEventHandler(this);
+		eventDispatcher.setProfiler(&core->getTickProfiler(), "PlayerModelsEventHandler");
 
 		enabled = *core->getConfig().getBool("artwork.enable");
 		modelsPath = String(trim(core->getConfig().getString("artwork.models_path")));
@@ -481,18 +591,19 @@ public:
 		catch (ghc::filesystem::filesystem_error exception)
 		{
 			enabled = false;
-			core->logLn(LogLevel::Error, "[artwork:error] Unable to create models path (%.*s).", PRINT_VIEW(modelsPath));
-			core->logLn(LogLevel::Error, "%s", exception.what());
+			logger->logLn(LogLevel::Error, "[artwork:error] Unable to create models path (%.*s).", PRINT_VIEW(modelsPath));
+			logger->logLn(LogLevel::Error, "%s", exception.what());
 			return;
 		}
 
+		checksumCache.load(modelsPath);
 		loadArtConfig();
 
 		if (!cdn.empty())
 		{
 			if (!std::regex_match(cdn, rUri))
 			{
-				core->logLn(LogLevel::Warning, "[artwork:warn] CDN URL '%.*s' seems to be invalid, the CDN feature has been disabled.", PRINT_VIEW(cdn));
+				logger->logLn(LogLevel::Warning, "[artwork:warn] CDN URL '%.*s' seems to be invalid, the CDN feature has been disabled.", PRINT_VIEW(cdn));
 				return;
 			}
 
@@ -500,7 +611,7 @@ public:
 			{
 				cdn.push_back('/');
 			}
-			core->logLn(LogLevel::Message, "[artwork:info] Using CDN '%.*s'", PRINT_VIEW(cdn));
+			logger->logLn(LogLevel::Message, "[artwork:info] Using CDN '%.*s'", PRINT_VIEW(cdn));
 			usingCdn = true;
 		}
 	}
@@ -511,24 +622,54 @@ public:
 
 		if (artconfig.is_open())
 		{
-			core->logLn(LogLevel::Message, "[artwork:info] Loading artconfig.txt");
+			logger->logLn(LogLevel::Message, "[artwork:info] Loading artconfig.txt");
+
+			struct ArtConfigModel
+			{
+				ModelType type;
+				int32_t id;
+				int32_t baseId;
+				String dff;
+				String txd;
+				int32_t virtualWorld = -1;
+				uint8_t timeOn = 0;
+				uint8_t timeOff = 0;
+			};
+
+			DynamicArray<ArtConfigModel> models;
 			std::string line;
 			std::smatch match;
 			while (std::getline(artconfig, line))
 			{
 				if (std::regex_match(line, match, rAddCharModel))
 				{
-					addCustomModel(ModelType::Skin, std::atoi(match[2].str().c_str()), std::atoi(match[1].str().c_str()), match[3].str(), match[4].str());
+					models.push_back({ ModelType::Skin, std::atoi(match[2].str().c_str()), std::atoi(match[1].str().c_str()), match[3].str(), match[4].str() });
 				}
 				else if (std::regex_match(line, match, rAddSimpleModel))
 				{
-					addCustomModel(ModelType::Object, std::atoi(match[3].str().c_str()), std::atoi(match[2].str().c_str()), match[4].str(), match[5].str(), std::atoi(match[1].str().c_str()));
+					models.push_back({ ModelType::Object, std::atoi(match[3].str().c_str()), std::atoi(match[2].str().c_str()), match[4].str(), match[5].str(), std::atoi(match[1].str().c_str()) });
 				}
 				else if (std::regex_match(line, match, rAddSimpleModelTimed))
 				{
-					addCustomModel(ModelType::Object, std::atoi(match[3].str().c_str()), std::atoi(match[2].str().c_str()), match[4].str(), match[5].str(), std::atoi(match[1].str().c_str()), std::atoi(match[6].str().c_str()), std::atoi(match[7].str().c_str()));
+					models.push_back({ ModelType::Object, std::atoi(match[3].str().c_str()), std::atoi(match[2].str().c_str()), match[4].str(), match[5].str(), std::atoi(match[1].str().c_str()), uint8_t(std::atoi(match[6].str().c_str())), uint8_t(std::atoi(match[7].str().c_str())) });
 				}
 			}
+
+			// Checksum every file that isn't cached at once, then add the models in order.
+			DynamicArray<String> files;
+			files.reserve(models.size() * 2);
+			for (const ArtConfigModel& model : models)
+			{
+				files.push_back(model.dff);
+				files.push_back(model.txd);
+			}
+			checksumCache.precompute(Span<const String>(files.data(), files.size()));
+
+			for (const ArtConfigModel& model : models)
+			{
+				addCustomModel(model.type, model.id, model.baseId, model.dff, model.txd, model.virtualWorld, model.timeOn, model.timeOff);
+			}
+			checksumCache.save();
 		}
 	}
 
@@ -553,21 +694,21 @@ public:
 			}
 		}
 
-		webServer = new WebServer(core, modelsPath, bindAddress, *core->getConfig().getInt("artwork.port"), core->getConfig().getString("network.public_addr"), httpThreads);
+		webServer = new WebServer(logger, modelsPath, bindAddress, *core->getConfig().getInt("artwork.port"), core->getConfig().getString("network.public_addr"), httpThreads);
 
 		if (webServer->is_running())
 		{
-			core->logLn(LogLevel::Message, "Web server is running on %.*s", PRINT_VIEW(webServer->getUrl()));
+			logger->logLn(LogLevel::Message, "Web server is running on %.*s", PRINT_VIEW(webServer->getUrl()));
 
 			const auto maxPlayers = *core->getConfig().getInt("max_players");
 			if (httpThreads < maxPlayers / 2)
 			{
-				core->logLn(LogLevel::Warning, "HTTP threads count value (%d) is much lower than MAX_PLAYERS (%d). Players may encounter slow download times.", httpThreads, maxPlayers);
+				logger->logLn(LogLevel::Warning, "HTTP threads count value (%d) is much lower than MAX_PLAYERS (%d). Players may encounter slow download times.", httpThreads, maxPlayers);
 			}
 		}
 		else
 		{
-			core->logLn(LogLevel::Error, "Failed to start web server");
+			logger->logLn(LogLevel::Error, "Failed to start web server");
 		}
 	}
 
@@ -604,22 +745,22 @@ public:
 		else if (baseModels.find(id) != baseModels.end())
 		{
 			// Sadly this error will be displayed on gmx. Dunno what do about it.
-			core->logLn(LogLevel::Error, "[artwork:error] Model %d is already in use", id);
+			logger->logLn(LogLevel::Error, "[artwork:error] Model %d is already in use", id);
 			return false;
 		}
 
-		ModelFile dff(modelsPath, dffName);
-		ModelFile txd(modelsPath, txdName);
+		ModelFile dff(checksumCache, dffName);
+		ModelFile txd(checksumCache, txdName);
 
 		if (!dff.size)
 		{
-			core->logLn(LogLevel::Error, "[artwork:error] Cannot add custom model. %.*s doesn't exist", PRINT_VIEW(dffName));
+			logger->logLn(LogLevel::Error, "[artwork:error] Cannot add custom model. %.*s doesn't exist", PRINT_VIEW(dffName));
 			return false;
 		}
 
 		if (!txd.size)
 		{
-			core->logLn(LogLevel::Error, "[artwork:error] Cannot add custom model. %.*s doesn't exist", PRINT_VIEW(txdName));
+			logger->logLn(LogLevel::Error, "[artwork:error] Cannot add custom model. %.*s doesn't exist", PRINT_VIEW(txdName));
 			return false;
 		}
 
@@ -649,6 +790,11 @@ public:
 
 		// Start web server if needed.
 		startWebServer();
+		if (webServer)
+		{
+			webServer->addFile(dff);
+			webServer->addFile(txd);
+		}
 		return true;
 	}
 
@@ -7,11 +7,26 @@
  */
 
 #include "databases_component.hpp"
+#include <algorithm>
+#include <cctype>
 
 DatabaseConnection::DatabaseConnection(DatabasesComponent* parentDatabasesComponent, sqlite3* databaseConnectionHandle)
 	: parentDatabasesComponent(parentDatabasesComponent)
 	, databaseConnectionHandle(databaseConnectionHandle)
 {
+	// The worker thread's handle can hold the write lock, so wait for it rather than fail with SQLITE_BUSY.
+	sqlite3_busy_timeout(databaseConnectionHandle, BusyTimeout);
+}
+
+DatabaseConnection::~DatabaseConnection()
+{
+	close();
+
+	// Results the component didn't take before destroying the connection, e.g. when it's shutting down
+	for (DatabaseAsyncQuery& async_query : asyncResults)
+	{
+		async_query.handler->onDatabaseQueryCancelled();
+	}
 }
 
 /// Gets its pool element ID
@@ -28,6 +43,13 @@ bool DatabaseConnection::close()
 	bool ret(databaseConnectionHandle != nullptr);
 	if (ret)
 	{
+		if (!flushWrites() && !queuedWrites.empty())
+		{
+			// There's no later batch to retry them in, so run them on their own rather than lose them.
+			executeWrites(false);
+		}
+		stopAsyncWorker();
+		clearStatementCache();
 		sqlite3_close(databaseConnectionHandle);
 		databaseConnectionHandle = nullptr;
 	}
@@ -39,6 +61,8 @@ bool DatabaseConnection::close()
 /// @returns Result set
 IDatabaseResultSet* DatabaseConnection::executeQuery(StringView query)
 {
+	waitForAsyncQueries();
+	flushWritesBeforeRead();
 	IDatabaseResultSet* ret(parentDatabasesComponent->createResultSet());
 	if (ret)
 	{
@@ -58,6 +82,399 @@ IDatabaseResultSet* DatabaseConnection::executeQuery(StringView query)
 	return ret;
 }
 
+/// Prepares a statement, reusing a cached compilation of the same SQL if there is one
+/// @param query Query with parameters, containing one SQL statement
+/// @returns Statement if successful, otherwise "nullptr"
+IDatabaseStatement* DatabaseConnection::prepareStatement(StringView query)
+{
+	if (!databaseConnectionHandle)
+	{
+		return nullptr;
+	}
+
+	sqlite3_stmt* statement_handle(nullptr);
+	auto cached_statement(cachedStatementLookup.find(String(query)));
+	if (cached_statement != cachedStatementLookup.end())
+	{
+		statement_handle = cached_statement->second->second;
+		cachedStatements.erase(cached_statement->second);
+		cachedStatementLookup.erase(cached_statement);
+	}
+	else
+	{
+		const char* tail(nullptr);
+		if (sqlite3_prepare_v2(databaseConnectionHandle, query.data(), query.size(), &statement_handle, &tail) != SQLITE_OK || !statement_handle)
+		{
+			parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Error preparing statement: %s", sqlite3_errmsg(databaseConnectionHandle));
+			sqlite3_finalize(statement_handle);
+			return nullptr;
+		}
+		for (; tail < query.data() + query.size(); ++tail)
+		{
+			if (!isspace(static_cast<unsigned char>(*tail)) && *tail != ';')
+			{
+				parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Error preparing statement: Only one statement can be prepared at a time.");
+				sqlite3_finalize(statement_handle);
+				return nullptr;
+			}
+		}
+	}
+
+	IDatabaseStatement* ret(parentDatabasesComponent->createStatement(this, query, statement_handle));
+	if (!ret)
+	{
+		parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Could not create SQLite statement.");
+		releaseStatement(String(query), statement_handle);
+	}
+	return ret;
+}
+
+/// Returns a statement that's no longer used to the cache
+/// @param query SQL the statement was prepared from
+/// @param statementHandle Statement handle
+void DatabaseConnection::releaseStatement(const String& query, sqlite3_stmt* statementHandle)
+{
+	// Keep one compilation of each SQL, a copy is only needed while the same SQL is prepared twice
+	if (!databaseConnectionHandle || cachedStatementLookup.find(query) != cachedStatementLookup.end())
+	{
+		sqlite3_finalize(statementHandle);
+		return;
+	}
+
+	sqlite3_reset(statementHandle);
+	sqlite3_clear_bindings(statementHandle);
+	cachedStatements.emplace_front(query, statementHandle);
+	cachedStatementLookup.emplace(query, cachedStatements.begin());
+
+	if (cachedStatements.size() > StatementCacheSize)
+	{
+		sqlite3_finalize(cachedStatements.back().second);
+		cachedStatementLookup.erase(cachedStatements.back().first);
+		cachedStatements.pop_back();
+	}
+}
+
+/// Finalizes all idle compiled statements
+void DatabaseConnection::clearStatementCache()
+{
+	for (auto& cached_statement : cachedStatements)
+	{
+		sqlite3_finalize(cached_statement.second);
+	}
+	cachedStatements.clear();
+	cachedStatementLookup.clear();
+}
+
+/// Queues a query to execute on the connection's worker thread, with its own handle to the database
+/// Later queries on this connection wait for it, so they run in the order they were made
+/// @param query Query to execute
+/// @param handler Handler called with the result set in a later tick, or when the connection is closed
+/// @returns "true" if the query has been queued, "false" if the queue is full or the connection is closed
+bool DatabaseConnection::executeQueryAsync(StringView query, DatabaseQueryHandler* handler)
+{
+	if (!databaseConnectionHandle || !handler)
+	{
+		return false;
+	}
+	flushWritesBeforeRead();
+
+	if (!asyncWorkerInitialised)
+	{
+		asyncWorkerInitialised = true;
+		if (!startAsyncWorker())
+		{
+			parentDatabasesComponent->log(LogLevel::Message, "[log_sqlite]: Asynchronous queries on this database will execute on the main thread.");
+		}
+	}
+
+	parentDatabasesComponent->logQuery("[log_sqlite_queries]: %.*s", PRINT_VIEW(query));
+	DatabaseAsyncQuery async_query { String(query), handler, std::make_unique<DatabaseResultSet>() };
+	if (!asyncWorker.joinable())
+	{
+		// Still call the handler in a later tick, so it behaves the same whether or not there's a worker thread.
+		char* error(nullptr);
+		if (sqlite3_exec(databaseConnectionHandle, async_query.query.c_str(), queryStepExecuted, async_query.resultSet.get(), &error) != SQLITE_OK)
+		{
+			async_query.resultSet.reset();
+			async_query.error = error ? error : "";
+		}
+		sqlite3_free(error);
+		std::lock_guard<std::mutex> lock(asyncMutex);
+		asyncResults.push_back(std::move(async_query));
+		return true;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(asyncMutex);
+		if (asyncQueries.size() >= AsyncQueueSize)
+		{
+			parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Asynchronous query queue is full.");
+			return false;
+		}
+		asyncQueries.push_back(std::move(async_query));
+	}
+	asyncCondition.notify_one();
+	return true;
+}
+
+/// Queues a query that returns no rows, to execute with the other queued writes in one transaction
+/// @param query Query to execute
+/// @returns "true" if the query has been queued, otherwise "false"
+bool DatabaseConnection::queueWrite(StringView query)
+{
+	if (!databaseConnectionHandle)
+	{
+		return false;
+	}
+
+	queuedWrites.emplace_back(query);
+	if (queuedWrites.size() >= parentDatabasesComponent->getBatchMaxQueries())
+	{
+		flushWrites();
+	}
+	return true;
+}
+
+/// Executes and commits the queued writes now
+/// @returns "true" if the batch has been committed or there was nothing queued, otherwise "false"
+bool DatabaseConnection::flushWrites()
+{
+	return executeWrites(true);
+}
+
+/// Executes the queued writes if reads are configured to see them
+void DatabaseConnection::flushWritesBeforeRead()
+{
+	if (!queuedWrites.empty() && parentDatabasesComponent->getFlushWritesBeforeReads())
+	{
+		flushWrites();
+	}
+}
+
+/// Executes the queued writes
+/// @param batched Whether to run them in one transaction, if the script doesn't have one open
+/// @returns "true" if the writes have been committed or there was nothing queued, otherwise "false"
+bool DatabaseConnection::executeWrites(bool batched)
+{
+	lastWriteBatch = Time::now();
+	if (queuedWrites.empty())
+	{
+		return true;
+	}
+
+	waitForAsyncQueries();
+
+	// Every implicit transaction syncs the journal, so one transaction for the whole batch saves all but one of them.
+	// If the script has its own transaction open the writes become part of it instead.
+	const TimePoint start(lastWriteBatch);
+	const bool own_transaction(batched && sqlite3_get_autocommit(databaseConnectionHandle) != 0);
+	if (own_transaction && sqlite3_exec(databaseConnectionHandle, "BEGIN", nullptr, nullptr, nullptr) != SQLITE_OK)
+	{
+		// E.g. another process holds the lock, none of the writes ran so keep them for the next batch.
+		parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Error beginning write batch, keeping %zu writes queued: %s", queuedWrites.size(), sqlite3_errmsg(databaseConnectionHandle));
+		return false;
+	}
+
+	bool ret(true);
+	std::size_t failed_queries(0);
+	for (const String& query : queuedWrites)
+	{
+		parentDatabasesComponent->logQuery("[log_sqlite_queries]: %s", query.c_str());
+		char* error(nullptr);
+		if (sqlite3_exec(databaseConnectionHandle, query.c_str(), nullptr, nullptr, &error) != SQLITE_OK)
+		{
+			++failed_queries;
+			parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Error executing queued write: %s", error ? error : "");
+		}
+		sqlite3_free(error);
+	}
+
+	if (own_transaction)
+	{
+		// Some errors, like a full disk, roll back the whole transaction on their own.
+		if (sqlite3_get_autocommit(databaseConnectionHandle) != 0)
+		{
+			parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Write batch was rolled back.");
+			ret = false;
+		}
+		else if (sqlite3_exec(databaseConnectionHandle, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK)
+		{
+			parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Error committing write batch: %s", sqlite3_errmsg(databaseConnectionHandle));
+			sqlite3_exec(databaseConnectionHandle, "ROLLBACK", nullptr, nullptr, nullptr);
+			ret = false;
+		}
+	}
+	if (!ret)
+	{
+		failed_queries = queuedWrites.size();
+	}
+
+	const Microseconds latency(duration_cast<Microseconds>(Time::now() - start));
+	++writeBatchStats.batches;
+	writeBatchStats.queries += queuedWrites.size();
+	writeBatchStats.failedQueries += failed_queries;
+	writeBatchStats.lastSize = queuedWrites.size();
+	writeBatchStats.lastLatency = latency;
+	writeBatchStats.maxLatency = std::max(writeBatchStats.maxLatency, latency);
+	parentDatabasesComponent->recordWriteBatch(queuedWrites.size(), failed_queries, latency);
+	queuedWrites.clear();
+	return ret;
+}
+
+/// Gets the statistics of this connection's write batches
+/// @returns Write batch statistics
+const DatabaseWriteBatchStats& DatabaseConnection::getWriteBatchStats() const
+{
+	return writeBatchStats;
+}
+
+/// Applies the `database.synchronous`, `database.wal` and `database.journal_size_limit` settings to this connection
+/// @returns "true" if the settings have been applied, otherwise "false"
+bool DatabaseConnection::applyDurabilitySettings()
+{
+	if (!databaseConnectionHandle)
+	{
+		return false;
+	}
+
+	durabilitySettingsApplied = true;
+	parentDatabasesComponent->applyDurabilitySettings(databaseConnectionHandle);
+
+	// The worker thread's handle can only be used from its thread, so stop it and let the next query open it again with the settings.
+	if (asyncWorker.joinable())
+	{
+		stopAsyncWorker();
+		asyncWorkerInitialised = false;
+	}
+	return true;
+}
+
+/// Executes the queued writes if the batch interval has passed since the last batch
+/// @param now Current time
+/// @param interval Batch interval
+void DatabaseConnection::flushWritesIfDue(TimePoint now, Milliseconds interval)
+{
+	if (!queuedWrites.empty() && now - lastWriteBatch >= interval)
+	{
+		flushWrites();
+	}
+}
+
+/// Moves the executed asynchronous queries in to a list, to have their handlers called
+/// @param outResults Executed queries (out)
+void DatabaseConnection::takeAsyncResults(DynamicArray<DatabaseAsyncQuery>& outResults)
+{
+	std::lock_guard<std::mutex> lock(asyncMutex);
+	for (DatabaseAsyncQuery& async_query : asyncResults)
+	{
+		outResults.push_back(std::move(async_query));
+	}
+	asyncResults.clear();
+}
+
+/// Opens the worker thread's handle and starts the thread, if the database is a file
+/// @returns "true" if the worker thread is running
+bool DatabaseConnection::startAsyncWorker()
+{
+	// In-memory and temporary databases have no file name, and can't be opened again from another handle.
+	const char* file_name(sqlite3_db_filename(databaseConnectionHandle, "main"));
+	if (!file_name || !*file_name)
+	{
+		return false;
+	}
+
+	const int flags((sqlite3_db_readonly(databaseConnectionHandle, "main") == 1) ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE);
+	if (sqlite3_open_v2(file_name, &asyncConnectionHandle, flags | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK)
+	{
+		parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Could not open worker connection: %s", sqlite3_errmsg(asyncConnectionHandle));
+		sqlite3_close(asyncConnectionHandle);
+		asyncConnectionHandle = nullptr;
+		return false;
+	}
+
+	// The journal mode is left to the database, WAL is only used if the script asked for it with applyDurabilitySettings.
+	sqlite3_busy_timeout(asyncConnectionHandle, BusyTimeout);
+	if (durabilitySettingsApplied)
+	{
+		parentDatabasesComponent->applyDurabilitySettings(asyncConnectionHandle);
+	}
+
+	asyncWorkerStopping = false;
+	asyncWorker = std::thread(&DatabaseConnection::asyncWorkerMain, this);
+	return true;
+}
+
+/// Executes the remaining queued queries then stops the worker thread
+void DatabaseConnection::stopAsyncWorker()
+{
+	if (asyncWorker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(asyncMutex);
+			asyncWorkerStopping = true;
+		}
+		asyncCondition.notify_one();
+		asyncWorker.join();
+	}
+	if (asyncConnectionHandle)
+	{
+		sqlite3_close(asyncConnectionHandle);
+		asyncConnectionHandle = nullptr;
+	}
+}
+
+/// Worker thread's loop
+void DatabaseConnection::asyncWorkerMain()
+{
+	std::unique_lock<std::mutex> lock(asyncMutex);
+	for (;;)
+	{
+		asyncCondition.wait(lock, [this]()
+			{
+				return asyncWorkerStopping || !asyncQueries.empty();
+			});
+		if (asyncQueries.empty())
+		{
+			break;
+		}
+
+		DatabaseAsyncQuery async_query(std::move(asyncQueries.front()));
+		asyncQueries.pop_front();
+		asyncQueryRunning = true;
+		lock.unlock();
+
+		char* error(nullptr);
+		if (sqlite3_exec(asyncConnectionHandle, async_query.query.c_str(), queryStepExecuted, async_query.resultSet.get(), &error) != SQLITE_OK)
+		{
+			async_query.resultSet.reset();
+			async_query.error = error ? error : "";
+		}
+		sqlite3_free(error);
+
+		lock.lock();
+		asyncResults.push_back(std::move(async_query));
+		asyncQueryRunning = false;
+		if (asyncQueries.empty())
+		{
+			asyncIdleCondition.notify_all();
+		}
+	}
+}
+
+/// Waits for the queued asynchronous queries, so a query made after them runs after them
+void DatabaseConnection::waitForAsyncQueries()
+{
+	if (!asyncWorker.joinable())
+	{
+		return;
+	}
+	std::unique_lock<std::mutex> lock(asyncMutex);
+	asyncIdleCondition.wait(lock, [this]()
+		{
+			return asyncQueries.empty() && !asyncQueryRunning;
+		});
+}
+
 /// Gets invoked when a query step has been performed
 /// @param userData User data
 /// @param fieldCount Field count
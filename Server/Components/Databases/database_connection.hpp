@@ -12,12 +12,35 @@
 #include <sqlite3.h>
 
 #include "database_result_set.hpp"
+#include "database_statement.hpp"
 #include <Impl/pool_impl.hpp>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 using namespace Impl;
 
 class DatabasesComponent;
 
+/// A query queued with `executeQueryAsync`, moved to the completed queue once it's executed
+struct DatabaseAsyncQuery
+{
+	/// Query to execute
+	String query;
+
+	/// Handler to call with the result set
+	DatabaseQueryHandler* handler;
+
+	/// Rows collected on the worker thread, or "nullptr" if the query failed
+	std::unique_ptr<DatabaseResultSet> resultSet;
+
+	/// SQLite's error message if the query failed
+	String error;
+};
+
 class DatabaseConnection final : public IDatabaseConnection, public PoolIDProvider, public NoCopy
 {
 private:
@@ -27,9 +50,86 @@ private:
 	/// Database connection handle
 	sqlite3* databaseConnectionHandle;
 
+	/// Maximum number of idle compiled statements kept per connection
+	static constexpr std::size_t StatementCacheSize = 32;
+
+	/// Idle compiled statements, most recently used first
+	std::list<Pair<String, sqlite3_stmt*>> cachedStatements;
+
+	/// SQL to idle compiled statement lookup
+	FlatHashMap<String, std::list<Pair<String, sqlite3_stmt*>>::iterator> cachedStatementLookup;
+
+	/// Finalizes all idle compiled statements
+	void clearStatementCache();
+
+	/// Maximum number of queries waiting to execute on the worker thread
+	static constexpr std::size_t AsyncQueueSize = 1024;
+
+	/// How long each handle waits for a lock held by the other, in milliseconds
+	static constexpr int BusyTimeout = 5000;
+
+	/// Worker thread's handle to the same database
+	sqlite3* asyncConnectionHandle = nullptr;
+
+	/// Whether starting the worker thread has been tried
+	bool asyncWorkerInitialised = false;
+
+	/// Whether the worker thread should exit once its queue is empty
+	bool asyncWorkerStopping = false;
+
+	/// Worker thread executing queued queries in order
+	std::thread asyncWorker;
+
+	/// Protects the queues and the stopping flag
+	std::mutex asyncMutex;
+
+	/// Signalled when a query is queued or the worker thread should stop
+	std::condition_variable asyncCondition;
+
+	/// Queries waiting to execute
+	std::deque<DatabaseAsyncQuery> asyncQueries;
+
+	/// Executed queries waiting for their handlers to be called on the main thread
+	std::deque<DatabaseAsyncQuery> asyncResults;
+
+	/// Whether the worker thread is executing a query it took off the queue
+	bool asyncQueryRunning = false;
+
+	/// Signalled when the worker thread has executed every queued query
+	std::condition_variable asyncIdleCondition;
+
+	/// Opens the worker thread's handle and starts the thread, if the database is a file
+	/// @returns "true" if the worker thread is running
+	bool startAsyncWorker();
+
+	/// Executes the remaining queued queries then stops the worker thread
+	void stopAsyncWorker();
+
+	/// Worker thread's loop
+	void asyncWorkerMain();
+
+	/// Writes waiting for the next batch
+	DynamicArray<String> queuedWrites;
+
+	/// When the last write batch was executed
+	TimePoint lastWriteBatch = Time::now();
+
+	/// Write batch statistics
+	DatabaseWriteBatchStats writeBatchStats {};
+
+	/// Whether the configured durability settings were applied, so the worker thread's handle gets them too
+	bool durabilitySettingsApplied = false;
+
+	/// Executes the queued writes
+	/// @param batched Whether to run them in one transaction, if the script doesn't have one open
+	/// @returns "true" if the writes have been committed or there was nothing queued, otherwise "false"
+	bool executeWrites(bool batched);
+
 public:
 	DatabaseConnection(DatabasesComponent* parentDatabasesComponent, sqlite3* databaseConnectionHandle);
 
+	~DatabaseConnection();
+
 	/// Gets its pool element ID
 	/// @return Pool element ID
 	int getID() const override;
@@ -44,6 +144,56 @@ public:
 	/// @returns Result set
 	IDatabaseResultSet* executeQuery(StringView query) override;
 
+	/// Prepares a statement, reusing a cached compilation of the same SQL if there is one
+	/// @param query Query with parameters, containing one SQL statement
+	/// @returns Statement if successful, otherwise "nullptr"
+	IDatabaseStatement* prepareStatement(StringView query) override;
+
+	/// Returns a statement that's no longer used to the cache
+	/// @param query SQL the statement was prepared from
+	/// @param statementHandle Statement handle
+	void releaseStatement(const String& query, sqlite3_stmt* statementHandle);
+
+	/// Queues a query to execute on the connection's worker thread, with its own handle to the database
+	/// Later queries on this connection wait for it, so they run in the order they were made. With WAL mode, see
+	/// `applyDurabilitySettings`, the main thread's handle can keep reading while the worker thread writes.
+	/// @param query Query to execute
+	/// @param handler Handler called with the result set in a later tick, or when the connection is closed
+	/// @returns "true" if the query has been queued, "false" if the queue is full or the connection is closed
+	bool executeQueryAsync(StringView query, DatabaseQueryHandler* handler) override;
+
+	/// Queues a query that returns no rows, to execute with the other queued writes in one transaction
+	/// @param query Query to execute
+	/// @returns "true" if the query has been queued, otherwise "false"
+	bool queueWrite(StringView query) override;
+
+	/// Executes and commits the queued writes now
+	/// @returns "true" if the batch has been committed or there was nothing queued, otherwise "false"
+	bool flushWrites() override;
+
+	/// Gets the statistics of this connection's write batches
+	/// @returns Write batch statistics
+	const DatabaseWriteBatchStats& getWriteBatchStats() const override;
+
+	/// Applies the `database.synchronous`, `database.wal` and `database.journal_size_limit` settings to this connection
+	/// @returns "true" if the settings have been applied, otherwise "false"
+	bool applyDurabilitySettings() override;
+
+	/// Executes the queued writes if reads are configured to see them
+	void flushWritesBeforeRead();
+
+	/// Waits for the queued asynchronous queries, so a query made after them runs after them
+	void waitForAsyncQueries();
+
+	/// Executes the queued writes if the batch interval has passed since the last batch
+	/// @param now Current time
+	/// @param interval Batch interval
+	void flushWritesIfDue(TimePoint now, Milliseconds interval);
+
+	/// Moves the executed asynchronous queries in to a list, to have their handlers called
+	/// @param outResults Executed queries (out)
+	void takeAsyncResults(DynamicArray<DatabaseAsyncQuery>& outResults);
+
 private:
 	/// Gets invoked when a query step has been performed
 	/// @param userData User data
@@ -7,54 +7,84 @@
  */
 
 #include "database_result_set.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <utility>
 
 /// Adds a row
 /// @param fieldCount Field count
-/// @param values Field values
 /// @param fieldNames Field names
+/// @param values Field values
 /// @returns "true" if row has been successfully added, otherwise "false"
 bool DatabaseResultSet::addRow(int fieldCount, char** fieldNames, char** values)
 {
 	bool ret((fieldCount <= 0) || (values && fieldNames));
 	if (ret)
 	{
-
-		// First time DatabaseResultSet::addRow being called after query exeuction
-		// so push all field names back to our vector of char* so we are keeping data
-		// for using it in legacy database result structure
-		legacyDbResult.addColumns(fieldCount, fieldNames, values);
-
-		rows.push({});
-		DatabaseResultSetRow* result_set_row(&rows.back());
-		for (int field_index(0); field_index < fieldCount; field_index++)
+		// The columns are the same for every row, so only store their names for the first one
+		if (rowCount == 0)
 		{
-
-			// Push values in a row back to our vector of char*, keeping them and all rows
-			// in order for using it in legacy database result structure
-			legacyDbResult.addField(values[field_index]);
-
-			if (!result_set_row->addField(fieldNames[field_index], values[field_index] ? values[field_index] : ""))
+			// The lookup's keys point in to the names, so they must not be reallocated
+			names.reserve(fieldCount);
+			for (int field_index(0); field_index < fieldCount; field_index++)
 			{
-				ret = false;
-				break;
+				names.emplace_back(fieldNames[field_index]);
+				if (!fieldNameToFieldIndexLookup.emplace(StringView(names.back()), field_index).second)
+				{
+					names.clear();
+					fieldNameToFieldIndexLookup.clear();
+					return false;
+				}
 			}
 		}
-		if (ret)
-		{
-			++rowCount;
-		}
-		else
+
+		for (int field_index(0); field_index < fieldCount; field_index++)
 		{
-			rows.pop();
+			// Keep the terminator so values can be parsed in place and handed to the legacy structure
+			const char* value(values[field_index] ? values[field_index] : "");
+			const std::size_t length(strlen(value));
+			valueOffsets.push_back(arena.size());
+			valueLengths.push_back(length);
+			valueNulls.push_back(values[field_index] == nullptr);
+			arena.insert(arena.end(), value, value + length + 1);
 		}
-
-		// Now here we are assigning collected results in legacy structure to
-		// our LegacyDBResult::results
-		legacyDbResult.columns = rowCount;
+		++rowCount;
+		legacyDbResultBuilt = false;
 	}
 	return ret;
 }
 
+/// Exchanges rows with another result set, used to move rows collected on another thread in to a pooled one
+/// @param other Result set
+void DatabaseResultSet::swapRows(DatabaseResultSet& other)
+{
+	// Swapping keeps the names' storage, so the lookup's views stay valid
+	names.swap(other.names);
+	std::swap(fieldNameToFieldIndexLookup, other.fieldNameToFieldIndexLookup);
+	arena.swap(other.arena);
+	valueOffsets.swap(other.valueOffsets);
+	valueLengths.swap(other.valueLengths);
+	valueNulls.swap(other.valueNulls);
+	std::swap(rowCount, other.rowCount);
+	std::swap(currentRow, other.currentRow);
+	legacyDbResultBuilt = false;
+	other.legacyDbResultBuilt = false;
+}
+
+/// Sets whether the component frees this result set once the asynchronous query handler it was passed to returns
+/// @param owned Owned by the component
+void DatabaseResultSet::setOwnedByComponent(bool owned)
+{
+	ownedByComponent = owned;
+}
+
+/// Gets whether the component frees this result set once the asynchronous query handler it was passed to returns
+/// @returns "true" if owned by the component, otherwise "false"
+bool DatabaseResultSet::isOwnedByComponent() const
+{
+	return ownedByComponent;
+}
+
 /// Gets its pool element ID
 /// @return Pool element ID
 int DatabaseResultSet::getID() const
@@ -73,18 +103,18 @@ std::size_t DatabaseResultSet::getRowCount() const
 /// @returns "true" if next row has been selected successfully, otherwise "false"
 bool DatabaseResultSet::selectNextRow()
 {
-	if (!rows.empty())
+	if (currentRow < rowCount)
 	{
-		rows.pop();
+		++currentRow;
 	}
-	return !rows.empty();
+	return currentRow < rowCount;
 }
 
 /// Gets the number of fields
 /// @returns Number of fields
 std::size_t DatabaseResultSet::getFieldCount() const
 {
-	return rows.empty() ? static_cast<std::size_t>(0) : rows.front().getFieldCount();
+	return (currentRow < rowCount) ? names.size() : static_cast<std::size_t>(0);
 }
 
 /// Is field name available
@@ -92,7 +122,7 @@ std::size_t DatabaseResultSet::getFieldCount() const
 /// @returns "true" if field name is available, otherwise "false"
 bool DatabaseResultSet::isFieldNameAvailable(StringView fieldName) const
 {
-	return !rows.empty() && rows.front().isFieldNameAvailable(fieldName);
+	return getValueIndex(fieldName) >= 0;
 }
 
 /// Gets the name of the field by the specified field index
@@ -100,7 +130,7 @@ bool DatabaseResultSet::isFieldNameAvailable(StringView fieldName) const
 /// @returns Name of the field
 StringView DatabaseResultSet::getFieldName(std::size_t fieldIndex) const
 {
-	return rows.empty() ? StringView() : rows.front().getFieldName(fieldIndex);
+	return (getValueIndex(fieldIndex) >= 0) ? StringView(names[fieldIndex]) : StringView();
 }
 
 /// Gets the string of the field by the specified field index
@@ -108,7 +138,8 @@ StringView DatabaseResultSet::getFieldName(std::size_t fieldIndex) const
 /// @returns String
 StringView DatabaseResultSet::getFieldString(std::size_t fieldIndex) const
 {
-	return rows.empty() ? StringView() : rows.front().getFieldString(fieldIndex);
+	const std::ptrdiff_t value_index(getValueIndex(fieldIndex));
+	return (value_index >= 0) ? StringView(arena.data() + valueOffsets[value_index], valueLengths[value_index]) : StringView();
 }
 
 /// Gets the integer of the field by the specified field index
@@ -116,7 +147,8 @@ StringView DatabaseResultSet::getFieldString(std::size_t fieldIndex) const
 /// @returns Integer
 long DatabaseResultSet::getFieldInt(std::size_t fieldIndex) const
 {
-	return rows.empty() ? 0L : rows.front().getFieldInt(fieldIndex);
+	const std::ptrdiff_t value_index(getValueIndex(fieldIndex));
+	return (value_index >= 0) ? std::atol(arena.data() + valueOffsets[value_index]) : 0L;
 }
 
 /// Gets the floating point number of the field by the specified field index
@@ -124,7 +156,8 @@ long DatabaseResultSet::getFieldInt(std::size_t fieldIndex) const
 /// @returns Floating point number
 double DatabaseResultSet::getFieldFloat(std::size_t fieldIndex) const
 {
-	return rows.empty() ? 0.0 : rows.front().getFieldFloat(fieldIndex);
+	const std::ptrdiff_t value_index(getValueIndex(fieldIndex));
+	return (value_index >= 0) ? std::atof(arena.data() + valueOffsets[value_index]) : 0.0;
 }
 
 /// Gets the string of the field by the specified field name
@@ -132,7 +165,8 @@ double DatabaseResultSet::getFieldFloat(std::size_t fieldIndex) const
 /// @returns String
 StringView DatabaseResultSet::getFieldStringByName(StringView fieldName) const
 {
-	return rows.empty() ? StringView() : rows.front().getFieldStringByName(fieldName);
+	const std::ptrdiff_t value_index(getValueIndex(fieldName));
+	return (value_index >= 0) ? StringView(arena.data() + valueOffsets[value_index], valueLengths[value_index]) : StringView();
 }
 
 /// Gets the integer of the field by the specified field name
@@ -140,7 +174,8 @@ StringView DatabaseResultSet::getFieldStringByName(StringView fieldName) const
 /// @returns Integer
 long DatabaseResultSet::getFieldIntByName(StringView fieldName) const
 {
-	return rows.empty() ? 0L : rows.front().getFieldIntByName(fieldName);
+	const std::ptrdiff_t value_index(getValueIndex(fieldName));
+	return (value_index >= 0) ? std::atol(arena.data() + valueOffsets[value_index]) : 0L;
 }
 
 /// Gets the floating point number of the field by the specified field name
@@ -148,11 +183,18 @@ long DatabaseResultSet::getFieldIntByName(StringView fieldName) const
 /// @returns Floating point number
 double DatabaseResultSet::getFieldFloatByName(StringView fieldName) const
 {
-	return rows.empty() ? 0.0 : rows.front().getFieldFloatByName(fieldName);
+	const std::ptrdiff_t value_index(getValueIndex(fieldName));
+	return (value_index >= 0) ? std::atof(arena.data() + valueOffsets[value_index]) : 0.0;
 }
 
 /// Gets database results in legacy structure
 LegacyDBResult& DatabaseResultSet::getLegacyDBResult()
 {
+	// Only point in to the values once they're complete, as adding rows moves them
+	if (!legacyDbResultBuilt)
+	{
+		legacyDbResult.build(names, arena, valueOffsets, valueNulls, rowCount);
+		legacyDbResultBuilt = true;
+	}
 	return legacyDbResult;
 }
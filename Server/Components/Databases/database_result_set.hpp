@@ -8,9 +8,8 @@
 
 #pragma once
 
-#include "database_result_set_row.hpp"
 #include <Impl/pool_impl.hpp>
-#include <queue>
+#include <Server/Components/Databases/databases.hpp>
 
 using namespace Impl;
 
@@ -19,26 +18,23 @@ class LegacyDBResultImpl : public LegacyDBResult
 private:
 	// Extra members to be used in open.mp code
 	DynamicArray<char*> results_;
-	bool fieldsAreAdded = false;
 
 public:
-	void addColumns(int fieldCount, char** fieldNames, char** values)
+	/// Points the legacy table at the field names followed by every row's values, NULL values stay null pointers
+	void build(const DynamicArray<String>& fieldNames, DynamicArray<char>& values, const DynamicArray<uint32_t>& valueOffsets, const DynamicArray<bool>& valueNulls, std::size_t rowCount)
 	{
-		if (!fieldsAreAdded)
+		results_.clear();
+		results_.reserve(fieldNames.size() + valueOffsets.size());
+		for (const String& fieldName : fieldNames)
 		{
-			for (int field_index(0); field_index < fieldCount; field_index++)
-			{
-				results_.push_back(fieldNames[field_index]);
-			}
-			columns = fieldCount;
-			fieldsAreAdded = true;
+			results_.push_back(const_cast<char*>(fieldName.c_str()));
 		}
-		results = results_.data();
-	}
-
-	void addField(char* value)
-	{
-		results_.push_back(const_cast<char*>(value ? value : ""));
+		for (std::size_t value_index(0); value_index < valueOffsets.size(); value_index++)
+		{
+			results_.push_back(valueNulls[value_index] ? nullptr : values.data() + valueOffsets[value_index]);
+		}
+		rows = rowCount;
+		columns = fieldNames.size();
 		results = results_.data();
 	}
 };
@@ -46,22 +42,79 @@ public:
 class DatabaseResultSet final : public IDatabaseResultSet, public PoolIDProvider, public NoCopy
 {
 private:
-	/// Rows
-	std::queue<DatabaseResultSetRow> rows;
+	/// Field names, shared by all rows
+	DynamicArray<String> names;
+
+	/// Field name to field index lookup, keyed by views of `names` so lookups don't allocate
+	FlatHashMap<StringView, std::size_t> fieldNameToFieldIndexLookup;
+
+	/// Every row's values back to back, each null terminated
+	DynamicArray<char> arena;
+
+	/// Offsets in to `arena` of each row's values, row by row
+	DynamicArray<uint32_t> valueOffsets;
+
+	/// Lengths of each row's values, row by row
+	DynamicArray<uint32_t> valueLengths;
+
+	/// Whether each row's values were NULL, row by row; they read as empty strings except in the legacy structure
+	DynamicArray<bool> valueNulls;
 
 	/// Number of rows
-	std::size_t rowCount;
+	std::size_t rowCount = 0;
+
+	/// Index of the selected row
+	std::size_t currentRow = 0;
 
 	/// Legacy database result to allow libraries access members of this structure from pawn (don't even ask)
 	LegacyDBResultImpl legacyDbResult;
 
+	/// Whether the legacy database result points at the current values
+	bool legacyDbResultBuilt = false;
+
+	/// Whether the component frees this result set once the asynchronous query handler it was passed to returns
+	bool ownedByComponent = false;
+
+	/// Gets the index of the selected row's field in the value columns
+	/// @param fieldIndex Field index
+	/// @returns Value index if the field exists, otherwise -1
+	std::ptrdiff_t getValueIndex(std::size_t fieldIndex) const
+	{
+		return (currentRow < rowCount && fieldIndex < names.size()) ? currentRow * names.size() + fieldIndex : -1;
+	}
+
+	/// Gets the index of the selected row's field in the value columns
+	/// @param fieldName Field name
+	/// @returns Value index if the field exists, otherwise -1
+	std::ptrdiff_t getValueIndex(StringView fieldName) const
+	{
+		if (currentRow >= rowCount)
+		{
+			return -1;
+		}
+		const FlatHashMap<StringView, std::size_t>::const_iterator& field_name_to_field_index_iterator(fieldNameToFieldIndexLookup.find(fieldName));
+		return (field_name_to_field_index_iterator == fieldNameToFieldIndexLookup.end()) ? -1 : getValueIndex(field_name_to_field_index_iterator->second);
+	}
+
 public:
 	/// Adds a row
 	/// @param fieldCount Field count
-	/// @param values Field values
 	/// @param fieldNames Field names
+	/// @param values Field values
 	/// @returns "true" if row has been successfully added, otherwise "false"
-	bool addRow(int fieldCount, char** values, char** fieldNames);
+	bool addRow(int fieldCount, char** fieldNames, char** values);
+
+	/// Exchanges rows with another result set, used to move rows collected on another thread in to a pooled one
+	/// @param other Result set
+	void swapRows(DatabaseResultSet& other);
+
+	/// Sets whether the component frees this result set once the asynchronous query handler it was passed to returns
+	/// @param owned Owned by the component
+	void setOwnedByComponent(bool owned);
+
+	/// Gets whether the component frees this result set once the asynchronous query handler it was passed to returns
+	/// @returns "true" if owned by the component, otherwise "false"
+	bool isOwnedByComponent() const;
 
 	/// Gets its pool element ID
 	/// @return Pool element ID
@@ -0,0 +1,128 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include "databases_component.hpp"
+
+DatabaseStatement::DatabaseStatement(DatabasesComponent* parentDatabasesComponent, DatabaseConnection* databaseConnection, StringView query, sqlite3_stmt* statementHandle)
+	: parentDatabasesComponent(parentDatabasesComponent)
+	, databaseConnection(databaseConnection)
+	, query(query)
+	, statementHandle(statementHandle)
+{
+}
+
+DatabaseStatement::~DatabaseStatement()
+{
+	databaseConnection->releaseStatement(query, statementHandle);
+}
+
+/// Gets its pool element ID
+/// @return Pool element ID
+int DatabaseStatement::getID() const
+{
+	return poolID;
+}
+
+/// Gets the database connection the statement was prepared on
+/// @returns Database connection
+DatabaseConnection* DatabaseStatement::getDatabaseConnection() const
+{
+	return databaseConnection;
+}
+
+/// Gets the index of a named parameter, such as ":name" or "?1"
+/// @param parameterName Parameter name, including its prefix
+/// @returns Parameter index, or 0 if there's no such parameter
+int DatabaseStatement::getParameterIndex(StringView parameterName) const
+{
+	return sqlite3_bind_parameter_index(statementHandle, String(parameterName).c_str());
+}
+
+/// Binds an integer to a parameter
+/// @param parameterIndex Parameter index, starting at 1
+/// @param value Integer
+/// @returns "true" if value has been successfully bound, otherwise "false"
+bool DatabaseStatement::bindInt(int parameterIndex, long value)
+{
+	return sqlite3_bind_int64(statementHandle, parameterIndex, value) == SQLITE_OK;
+}
+
+/// Binds a floating point number to a parameter
+/// @param parameterIndex Parameter index, starting at 1
+/// @param value Floating point number
+/// @returns "true" if value has been successfully bound, otherwise "false"
+bool DatabaseStatement::bindFloat(int parameterIndex, double value)
+{
+	return sqlite3_bind_double(statementHandle, parameterIndex, value) == SQLITE_OK;
+}
+
+/// Binds a copy of a string to a parameter
+/// @param parameterIndex Parameter index, starting at 1
+/// @param value String
+/// @returns "true" if value has been successfully bound, otherwise "false"
+bool DatabaseStatement::bindString(int parameterIndex, StringView value)
+{
+	return sqlite3_bind_text(statementHandle, parameterIndex, value.data(), value.size(), SQLITE_TRANSIENT) == SQLITE_OK;
+}
+
+/// Binds NULL to a parameter
+/// @param parameterIndex Parameter index, starting at 1
+/// @returns "true" if value has been successfully bound, otherwise "false"
+bool DatabaseStatement::bindNull(int parameterIndex)
+{
+	return sqlite3_bind_null(statementHandle, parameterIndex) == SQLITE_OK;
+}
+
+/// Binds NULL to all parameters
+void DatabaseStatement::clearBindings()
+{
+	sqlite3_clear_bindings(statementHandle);
+}
+
+/// Steps through the statement with the currently bound values, bindings are kept for the next execution
+/// @returns Result set with all rows stepped through, or "nullptr" on error
+IDatabaseResultSet* DatabaseStatement::execute()
+{
+	databaseConnection->waitForAsyncQueries();
+	databaseConnection->flushWritesBeforeRead();
+	IDatabaseResultSet* ret(parentDatabasesComponent->createResultSet());
+	if (!ret)
+	{
+		parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Could not create SQLite result set.");
+		return nullptr;
+	}
+
+	parentDatabasesComponent->logQuery("[log_sqlite_queries]: %.*s", PRINT_VIEW(query));
+	DatabaseResultSet* result_set(static_cast<DatabaseResultSet*>(ret));
+	const int field_count(sqlite3_column_count(statementHandle));
+	fieldNames.resize(field_count);
+	values.resize(field_count);
+	int step_result;
+	while ((step_result = sqlite3_step(statementHandle)) == SQLITE_ROW)
+	{
+		for (int field_index(0); field_index < field_count; field_index++)
+		{
+			fieldNames[field_index] = const_cast<char*>(sqlite3_column_name(statementHandle, field_index));
+			values[field_index] = reinterpret_cast<char*>(const_cast<unsigned char*>(sqlite3_column_text(statementHandle, field_index)));
+		}
+		if (!result_set->addRow(field_count, fieldNames.data(), values.data()))
+		{
+			step_result = SQLITE_ABORT;
+			break;
+		}
+	}
+	sqlite3_reset(statementHandle);
+
+	if (step_result != SQLITE_DONE)
+	{
+		parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Error executing statement: %s", sqlite3_errmsg(sqlite3_db_handle(statementHandle)));
+		parentDatabasesComponent->freeResultSet(*ret);
+		ret = nullptr;
+	}
+	return ret;
+}
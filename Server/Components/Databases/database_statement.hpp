@@ -0,0 +1,90 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <pool.hpp>
+#include <sqlite3.h>
+
+#include <Impl/pool_impl.hpp>
+#include <Server/Components/Databases/databases.hpp>
+
+using namespace Impl;
+
+class DatabaseConnection;
+class DatabasesComponent;
+
+class DatabaseStatement final : public IDatabaseStatement, public PoolIDProvider, public NoCopy
+{
+private:
+	/// Parent databases component
+	DatabasesComponent* parentDatabasesComponent;
+
+	/// Database connection the statement was prepared on
+	DatabaseConnection* databaseConnection;
+
+	/// SQL the statement was prepared from, to return it to the connection's cache
+	String query;
+
+	/// Statement handle
+	sqlite3_stmt* statementHandle;
+
+	/// Field names of the current row, reused between executions
+	DynamicArray<char*> fieldNames;
+
+	/// Field values of the current row, reused between executions
+	DynamicArray<char*> values;
+
+public:
+	DatabaseStatement(DatabasesComponent* parentDatabasesComponent, DatabaseConnection* databaseConnection, StringView query, sqlite3_stmt* statementHandle);
+
+	~DatabaseStatement();
+
+	/// Gets its pool element ID
+	/// @return Pool element ID
+	int getID() const override;
+
+	/// Gets the database connection the statement was prepared on
+	/// @returns Database connection
+	DatabaseConnection* getDatabaseConnection() const;
+
+	/// Gets the index of a named parameter, such as ":name" or "?1"
+	/// @param parameterName Parameter name, including its prefix
+	/// @returns Parameter index, or 0 if there's no such parameter
+	int getParameterIndex(StringView parameterName) const override;
+
+	/// Binds an integer to a parameter
+	/// @param parameterIndex Parameter index, starting at 1
+	/// @param value Integer
+	/// @returns "true" if value has been successfully bound, otherwise "false"
+	bool bindInt(int parameterIndex, long value) override;
+
+	/// Binds a floating point number to a parameter
+	/// @param parameterIndex Parameter index, starting at 1
+	/// @param value Floating point number
+	/// @returns "true" if value has been successfully bound, otherwise "false"
+	bool bindFloat(int parameterIndex, double value) override;
+
+	/// Binds a copy of a string to a parameter
+	/// @param parameterIndex Parameter index, starting at 1
+	/// @param value String
+	/// @returns "true" if value has been successfully bound, otherwise "false"
+	bool bindString(int parameterIndex, StringView value) override;
+
+	/// Binds NULL to a parameter
+	/// @param parameterIndex Parameter index, starting at 1
+	/// @returns "true" if value has been successfully bound, otherwise "false"
+	bool bindNull(int parameterIndex) override;
+
+	/// Binds NULL to all parameters
+	void clearBindings() override;
+
+	/// Steps through the statement with the currently bound values, bindings are kept for the next execution
+	/// @returns Result set with all rows stepped through, or "nullptr" on error
+	IDatabaseResultSet* execute() override;
+};
@@ -7,11 +7,21 @@
  */
 
 #include "databases_component.hpp"
+#include <algorithm>
+#include <cstdio>
 
 DatabasesComponent::DatabasesComponent()
 {
 }
 
+DatabasesComponent::~DatabasesComponent()
+{
+	if (core_)
+	{
+		core_->getEventDispatcher().removeEventHandler(this);
+	}
+}
+
 /// Creates a  result set
 /// @returns Result set if successful, otherwise "nullptr"
 IDatabaseResultSet* DatabasesComponent::createResultSet()
@@ -20,24 +30,180 @@ IDatabaseResultSet* DatabasesComponent::createResultSet()
 	return databaseResultSets.get(result_set_index);
 }
 
+/// Creates a statement
+/// @param databaseConnection Database connection the statement was prepared on
+/// @param query SQL the statement was prepared from
+/// @param statementHandle Statement handle
+/// @returns Statement if successful, otherwise "nullptr"
+IDatabaseStatement* DatabasesComponent::createStatement(DatabaseConnection* databaseConnection, StringView query, sqlite3_stmt* statementHandle)
+{
+	return databaseStatements.emplace(this, databaseConnection, query, statementHandle);
+}
+
 /// Called for every component after components have been loaded
 /// Should be used for storing the core interface, registering player/core event handlers
 /// Should NOT be used for interacting with other components as they might not have been initialised yet
 void DatabasesComponent::onLoad(ICore* c)
 {
 	core_ = c;
+	logger_ = &core_->getStructuredLogger().getLogger(getUID());
+	databaseConnections.getEventDispatcher().setProfiler(&core_->getTickProfiler(), "DatabaseConnectionPoolEventHandler");
+	databaseResultSets.getEventDispatcher().setProfiler(&core_->getTickProfiler(), "DatabaseResultSetPoolEventHandler");
+	databaseStatements.getEventDispatcher().setProfiler(&core_->getTickProfiler(), "DatabaseStatementPoolEventHandler");
 	logSQLite_ = core_->getConfig().getBool("logging.log_sqlite");
 	logSQLiteQueries_ = core_->getConfig().getBool("logging.log_sqlite_queries");
+
+	IConfig& config(core_->getConfig());
+	synchronous = std::clamp(*config.getInt("database.synchronous"), 0, 3);
+	walMode = *config.getBool("database.wal");
+	journalSizeLimit = *config.getInt("database.journal_size_limit");
+	batchInterval = Milliseconds(std::max(*config.getInt("database.batch_interval"), 0));
+	batchMaxQueries = std::max(*config.getInt("database.batch_max_queries"), 1);
+	flushWritesBeforeReads = *config.getBool("database.flush_writes_before_reads");
+	writeBatchSection = core_->getTickProfiler().addSection("Databases: write batches");
+
+	core_->getEventDispatcher().addEventHandler(this);
+}
+
+/// Provides the defaults of the durability and write batch settings
+void DatabasesComponent::provideConfiguration(ILogger& logger, IEarlyConfig& config, bool defaults)
+{
+	if (defaults)
+	{
+		config.setInt("database.synchronous", synchronous);
+		config.setBool("database.wal", walMode);
+		config.setInt("database.journal_size_limit", journalSizeLimit);
+		config.setInt("database.batch_interval", batchInterval.count());
+		config.setInt("database.batch_max_queries", batchMaxQueries);
+		config.setBool("database.flush_writes_before_reads", flushWritesBeforeReads);
+	}
+	else
+	{
+		if (config.getType("database.synchronous") == ConfigOptionType_None)
+		{
+			config.setInt("database.synchronous", synchronous);
+		}
+		if (config.getType("database.wal") == ConfigOptionType_None)
+		{
+			config.setBool("database.wal", walMode);
+		}
+		if (config.getType("database.journal_size_limit") == ConfigOptionType_None)
+		{
+			config.setInt("database.journal_size_limit", journalSizeLimit);
+		}
+		if (config.getType("database.batch_interval") == ConfigOptionType_None)
+		{
+			config.setInt("database.batch_interval", batchInterval.count());
+		}
+		if (config.getType("database.batch_max_queries") == ConfigOptionType_None)
+		{
+			config.setInt("database.batch_max_queries", batchMaxQueries);
+		}
+		if (config.getType("database.flush_writes_before_reads") == ConfigOptionType_None)
+		{
+			config.setBool("database.flush_writes_before_reads", flushWritesBeforeReads);
+		}
+	}
+}
+
+/// Applies the configured durability pragmas to a connection handle
+/// @param databaseConnectionHandle Database connection handle
+void DatabasesComponent::applyDurabilitySettings(sqlite3* databaseConnectionHandle) const
+{
+	// Failures are ignored, e.g. read-only and in-memory databases can't change their journal mode.
+	char pragmas[128];
+	snprintf(pragmas, sizeof(pragmas), "PRAGMA synchronous=%d;PRAGMA journal_size_limit=%d;%s", synchronous, journalSizeLimit, walMode ? "PRAGMA journal_mode=WAL;" : "");
+	sqlite3_exec(databaseConnectionHandle, pragmas, nullptr, nullptr, nullptr);
+}
+
+/// Gets the number of queued writes that executes a batch straight away
+/// @returns Maximum number of queued writes
+std::size_t DatabasesComponent::getBatchMaxQueries() const
+{
+	return batchMaxQueries;
+}
+
+/// Gets whether queries flush the connection's queued writes first
+/// @returns "true" if queries see the queued writes, otherwise "false"
+bool DatabasesComponent::getFlushWritesBeforeReads() const
+{
+	return flushWritesBeforeReads;
+}
+
+/// Reports an executed write batch
+/// @param size Number of writes in the batch
+/// @param failedQueries Number of writes that failed
+/// @param latency Time the batch took to execute and commit
+void DatabasesComponent::recordWriteBatch(std::size_t size, std::size_t failedQueries, Microseconds latency)
+{
+	if (core_)
+	{
+		ITickProfiler& profiler(core_->getTickProfiler());
+		if (profiler.isEnabled())
+		{
+			profiler.record(writeBatchSection, latency);
+		}
+	}
+	log(LogLevel::Message, "[log_sqlite]: Executed a batch of %zu queued writes (%zu failed) in %lldus.", size, failedQueries, static_cast<long long>(latency.count()));
+}
+
+/// Executes due write batches and calls the handlers of asynchronous queries executed since the last tick
+void DatabasesComponent::onTick(Microseconds elapsed, TimePoint now)
+{
+	for (IDatabaseConnection* connection : databaseConnections.entries())
+	{
+		static_cast<DatabaseConnection*>(connection)->flushWritesIfDue(now, batchInterval);
+		static_cast<DatabaseConnection*>(connection)->takeAsyncResults(asyncResults);
+	}
+	processAsyncResults(asyncResults);
+}
+
+/// Calls executed asynchronous queries' handlers
+/// @param results Executed queries, cleared afterwards
+void DatabasesComponent::processAsyncResults(DynamicArray<DatabaseAsyncQuery>& results)
+{
+	// Handlers can close connections, so they're only called once the results have been taken from all of them.
+	for (DatabaseAsyncQuery& async_query : results)
+	{
+		IDatabaseResultSet* result_set(nullptr);
+		if (!async_query.resultSet)
+		{
+			log(LogLevel::Error, "[log_sqlite]: Error executing query: %s", async_query.error.c_str());
+		}
+		else if ((result_set = createResultSet()) != nullptr)
+		{
+			static_cast<DatabaseResultSet*>(result_set)->swapRows(*async_query.resultSet);
+			static_cast<DatabaseResultSet*>(result_set)->setOwnedByComponent(true);
+		}
+		else
+		{
+			log(LogLevel::Error, "[log_sqlite]: Could not create SQLite result set.");
+		}
+
+		const int result_set_index(result_set ? result_set->getID() : 0);
+		async_query.handler->onDatabaseQueryExecuted(result_set);
+
+		// The handler may have freed the result set already, and another may have been created with its ID since.
+		if (result_set_index)
+		{
+			DatabaseResultSet* owned_result_set(databaseResultSets.get(result_set_index));
+			if (owned_result_set && owned_result_set->isOwnedByComponent())
+			{
+				freeResultSet(*owned_result_set);
+			}
+		}
+	}
+	results.clear();
 }
 
 /// To optionally log things from connections.
 void DatabasesComponent::log(LogLevel level, const char* fmt, ...) const
 {
-	if (core_ && logSQLite_ && *logSQLite_)
+	if (logger_ && logSQLite_ && *logSQLite_)
 	{
 		va_list args;
 		va_start(args, fmt);
-		core_->vlogLn(level, fmt, args);
+		logger_->vlogLn(level, fmt, args);
 		va_end(args);
 	}
 }
@@ -45,11 +211,11 @@ void DatabasesComponent::log(LogLevel level, const char* fmt, ...) const
 /// To optionally log queries from connections.
 void DatabasesComponent::logQuery(const char* fmt, ...) const
 {
-	if (core_ && logSQLiteQueries_ && *logSQLiteQueries_)
+	if (logger_ && logSQLiteQueries_ && *logSQLiteQueries_)
 	{
 		va_list args;
 		va_start(args, fmt);
-		core_->vlogLn(LogLevel::Message, fmt, args);
+		logger_->vlogLn(LogLevel::Message, fmt, args);
 		va_end(args);
 	}
 }
@@ -86,8 +252,26 @@ bool DatabasesComponent::close(IDatabaseConnection& connection)
 	DatabaseConnection* res = databaseConnections.get(database_connection_index);
 	if (res)
 	{
+		// Statements can't outlive their connection
+		DynamicArray<int> statement_indices;
+		for (IDatabaseStatement* statement : databaseStatements.entries())
+		{
+			if (static_cast<DatabaseStatement*>(statement)->getDatabaseConnection() == res)
+			{
+				statement_indices.push_back(statement->getID());
+			}
+		}
+		for (int statement_index : statement_indices)
+		{
+			databaseStatements.remove(statement_index);
+		}
 		res->close();
+
+		// Call the handlers of the queries the worker thread finished executing while closing
+		DynamicArray<DatabaseAsyncQuery> results;
+		res->takeAsyncResults(results);
 		databaseConnections.remove(database_connection_index);
+		processAsyncResults(results);
 		return true;
 	}
 	return false;
@@ -155,6 +339,41 @@ IDatabaseResultSet& DatabasesComponent::getDatabaseResultSetByID(int databaseRes
 	return *databaseResultSets.get(databaseResultSetID);
 }
 
+/// Frees the specified statement
+/// @param statement Statement
+/// @returns "true" if statement has been successfully freed, otherwise "false"
+bool DatabasesComponent::freeStatement(IDatabaseStatement& statement)
+{
+	return databaseStatements.remove(statement.getID()).first;
+}
+
+/// Gets the number of database statements
+/// @returns Number of statements
+std::size_t DatabasesComponent::getDatabaseStatementCount() const
+{
+	return databaseStatements.entries().size();
+}
+
+/// Is database statement ID valid
+/// @param databaseStatementID Database statement ID
+/// @returns "true" if database statement ID is valid, otherwise "false"
+bool DatabasesComponent::isDatabaseStatementIDValid(int databaseStatementID) const
+{
+	if (databaseStatementID == 0)
+	{
+		return false;
+	}
+	return databaseStatements.get(databaseStatementID) != nullptr;
+}
+
+/// Gets a database statement by ID
+/// @param databaseStatementID Database statement ID
+/// @returns Database statement
+IDatabaseStatement& DatabasesComponent::getDatabaseStatementByID(int databaseStatementID)
+{
+	return *databaseStatements.get(databaseStatementID);
+}
+
 COMPONENT_ENTRY_POINT()
 {
 	return new DatabasesComponent();
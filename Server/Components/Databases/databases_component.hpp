@@ -13,29 +13,89 @@
 
 using namespace Impl;
 
-class DatabasesComponent final : public IDatabasesComponent, public NoCopy
+class DatabasesComponent final : public IDatabasesComponent, public CoreEventHandler, public NoCopy
 {
 private:
 	/// Database connections
 	/// TODO: Replace with a pool type that grows dynamically
-	DynamicPoolStorage<DatabaseConnection, IDatabaseConnection, 1, 1025> databaseConnections;
+	DynamicPoolStorage<DatabaseConnection, IDatabaseConnection, 1, DATABASE_CONNECTION_POOL_SIZE + 1> databaseConnections;
 
 	/// Database result sets
 	/// TODO: Replace with a pool type that grows dynamically
 	DynamicPoolStorage<DatabaseResultSet, IDatabaseResultSet, 1, 2049> databaseResultSets;
 
-	bool* logSQLite_;
-	bool* logSQLiteQueries_;
+	/// Database statements, declared after the connections so they're freed first
+	/// TODO: Replace with a pool type that grows dynamically
+	DynamicPoolStorage<DatabaseStatement, IDatabaseStatement, 1, 2049> databaseStatements;
+
+	bool* logSQLite_ = nullptr;
+	bool* logSQLiteQueries_ = nullptr;
+
+	ICore* core_ = nullptr;
+	ILogger* logger_ = nullptr;
+
+	/// `synchronous` pragma applied to connections that ask for it, from `database.synchronous`
+	int synchronous = 2;
+
+	/// Whether connections that ask for it are switched to WAL mode, from `database.wal`
+	bool walMode = false;
+
+	/// `journal_size_limit` pragma applied to connections that ask for it, from `database.journal_size_limit`
+	int journalSizeLimit = -1;
 
-	ICore* core_;
+	/// Whether queries flush the connection's queued writes first so they see them, from `database.flush_writes_before_reads`
+	bool flushWritesBeforeReads = false;
+
+	/// Minimum time between write batches, from `database.batch_interval`
+	Milliseconds batchInterval = Milliseconds(0);
+
+	/// Number of queued writes that executes a batch straight away, from `database.batch_max_queries`
+	int batchMaxQueries = 1000;
+
+	/// Tick profiler section write batches are recorded to
+	int writeBatchSection = -1;
+
+	/// Executed asynchronous queries whose handlers are being called, reused between ticks
+	DynamicArray<DatabaseAsyncQuery> asyncResults;
+
+	/// Calls executed asynchronous queries' handlers
+	/// @param results Executed queries, cleared afterwards
+	void processAsyncResults(DynamicArray<DatabaseAsyncQuery>& results);
 
 public:
 	/// Creates a result set
 	/// @returns Result set if successful, otherwise "nullptr"
 	IDatabaseResultSet* createResultSet();
 
+	/// Creates a statement
+	/// @param databaseConnection Database connection the statement was prepared on
+	/// @param query SQL the statement was prepared from
+	/// @param statementHandle Statement handle
+	/// @returns Statement if successful, otherwise "nullptr"
+	IDatabaseStatement* createStatement(DatabaseConnection* databaseConnection, StringView query, sqlite3_stmt* statementHandle);
+
+	/// Applies the configured durability pragmas to a connection handle
+	/// @param databaseConnectionHandle Database connection handle
+	void applyDurabilitySettings(sqlite3* databaseConnectionHandle) const;
+
+	/// Gets the number of queued writes that executes a batch straight away
+	/// @returns Maximum number of queued writes
+	std::size_t getBatchMaxQueries() const;
+
+	/// Gets whether queries flush the connection's queued writes first
+	/// @returns "true" if queries see the queued writes, otherwise "false"
+	bool getFlushWritesBeforeReads() const;
+
+	/// Reports an executed write batch
+	/// @param size Number of writes in the batch
+	/// @param failedQueries Number of writes that failed
+	/// @param latency Time the batch took to execute and commit
+	void recordWriteBatch(std::size_t size, std::size_t failedQueries, Microseconds latency);
+
 	DatabasesComponent();
 
+	~DatabasesComponent();
+
 	/// Gets the component name
 	/// @returns Component name
 	StringView componentName() const override
@@ -62,6 +122,12 @@ public:
 	/// Should NOT be used for interacting with other components as they might not have been initialised yet
 	void onLoad(ICore* c) override;
 
+	/// Provides the defaults of the durability and write batch settings
+	void provideConfiguration(ILogger& logger, IEarlyConfig& config, bool defaults) override;
+
+	/// Executes due write batches and calls the handlers of asynchronous queries executed since the last tick
+	void onTick(Microseconds elapsed, TimePoint now) override;
+
 	/// Opens a new database connection
 	/// @param path Path to the database
 	/// @param outDatabaseConnectionID Database connection ID (out)
@@ -105,6 +171,25 @@ public:
 	/// @returns Database result set
 	IDatabaseResultSet& getDatabaseResultSetByID(int databaseResultSetID) override;
 
+	/// Frees the specified statement
+	/// @param statement Statement
+	/// @returns "true" if statement has been successfully freed, otherwise "false"
+	bool freeStatement(IDatabaseStatement& statement) override;
+
+	/// Gets the number of database statements
+	/// @returns Number of statements
+	std::size_t getDatabaseStatementCount() const override;
+
+	/// Is database statement ID valid
+	/// @param databaseStatementID Database statement ID
+	/// @returns "true" if database statement ID is valid, otherwise "false"
+	bool isDatabaseStatementIDValid(int databaseStatementID) const override;
+
+	/// Gets a database statement by ID
+	/// @param databaseStatementID Database statement ID
+	/// @returns Database statement
+	IDatabaseStatement& getDatabaseStatementByID(int databaseStatementID) override;
+
 	/// To optionally log things from connections.
 	void log(LogLevel level, const char* fmt, ...) const;
 
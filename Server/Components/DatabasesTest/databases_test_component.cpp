@@ -15,6 +15,9 @@ const char* testDatabaseFilePath("../../../test.db");
 /// Test query
 const char* testQuery("SELECT * FROM `test`");
 
+/// Test statement query
+const char* testStatementQuery("SELECT `test_string` FROM `test` WHERE `test_integer` = :test_integer");
+
 struct DatabasesTestComponent final : public IComponent, public NoCopy
 {
 
@@ -249,6 +252,22 @@ struct DatabasesTestComponent final : public IComponent, public NoCopy
 				{
 					core->printLn("Failed to execute query \"%s\"", testQuery);
 				}
+				if (!testStatements(databases_component, database_connection))
+				{
+					databases_component->close(*database_connection);
+					return;
+				}
+				if (!testQueuedWrites(databases_component, database_connection))
+				{
+					databases_component->close(*database_connection);
+					return;
+				}
+				if (!testNullValues(databases_component, database_connection))
+				{
+					databases_component->close(*database_connection);
+					return;
+				}
+				benchmarkResultSets(databases_component, database_connection);
 				std::size_t open_database_connection_count(databases_component->getDatabaseConnectionCount());
 				if (open_database_connection_count != static_cast<std::size_t>(1))
 				{
@@ -272,6 +291,298 @@ struct DatabasesTestComponent final : public IComponent, public NoCopy
 		}
 	}
 
+	/// Tests prepared statements and the statement cache
+	/// @param databasesComponent Databases component
+	/// @param databaseConnection Database connection
+	/// @returns "true" if the test was successful, otherwise "false"
+	bool testStatements(IDatabasesComponent* databasesComponent, IDatabaseConnection* databaseConnection)
+	{
+		IDatabaseStatement* statement(databaseConnection->prepareStatement(testStatementQuery));
+		if (!statement)
+		{
+			core->printLn("[ERROR] Failed to prepare statement \"%s\"", testStatementQuery);
+			return false;
+		}
+		core->printLn("Statement ID: %d (0x%x)", statement->getID(), statement->getID());
+		if (!validateStatementCount(databasesComponent, 1))
+		{
+			databasesComponent->freeStatement(*statement);
+			return false;
+		}
+		const int parameter_index(statement->getParameterIndex(":test_integer"));
+		if (parameter_index != 1 || statement->getParameterIndex(":missing") != 0)
+		{
+			core->printLn("[ERROR] statement->getParameterIndex(\":test_integer\") returned \"%d\". Expected it to be \"1\", and \"0\" for missing parameters.", parameter_index);
+			databasesComponent->freeStatement(*statement);
+			return false;
+		}
+
+		// Bindings are kept between executions until they're cleared.
+		if (!statement->bindInt(parameter_index, 1337) || !validateStatementString(databasesComponent, statement, "Another test!") || !validateStatementString(databasesComponent, statement, "Another test!"))
+		{
+			databasesComponent->freeStatement(*statement);
+			return false;
+		}
+		statement->clearBindings();
+		if (!validateStatementRowCount(databasesComponent, statement, 0))
+		{
+			databasesComponent->freeStatement(*statement);
+			return false;
+		}
+		if (!statement->bindInt(parameter_index, 69) || !statement->bindNull(parameter_index) || !validateStatementRowCount(databasesComponent, statement, 0))
+		{
+			databasesComponent->freeStatement(*statement);
+			return false;
+		}
+
+		// The same SQL can be prepared again while the first statement is still in use.
+		IDatabaseStatement* other_statement(databaseConnection->prepareStatement(testStatementQuery));
+		if (!other_statement)
+		{
+			core->printLn("[ERROR] Failed to prepare statement \"%s\" a second time", testStatementQuery);
+			databasesComponent->freeStatement(*statement);
+			return false;
+		}
+		if (!validateStatementCount(databasesComponent, 2) || !other_statement->bindInt(1, 69) || !validateStatementString(databasesComponent, other_statement, "Hello world!"))
+		{
+			databasesComponent->freeStatement(*other_statement);
+			databasesComponent->freeStatement(*statement);
+			return false;
+		}
+		if (!databasesComponent->freeStatement(*other_statement) || !databasesComponent->freeStatement(*statement))
+		{
+			core->printLn("[ERROR] databases_component->freeStatement returned \"false\".");
+			return false;
+		}
+		if (!validateStatementCount(databasesComponent, 0))
+		{
+			return false;
+		}
+
+		// A statement taken from the cache starts without the bindings it was freed with.
+		statement = databaseConnection->prepareStatement(testStatementQuery);
+		if (!statement)
+		{
+			core->printLn("[ERROR] Failed to prepare cached statement \"%s\"", testStatementQuery);
+			return false;
+		}
+		if (!validateStatementRowCount(databasesComponent, statement, 0) || !statement->bindInt(1, 1337) || !validateStatementString(databasesComponent, statement, "Another test!"))
+		{
+			databasesComponent->freeStatement(*statement);
+			return false;
+		}
+		databasesComponent->freeStatement(*statement);
+
+		// Statements evicted from the cache are prepared again.
+		for (int i(0); i < 64; ++i)
+		{
+			const std::string query("SELECT " + std::to_string(i));
+			statement = databaseConnection->prepareStatement(query);
+			if (!statement)
+			{
+				core->printLn("[ERROR] Failed to prepare statement \"%s\"", query.c_str());
+				return false;
+			}
+			databasesComponent->freeStatement(*statement);
+		}
+		statement = databaseConnection->prepareStatement("SELECT ?1");
+		if (!statement)
+		{
+			core->printLn("[ERROR] Failed to prepare statement \"SELECT ?1\"");
+			return false;
+		}
+		IDatabaseResultSet* result_set(nullptr);
+		if (!statement->bindFloat(1, 1.5) || !(result_set = statement->execute()))
+		{
+			core->printLn("[ERROR] Failed to execute statement \"SELECT ?1\"");
+			databasesComponent->freeStatement(*statement);
+			return false;
+		}
+		const bool float_valid(validateFieldFloat(result_set, 0, 1.5));
+		databasesComponent->freeResultSet(*result_set);
+		databasesComponent->freeStatement(*statement);
+		if (!float_valid)
+		{
+			return false;
+		}
+
+		statement = databaseConnection->prepareStatement("SELECT 1; SELECT 2");
+		if (statement)
+		{
+			core->printLn("[ERROR] Preparing two statements at once succeeded. Expected it to fail.");
+			databasesComponent->freeStatement(*statement);
+			return false;
+		}
+		return validateStatementCount(databasesComponent, 0);
+	}
+
+	/// Tests queued writes and their batch statistics
+	/// @param databasesComponent Databases component
+	/// @param databaseConnection Database connection
+	/// @returns "true" if the test was successful, otherwise "false"
+	bool testQueuedWrites(IDatabasesComponent* databasesComponent, IDatabaseConnection* databaseConnection)
+	{
+		// A temporary table keeps the test database unchanged.
+		IDatabaseResultSet* result_set(databaseConnection->executeQuery("CREATE TEMP TABLE `queued_writes` (`value` INTEGER)"));
+		if (!result_set)
+		{
+			core->printLn("[ERROR] Failed to create the queued writes table");
+			return false;
+		}
+		databasesComponent->freeResultSet(*result_set);
+
+		const DatabaseWriteBatchStats stats(databaseConnection->getWriteBatchStats());
+		if (!databaseConnection->queueWrite("INSERT INTO `queued_writes` VALUES (1)") || !databaseConnection->queueWrite("INSERT INTO `missing_table` VALUES (1)") || !databaseConnection->queueWrite("INSERT INTO `queued_writes` VALUES (2)"))
+		{
+			core->printLn("[ERROR] databaseConnection->queueWrite returned \"false\".");
+			return false;
+		}
+		if (!databaseConnection->flushWrites())
+		{
+			core->printLn("[ERROR] databaseConnection->flushWrites() returned \"false\".");
+			return false;
+		}
+		const DatabaseWriteBatchStats& new_stats(databaseConnection->getWriteBatchStats());
+		if (new_stats.batches <= stats.batches || new_stats.queries - stats.queries != 3 || new_stats.failedQueries - stats.failedQueries != 1)
+		{
+			core->printLn("[ERROR] Write batch stats: %d queries, %d failed. Expected \"3\" queries and \"1\" failed.", int(new_stats.queries - stats.queries), int(new_stats.failedQueries - stats.failedQueries));
+			return false;
+		}
+
+		result_set = databaseConnection->executeQuery("SELECT COUNT(*) FROM `queued_writes`");
+		if (!result_set)
+		{
+			core->printLn("[ERROR] Failed to count the queued writes");
+			return false;
+		}
+		const bool count_valid(validateFieldInteger(result_set, 0, 2));
+		databasesComponent->freeResultSet(*result_set);
+		return count_valid;
+	}
+
+	/// Tests NULL values read as empty strings, and as null pointers in the legacy structure
+	/// @param databasesComponent Databases component
+	/// @param databaseConnection Database connection
+	/// @returns "true" if the test was successful, otherwise "false"
+	bool testNullValues(IDatabasesComponent* databasesComponent, IDatabaseConnection* databaseConnection)
+	{
+		IDatabaseResultSet* result_set(databaseConnection->executeQuery("SELECT NULL AS `null_value`, 'value' AS `value`"));
+		if (!result_set)
+		{
+			core->printLn("[ERROR] Failed to select NULL values");
+			return false;
+		}
+		bool ret(validateFieldString(result_set, 0, "") && validateFieldString(result_set, 1, "value"));
+		if (ret)
+		{
+			// The field names come first, then the values.
+			const LegacyDBResult& legacy_db_result(result_set->getLegacyDBResult());
+			ret = legacy_db_result.rows == 1 && legacy_db_result.columns == 2 && legacy_db_result.results[2] == nullptr && legacy_db_result.results[3] != nullptr;
+			if (!ret)
+			{
+				core->printLn("[ERROR] Legacy result NULL value: %p. Expected it to be a null pointer.", legacy_db_result.results[2]);
+			}
+		}
+		databasesComponent->freeResultSet(*result_set);
+		return ret;
+	}
+
+	/// Times queries of 1k, 10k and 100k rows, reading every field of every row by name
+	/// @param databasesComponent Databases component
+	/// @param databaseConnection Database connection
+	void benchmarkResultSets(IDatabasesComponent* databasesComponent, IDatabaseConnection* databaseConnection)
+	{
+		static const int row_counts[] = { 1000, 10000, 100000 };
+		for (int row_count : row_counts)
+		{
+			const std::string query("WITH RECURSIVE `rows`(`id`) AS (SELECT 1 UNION ALL SELECT `id` + 1 FROM `rows` WHERE `id` < " + std::to_string(row_count) + ") SELECT `id`, 'name ' || `id` AS `name`, `id` * 0.5 AS `score`, NULL AS `note` FROM `rows`");
+			const TimePoint start(Time::now());
+			IDatabaseResultSet* result_set(databaseConnection->executeQuery(query));
+			if (!result_set)
+			{
+				core->printLn("[ERROR] Failed to execute the %d row benchmark query", row_count);
+				return;
+			}
+			const TimePoint executed(Time::now());
+			double checksum(0.0);
+			do
+			{
+				checksum += result_set->getFieldIntByName("id") + result_set->getFieldStringByName("name").size() + result_set->getFieldFloatByName("score") + result_set->getFieldStringByName("note").size();
+			} while (result_set->selectNextRow());
+			const TimePoint read(Time::now());
+			const std::size_t rows_read(result_set->getRowCount());
+			databasesComponent->freeResultSet(*result_set);
+			core->printLn("Result set benchmark: %d rows, query %.2f ms, reading %.2f ms (%zu rows, %.0f)", row_count,
+				duration_cast<Microseconds>(executed - start).count() / 1000.0,
+				duration_cast<Microseconds>(read - executed).count() / 1000.0,
+				rows_read, checksum);
+		}
+	}
+
+	/// Validates the number of open statements
+	/// @param databasesComponent Databases component
+	/// @param expectedCount Expected number of statements
+	/// "true" if validation was successful, otherwise "false"
+	inline bool validateStatementCount(IDatabasesComponent* databasesComponent, std::size_t expectedCount)
+	{
+		const std::size_t statement_count(databasesComponent->getDatabaseStatementCount());
+		if (statement_count != expectedCount)
+		{
+			core->printLn("[ERROR] databases_component->getDatabaseStatementCount() returned \"%d\". Expected it to be \"%d\"", statement_count, expectedCount);
+			return false;
+		}
+		return true;
+	}
+
+	/// Validates the number of rows a statement returns
+	/// @param databasesComponent Databases component
+	/// @param statement Statement
+	/// @param expectedRowCount Expected row count
+	/// "true" if validation was successful, otherwise "false"
+	inline bool validateStatementRowCount(IDatabasesComponent* databasesComponent, IDatabaseStatement* statement, std::size_t expectedRowCount)
+	{
+		IDatabaseResultSet* result_set(statement->execute());
+		if (!result_set)
+		{
+			core->printLn("[ERROR] statement->execute() returned \"nullptr\".");
+			return false;
+		}
+		const std::size_t row_count(result_set->getRowCount());
+		databasesComponent->freeResultSet(*result_set);
+		if (row_count != expectedRowCount)
+		{
+			core->printLn("[ERROR] Statement row count: %d. Expected it to be \"%d\".", row_count, expectedRowCount);
+			return false;
+		}
+		return true;
+	}
+
+	/// Validates the string a statement returns in its only row
+	/// @param databasesComponent Databases component
+	/// @param statement Statement
+	/// @param expectedFieldString Expected field string
+	/// "true" if validation was successful, otherwise "false"
+	inline bool validateStatementString(IDatabasesComponent* databasesComponent, IDatabaseStatement* statement, const char* expectedFieldString)
+	{
+		IDatabaseResultSet* result_set(statement->execute());
+		if (!result_set)
+		{
+			core->printLn("[ERROR] statement->execute() returned \"nullptr\".");
+			return false;
+		}
+		bool ret(result_set->getRowCount() == 1);
+		if (ret)
+		{
+			ret = validateFieldStringByName(result_set, "test_string", expectedFieldString);
+		}
+		else
+		{
+			core->printLn("[ERROR] Statement row count: %d. Expected it to be \"1\".", result_set->getRowCount());
+		}
+		databasesComponent->freeResultSet(*result_set);
+		return ret;
+	}
+
 	/// Validates field name
 	/// @param databaseResultSet Database result set
 	/// @param fieldIndex Field index
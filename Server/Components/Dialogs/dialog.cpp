@@ -214,6 +214,7 @@ public:
 		core = c;
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
 		NetCode::RPC::OnPlayerDialogResponse::addEventHandler(*core, &dialogResponseHandler);
+		eventDispatcher.setProfiler(&core->getTickProfiler(), "PlayerDialogEventHandler");
 	}
 
 	void reset() override
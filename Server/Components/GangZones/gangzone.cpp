@@ -95,6 +95,7 @@ class GangZonesComponent final : public IGangZonesComponent, public PlayerConnec
 {
 private:
 	ICore* core = nullptr;
+	ILogger* logger = nullptr;
 	constexpr static const size_t Lower = 1;
 	constexpr static const size_t Upper = GANG_ZONE_POOL_SIZE * (PLAYER_POOL_SIZE + 1) + Lower;
 
@@ -117,10 +118,13 @@ public:
 	void onLoad(ICore* core) override
 	{
 		this->core = core;
+		logger = &core->getStructuredLogger().getLogger(getUID());
 		this->core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
 		this->core->getPlayers().getPlayerClickDispatcher().addEventHandler(this);
 		this->core->getPlayers().getPlayerUpdateDispatcher().addEventHandler(this);
 		this->core->getPlayers().getPoolEventDispatcher().addEventHandler(this);
+		eventDispatcher.setProfiler(&core->getTickProfiler(), "GangZoneEventHandler");
+		storage.getEventDispatcher().setProfiler(&core->getTickProfiler(), "GangZonePoolEventHandler");
 	}
 
 	~GangZonesComponent()
@@ -208,14 +212,14 @@ public:
 	{
 		if (pos.max.x < pos.min.x)
 		{
-			core->logLn(LogLevel::Warning, "Gangzone X co-ordinates %.2f and %.2f out of order, inverting.", pos.min.x, pos.max.x);
+			logger->logLn(LogLevel::Warning, "Gangzone X co-ordinates %.2f and %.2f out of order, inverting.", pos.min.x, pos.max.x);
 			auto tmp = pos.max.x;
 			pos.max.x = pos.min.x;
 			pos.min.x = tmp;
 		}
 		if (pos.max.y < pos.min.y)
 		{
-			core->logLn(LogLevel::Warning, "Gangzone Y co-ordinates %.2f and %.2f out of order, inverting.", pos.min.y, pos.max.y);
+			logger->logLn(LogLevel::Warning, "Gangzone Y co-ordinates %.2f and %.2f out of order, inverting.", pos.min.y, pos.max.y);
 			auto tmp = pos.max.y;
 			pos.max.y = pos.min.y;
 			pos.min.y = tmp;
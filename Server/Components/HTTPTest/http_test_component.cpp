@@ -0,0 +1,223 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include <Server/Components/Console/console.hpp>
+#include <fstream>
+#include <httplib.h>
+#include <sdk.hpp>
+#include <thread>
+
+/// Requests sent by `httpbench` when no count is given
+constexpr int defaultRequestCount = 1000;
+
+/// Get the number of threads the server process is running, 0 if it can't be read
+static int getThreadCount()
+{
+	std::ifstream status("/proc/self/status");
+	String line;
+	while (std::getline(status, line))
+	{
+		if (line.rfind("Threads:", 0) == 0)
+		{
+			return std::atoi(line.c_str() + 8);
+		}
+	}
+	return 0;
+}
+
+/// Benchmarks ICore::requestHTTP against a local server
+/// Run `httpbench [count]` in the console to send count requests and print the throughput and the most threads seen
+/// At most network.http_client_queue_size requests are in flight at once, the rest are sent as responses arrive
+struct HTTPTestComponent final : public IComponent, public ConsoleEventHandler, public HTTPResponseHandler, public NoCopy
+{
+	/// Core
+	ICore* core = nullptr;
+
+	/// Console
+	IConsoleComponent* console = nullptr;
+
+	/// Local server the requests are sent to
+	httplib::Server server;
+	std::thread serverThread;
+	int port = -1;
+
+	/// The running benchmark
+	String url;
+	int total = 0;
+	int sent = 0;
+	int received = 0;
+	int failed = 0;
+	int maxThreads = 0;
+	TimePoint start;
+
+	/// Gets the component UID
+	/// @returns Component UID
+	UID getUID() override
+	{
+		return 0x4A1D6F3E92B07C58;
+	}
+
+	/// Gets the component name
+	/// @returns Component name
+	StringView componentName() const override
+	{
+		return "HTTP test";
+	}
+
+	/// Gets the component type
+	/// @returns Component type
+	ComponentType componentType() const override
+	{
+		return ComponentType::Other;
+	}
+
+	/// Gets the component version
+	/// @returns Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(1, 0, 0, 0);
+	}
+
+	/// Called for every component after components have been loaded
+	/// @param c Core
+	void onLoad(ICore* c) override
+	{
+		core = c;
+	}
+
+	/// Called when all components have been initialised
+	/// @param components Component list to query
+	void onInit(IComponentList* components) override
+	{
+		console = components->queryComponent<IConsoleComponent>();
+		if (console)
+		{
+			console->getEventDispatcher().addEventHandler(this);
+		}
+	}
+
+	/// Called when a component is about to be unloaded
+	/// @param component Component
+	void onFree(IComponent* component) override
+	{
+		if (component == console)
+		{
+			console = nullptr;
+		}
+	}
+
+	bool onConsoleText(StringView command, StringView parameters, const ConsoleCommandSenderData& sender) override
+	{
+		if (command != "httpbench")
+		{
+			return false;
+		}
+
+		if (received != total)
+		{
+			core->printLn("[httpbench] %d of %d requests are still running", total - received, total);
+			return true;
+		}
+
+		if (port < 0 && !startServer())
+		{
+			core->printLn("[ERROR] [httpbench] Couldn't start the local server");
+			return true;
+		}
+
+		// Anything over the queue size would be dropped straight away and skew the throughput.
+		const int count = parameters.empty() ? defaultRequestCount : std::max(std::atoi(String(parameters).c_str()), 1);
+		const int window = std::min(count, std::max(*core->getConfig().getInt("network.http_client_queue_size"), 1));
+		url = "http://127.0.0.1:" + std::to_string(port) + "/bench";
+		total = count;
+		sent = 0;
+		received = 0;
+		failed = 0;
+		maxThreads = getThreadCount();
+		start = Time::now();
+		while (sent != window)
+		{
+			sendRequest();
+		}
+		maxThreads = std::max(maxThreads, getThreadCount());
+		core->printLn("[httpbench] Sending %d requests to %s, %d at a time", count, url.c_str(), window);
+		return true;
+	}
+
+	void onConsoleCommandListRequest(FlatHashSet<StringView>& commands) override
+	{
+		commands.emplace("httpbench");
+	}
+
+	void onHTTPResponse(int status, StringView body) override
+	{
+		++received;
+		if (status != 200 || body != "ok")
+		{
+			++failed;
+		}
+		maxThreads = std::max(maxThreads, getThreadCount());
+
+		if (sent != total)
+		{
+			sendRequest();
+		}
+		else if (received == total)
+		{
+			const float seconds = std::chrono::duration_cast<Microseconds>(Time::now() - start).count() / 1000000.f;
+			core->printLn("[httpbench] %d requests (%d failed) in %.3fs, %.1f requests/s, up to %d threads", received, failed, seconds, received / std::max(seconds, 0.000001f), maxThreads);
+		}
+	}
+
+	void sendRequest()
+	{
+		++sent;
+		core->requestHTTP(this, HTTPRequestType_Get, url, "");
+	}
+
+	bool startServer()
+	{
+		server.Get("/bench", [](const httplib::Request&, httplib::Response& res)
+			{
+				res.set_content("ok", "text/plain");
+			});
+		port = server.bind_to_any_port("127.0.0.1");
+		if (port < 0)
+		{
+			return false;
+		}
+		serverThread = std::thread([this]()
+			{
+				server.listen_after_bind();
+			});
+		return true;
+	}
+
+	void reset() override
+	{
+	}
+
+	void free() override
+	{
+		if (console)
+		{
+			console->getEventDispatcher().removeEventHandler(this);
+		}
+
+		if (serverThread.joinable())
+		{
+			server.stop();
+			serverThread.join();
+		}
+	}
+} httpTestComponent;
+
+COMPONENT_ENTRY_POINT()
+{
+	return &httpTestComponent;
+}
@@ -217,22 +217,22 @@ constexpr Span<char> getBuffer(Span<const char> input, std::unique_ptr<char[]>&
 	return Span<char>(buf, length);
 }
 
-struct LegacyConsoleMessageHandler : ConsoleMessageHandler
+struct LegacyConsoleMessageHandler : QueuedConsoleMessageHandler
 {
 	uint32_t sock;
-	const sockaddr_in& client;
-	Span<const char> packet;
+	sockaddr_in client;
+	StaticArray<char, BASE_QUERY_SIZE> packet;
 	int tolen;
 
 	LegacyConsoleMessageHandler(uint32_t sock, const sockaddr_in& client, int tolen, Span<const char> data)
 		: sock(sock)
 		, client(client)
-		, packet(data)
 		, tolen(tolen)
 	{
+		memcpy(packet.data(), data.data(), packet.size());
 	}
 
-	void handleConsoleMessage(StringView message)
+	void handleConsoleMessage(StringView message) override
 	{
 		const size_t dgramLen = packet.size() + sizeof(uint16_t) + message.length();
 		auto dgram = std::make_unique<char[]>(dgramLen);
@@ -242,6 +242,11 @@ struct LegacyConsoleMessageHandler : ConsoleMessageHandler
 		writeToBuffer(dgram.get(), message.data(), offset, message.length());
 		sendto(sock, dgram.get(), dgramLen, 0, reinterpret_cast<const sockaddr*>(&client), tolen);
 	}
+
+	void free() override
+	{
+		delete this;
+	}
 };
 
 void Query::handleRCON(Span<const char> buffer, uint32_t sock, const sockaddr_in& client, int tolen)
@@ -264,9 +269,9 @@ void Query::handleRCON(Span<const char> buffer, uint32_t sock, const sockaddr_in
 					{
 						if (subbuf.size() - offset == cmdLen)
 						{
+							// Queries arrive on the network thread, the console runs the command in the main thread and replies from there.
 							StringView cmd(&subbuf.data()[offset], cmdLen);
-							LegacyConsoleMessageHandler handler(sock, client, tolen, buffer.subspan(0, BASE_QUERY_SIZE));
-							console->send(cmd, ConsoleCommandSenderData(handler));
+							console->queue(cmd, new LegacyConsoleMessageHandler(sock, client, tolen, buffer.subspan(0, BASE_QUERY_SIZE)));
 						}
 					}
 					return;
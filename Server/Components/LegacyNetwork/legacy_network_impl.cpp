@@ -285,6 +285,7 @@ RakNetLegacyNetwork::RakNetLegacyNetwork()
 
 RakNetLegacyNetwork::~RakNetLegacyNetwork()
 {
+	capture.close();
 	if (core)
 	{
 		core->getEventDispatcher().removeEventHandler(this);
@@ -421,7 +422,7 @@ void RakNetLegacyNetwork::OnPlayerConnect(RakNet::RPCParameters* rpcParams, void
 		PeerAddress::AddressString addressString;
 		PeerAddress::ToString(address, addressString);
 
-		network->core->logLn(LogLevel::Warning, "Invalid client connecting from %.*s", int(addressString.length()), addressString.data());
+		network->logger->logLn(LogLevel::Warning, "Invalid client connecting from %.*s", int(addressString.length()), addressString.data());
 		network->rakNetServer.Kick(rpcParams->sender);
 		return;
 	}
@@ -433,23 +434,12 @@ void RakNetLegacyNetwork::OnPlayerConnect(RakNet::RPCParameters* rpcParams, void
 		return;
 	}
 
-	if (!network->inEventDispatcher.stopAtFalse(
-			[newPeer, &bs](NetworkInEventHandler* handler)
-			{
-				bs.resetReadPointer();
-				return handler->onReceiveRPC(*newPeer, NetCode::RPC::PlayerConnect::PacketID, bs);
-			}))
+	if (network->capture.isOpen())
 	{
-		return;
+		network->capture.write(newPeer->getID(), PacketCaptureKind_Connect, NetCode::RPC::PlayerConnect::PacketID, bs.GetData(), bs.GetNumberOfBytesUsed());
 	}
 
-	if (!network->rpcInEventDispatcher.stopAtFalse(
-			NetCode::RPC::PlayerConnect::PacketID,
-			[newPeer, &bs](SingleNetworkInEventHandler* handler)
-			{
-				bs.resetReadPointer();
-				return handler->onReceive(*newPeer, bs);
-			}))
+	if (!network->dispatchRPC(*newPeer, NetCode::RPC::PlayerConnect::PacketID, bs))
 	{
 		return;
 	}
@@ -478,23 +468,12 @@ void RakNetLegacyNetwork::OnNPCConnect(RakNet::RPCParameters* rpcParams, void* e
 			IPlayer* newPeer = network->OnPeerConnect(rpcParams, true, "", NPCConnectRPC.VersionNumber, "npc", NPCConnectRPC.ChallengeResponse, NPCConnectRPC.Name);
 			if (newPeer)
 			{
-				if (!network->inEventDispatcher.stopAtFalse(
-						[newPeer, &bs](NetworkInEventHandler* handler)
-						{
-							bs.resetReadPointer();
-							return handler->onReceiveRPC(*newPeer, NetCode::RPC::NPCConnect::PacketID, bs);
-						}))
+				if (network->capture.isOpen())
 				{
-					return;
+					network->capture.write(newPeer->getID(), PacketCaptureKind_Connect, NetCode::RPC::NPCConnect::PacketID, bs.GetData(), bs.GetNumberOfBytesUsed());
 				}
 
-				if (!network->rpcInEventDispatcher.stopAtFalse(
-						NetCode::RPC::NPCConnect::PacketID,
-						[newPeer, &bs](SingleNetworkInEventHandler* handler)
-						{
-							bs.resetReadPointer();
-							return handler->onReceive(*newPeer, bs);
-						}))
+				if (!network->dispatchRPC(*newPeer, NetCode::RPC::NPCConnect::PacketID, bs))
 				{
 					return;
 				}
@@ -540,30 +519,19 @@ void RakNetLegacyNetwork::RPCHook(RakNet::RPCParameters* rpcParams, void* extra)
 
 	NetworkBitStream bs = GetBitStream(*rpcParams);
 
-	if (!network->inEventDispatcher.stopAtFalse(
-			[&player, &bs](NetworkInEventHandler* handler)
-			{
-				bs.resetReadPointer();
-				return handler->onReceiveRPC(*player, ID, bs);
-			}))
+	if (network->capture.isOpen())
 	{
-		return;
+		network->capture.write(player->getID(), PacketCaptureKind_RPC, ID, bs.GetData(), bs.GetNumberOfBytesUsed());
 	}
 
-	if (!network->rpcInEventDispatcher.stopAtFalse(
-			ID,
-			[&player, &bs](SingleNetworkInEventHandler* handler)
-			{
-				bs.resetReadPointer();
-				return handler->onReceive(*player, bs);
-			}))
+	if (!network->dispatchRPC(*player, ID, bs))
 	{
 		return;
 	}
 #ifdef _DEBUG
 	if (network->inEventDispatcher.count() == 0 && network->rpcInEventDispatcher.count(ID) == 0)
 	{
-		network->core->logLn(LogLevel::Debug, "Received unprocessed RPC %zu", ID);
+		network->logger->logLn(LogLevel::Debug, "Received unprocessed RPC %zu", ID);
 	}
 #endif
 }
@@ -784,9 +752,10 @@ void RakNetLegacyNetwork::update()
 	rakNetServer.SetMTUSize(mtu);
 }
 
-void RakNetLegacyNetwork::init(ICore* c)
+void RakNetLegacyNetwork::init(ICore* c, ILogger* l)
 {
 	core = c;
+	logger = l;
 
 	core->getEventDispatcher().addEventHandler(this);
 	core->getPlayers().getPlayerChangeDispatcher().addEventHandler(this);
@@ -837,22 +806,22 @@ void RakNetLegacyNetwork::start()
 	{
 		if (!bind.empty())
 		{
-			core->logLn(LogLevel::Error, "Unable to start legacy network on %.*s:%d. Port in use?", PRINT_VIEW(bind), port);
+			logger->logLn(LogLevel::Error, "Unable to start legacy network on %.*s:%d. Port in use?", PRINT_VIEW(bind), port);
 		}
 		else
 		{
-			core->logLn(LogLevel::Error, "Unable to start legacy network on port %d. Port in use?", port);
+			logger->logLn(LogLevel::Error, "Unable to start legacy network on port %d. Port in use?", port);
 		}
 	}
 	else
 	{
 		if (!bind.empty())
 		{
-			core->logLn(LogLevel::Message, "Legacy Network started on %.*s:%d.", PRINT_VIEW(bind), port);
+			logger->logLn(LogLevel::Message, "Legacy Network started on %.*s:%d.", PRINT_VIEW(bind), port);
 		}
 		else
 		{
-			core->logLn(LogLevel::Message, "Legacy Network started on port %d", port);
+			logger->logLn(LogLevel::Message, "Legacy Network started on port %d", port);
 		}
 
 		// Do the request after network is started.
@@ -866,6 +835,19 @@ void RakNetLegacyNetwork::start()
 	rakNetServer.StartOccasionalPing();
 	SAMPRakNet::SetPort(port);
 
+	StringView captureFile = config.getString("network.capture_file");
+	if (!captureFile.empty())
+	{
+		if (startCapture(captureFile))
+		{
+			logger->logLn(LogLevel::Message, "Capturing incoming packets to %.*s", PRINT_VIEW(captureFile));
+		}
+		else
+		{
+			logger->logLn(LogLevel::Error, "Unable to open packet capture file %.*s", PRINT_VIEW(captureFile));
+		}
+	}
+
 	int* gracePeriod = config.getInt("network.grace_period");
 
 	if (gracePeriod)
@@ -891,22 +873,13 @@ void RakNetLegacyNetwork::onTick(Microseconds elapsed, TimePoint now)
 			uint8_t type;
 			if (bs.readUINT8(type))
 			{
-				// Call event handlers for packet receive
-				const bool res = inEventDispatcher.stopAtFalse([&player, type, &bs](NetworkInEventHandler* handler)
-					{
-						bs.SetReadOffset(8); // Ignore packet ID
-						return handler->onReceivePacket(*player, type, bs);
-					});
-
-				if (res)
+				if (capture.isOpen())
 				{
-					packetInEventDispatcher.stopAtFalse(type, [&player, &bs](SingleNetworkInEventHandler* handler)
-						{
-							bs.SetReadOffset(8); // Ignore packet ID
-							return handler->onReceive(*player, bs);
-						});
+					capture.write(player->getID(), PacketCaptureKind_Packet, type, pkt->data, pkt->length);
 				}
 
+				dispatchPacket(*player, type, bs);
+
 				if (type == RakNet::ID_DISCONNECTION_NOTIFICATION)
 				{
 					OnRakNetDisconnect(pkt->playerIndex, PeerDisconnectReason_Quit);
@@ -921,9 +894,242 @@ void RakNetLegacyNetwork::onTick(Microseconds elapsed, TimePoint now)
 		rakNetServer.DeallocatePacket(pkt);
 	}
 
+	if (isReplaying())
+	{
+		replayTick(now);
+	}
+	if (!replay.disconnecting.empty())
+	{
+		replayDisconnects();
+	}
+
 	if (now - lastCookieSeed > cookieSeedTime)
 	{
 		SAMPRakNet::SeedCookie();
 		lastCookieSeed = now;
 	}
 }
+
+bool RakNetLegacyNetwork::dispatchPacket(IPlayer& player, uint8_t type, NetworkBitStream& bs)
+{
+	// Call event handlers for packet receive
+	const bool res = inEventDispatcher.stopAtFalse([&player, type, &bs](NetworkInEventHandler* handler)
+		{
+			bs.SetReadOffset(8); // Ignore packet ID
+			return handler->onReceivePacket(player, type, bs);
+		});
+
+	if (!res)
+	{
+		return false;
+	}
+
+	return packetInEventDispatcher.stopAtFalse(type, [&player, &bs](SingleNetworkInEventHandler* handler)
+		{
+			bs.SetReadOffset(8); // Ignore packet ID
+			return handler->onReceive(player, bs);
+		});
+}
+
+bool RakNetLegacyNetwork::dispatchRPC(IPlayer& player, int id, NetworkBitStream& bs)
+{
+	if (!inEventDispatcher.stopAtFalse(
+			[&player, id, &bs](NetworkInEventHandler* handler)
+			{
+				bs.resetReadPointer();
+				return handler->onReceiveRPC(player, id, bs);
+			}))
+	{
+		return false;
+	}
+
+	return rpcInEventDispatcher.stopAtFalse(
+		id,
+		[&player, &bs](SingleNetworkInEventHandler* handler)
+		{
+			bs.resetReadPointer();
+			return handler->onReceive(player, bs);
+		});
+}
+
+bool RakNetLegacyNetwork::startCapture(StringView name)
+{
+	ghc::filesystem::path path;
+	return getPacketCapturePath(name, path) && capture.open(path);
+}
+
+size_t RakNetLegacyNetwork::stopCapture()
+{
+	capture.close();
+	return capture.records();
+}
+
+bool RakNetLegacyNetwork::startReplay(StringView name, float speed)
+{
+	stopReplay();
+	ghc::filesystem::path path;
+	if (!getPacketCapturePath(name, path) || !replay.reader.open(path))
+	{
+		return false;
+	}
+
+	replay.speed = speed > 0.f ? speed : 1.f;
+	replay.start = Time::now();
+	replay.records = 0;
+	if (!replay.reader.next(replay.record))
+	{
+		replay.reader.close();
+		return false;
+	}
+	return true;
+}
+
+size_t RakNetLegacyNetwork::stopReplay()
+{
+	replay.reader.close();
+
+	// Copied as disconnecting removes the player from the map.
+	const FlatHashMap<int, IPlayer*> players = replay.players;
+	replay.players.clear();
+	for (auto& it : players)
+	{
+		networkEventDispatcher.dispatch(&NetworkEventHandler::onPeerDisconnect, *it.second, PeerDisconnectReason_Quit);
+	}
+	return replay.records;
+}
+
+void RakNetLegacyNetwork::replayTick(TimePoint now)
+{
+	const float elapsed = duration_cast<Microseconds>(now - replay.start).count() / 1000.f * replay.speed;
+	while (replay.record.time <= elapsed)
+	{
+		replayRecord(replay.record);
+		++replay.records;
+		if (!replay.reader.next(replay.record))
+		{
+			logger->logLn(LogLevel::Message, "Replayed %zu captured messages", replay.records);
+			stopReplay();
+			break;
+		}
+	}
+}
+
+void RakNetLegacyNetwork::replayDisconnects()
+{
+	// Copied as disconnecting removes the player from the set.
+	const FlatPtrHashSet<IPlayer> players = replay.disconnecting;
+	replay.disconnecting.clear();
+	for (IPlayer* player : players)
+	{
+		// An earlier disconnect in this loop may have taken this player with it.
+		if (replay.peers.find(player) != replay.peers.end())
+		{
+			networkEventDispatcher.dispatch(&NetworkEventHandler::onPeerDisconnect, *player, PeerDisconnectReason_Kicked);
+		}
+	}
+}
+
+void RakNetLegacyNetwork::replayRecord(PacketCaptureRecord& record)
+{
+	NetworkBitStream bs(record.data.data(), record.data.size(), false);
+
+	if (record.kind == PacketCaptureKind_Connect)
+	{
+		// The captured player's slot was reused without a recorded disconnect.
+		auto it = replay.players.find(record.player);
+		if (it != replay.players.end())
+		{
+			IPlayer* stale = it->second;
+			replay.players.erase(it);
+			networkEventDispatcher.dispatch(&NetworkEventHandler::onPeerDisconnect, *stale, PeerDisconnectReason_Quit);
+		}
+
+		PeerRequestParams params {};
+		params.bot = record.id == NetCode::RPC::NPCConnect::PacketID;
+		if (params.bot)
+		{
+			NetCode::RPC::NPCConnect connectRPC;
+			if (!connectRPC.read(bs))
+			{
+				return;
+			}
+			params.version = ClientVersion::ClientVersion_SAMP_037;
+			params.versionName = "npc";
+			params.name = connectRPC.Name;
+		}
+		else
+		{
+			NetCode::RPC::PlayerConnect connectRPC;
+			if (!connectRPC.read(bs))
+			{
+				return;
+			}
+			params.version = connectRPC.VersionNumber == LegacyClientVersion_03DL ? ClientVersion::ClientVersion_SAMP_03DL : ClientVersion::ClientVersion_SAMP_037;
+			params.versionName = connectRPC.VersionString;
+			params.name = connectRPC.Name;
+			params.isUsingOfficialClient = connectRPC.IsUsingOfficialClient;
+		}
+
+		// Give each synthetic player its own address in 10.0.0.0/8 so per-address limits treat them as different hosts.
+		const uint32_t address = 0x0A000001 + replay.nextAddress++;
+		const uint8_t addressBytes[4] = { uint8_t(address >> 24), uint8_t(address >> 16), uint8_t(address >> 8), uint8_t(address) };
+		PeerNetworkData netData {};
+		netData.networkID.address.ipv6 = false;
+		memcpy(&netData.networkID.address.v4, addressBytes, sizeof(addressBytes));
+		netData.networkID.port = 0;
+		netData.network = this;
+
+		Pair<NewConnectionResult, IPlayer*> result = core->getPlayers().requestPlayer(netData, params);
+		if (result.first != NewConnectionResult_Success)
+		{
+			return;
+		}
+
+		IPlayer* player = result.second;
+		replay.players[record.player] = player;
+		replay.peers.insert(player);
+		bs.resetReadPointer();
+		if (dispatchRPC(*player, record.id, bs))
+		{
+			networkEventDispatcher.dispatch(&NetworkEventHandler::onPeerConnect, *player);
+		}
+		return;
+	}
+
+	auto it = replay.players.find(record.player);
+	if (it == replay.players.end())
+	{
+		return;
+	}
+	IPlayer* player = it->second;
+
+	switch (record.kind)
+	{
+	case PacketCaptureKind_Packet:
+	{
+		uint8_t type;
+		if (bs.readUINT8(type))
+		{
+			dispatchPacket(*player, type, bs);
+		}
+		break;
+	}
+	case PacketCaptureKind_RPC:
+		dispatchRPC(*player, record.id, bs);
+		break;
+	case PacketCaptureKind_Disconnect:
+		replay.players.erase(it);
+		if (record.id == PeerDisconnectReason_Timeout || record.id == PeerDisconnectReason_Quit)
+		{
+			networkEventDispatcher.dispatch(&NetworkEventHandler::onPeerDisconnect, *player, PeerDisconnectReason(record.id));
+		}
+		else
+		{
+			// The server removed them, which it may not have done again if the replay diverged.
+			player->kick();
+		}
+		break;
+	default:
+		break;
+	}
+}
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Query/query.hpp"
+#include "packet_capture.hpp"
 #include <Impl/network_impl.hpp>
 #include <bitstream.hpp>
 #include <core.hpp>
@@ -35,6 +36,7 @@ class RakNetLegacyNetwork final : public Network, public CoreEventHandler, publi
 {
 private:
 	ICore* core = nullptr;
+	ILogger* logger = nullptr;
 	Query query;
 	RakNet::RakServerInterface& rakNetServer;
 	std::array<IPlayer*, PLAYER_POOL_SIZE> playerFromRakIndex;
@@ -42,6 +44,38 @@ private:
 	Milliseconds cookieSeedTime;
 	TimePoint lastCookieSeed;
 
+	/// Incoming messages are written here while capturing
+	PacketCaptureWriter capture;
+
+	/// The capture being replayed by synthetic players
+	struct Replay
+	{
+		PacketCaptureReader reader;
+		PacketCaptureRecord record;
+		float speed = 1.f;
+		TimePoint start;
+		/// The replayed players by the ID they had when captured
+		FlatHashMap<int, IPlayer*> players;
+		/// Every synthetic player still in the pool, including those no longer in the capture
+		FlatPtrHashSet<IPlayer> peers;
+		/// Synthetic players kicked since the last update, as there's no connection to drop and report back
+		FlatPtrHashSet<IPlayer> disconnecting;
+		uint32_t nextAddress = 0;
+		size_t records = 0;
+	} replay;
+
+	/// Dispatch a received packet, its data starting with the packet ID
+	/// @return false if a handler dropped it
+	bool dispatchPacket(IPlayer& player, uint8_t type, NetworkBitStream& bs);
+
+	/// Dispatch a received RPC
+	/// @return false if a handler dropped it
+	bool dispatchRPC(IPlayer& player, int id, NetworkBitStream& bs);
+
+	void replayTick(TimePoint now);
+	void replayRecord(PacketCaptureRecord& record);
+	void replayDisconnects();
+
 public:
 	inline void setQueryConsole(IConsoleComponent* console)
 	{
@@ -56,6 +90,35 @@ public:
 	RakNetLegacyNetwork();
 	~RakNetLegacyNetwork();
 
+	/// Start writing every incoming packet and RPC to a capture file
+	/// Captures hold everything players send in plain text, RCON logins and dialog responses with passwords included
+	/// @param name The file in the capture directory, which can't be absolute or contain ".."
+	bool startCapture(StringView name);
+
+	/// Stop capturing
+	/// @return The number of records captured
+	size_t stopCapture();
+
+	bool isCapturing() const
+	{
+		return capture.isOpen();
+	}
+
+	/// Replay a capture with synthetic players that have no connection, feeding their messages to the handlers as if
+	/// they'd been received
+	/// @param name The file in the capture directory, which can't be absolute or contain ".."
+	/// @param speed How many times faster than captured to replay
+	bool startReplay(StringView name, float speed);
+
+	/// Stop replaying and disconnect the synthetic players
+	/// @return The number of records replayed
+	size_t stopReplay();
+
+	bool isReplaying() const
+	{
+		return replay.reader.isOpen();
+	}
+
 	IExtension* getExtension(UID id) override
 	{
 		if (id == INetworkQueryExtension::ExtensionIID)
@@ -78,6 +141,14 @@ public:
 			return;
 		}
 
+		// Synthetic players have no connection for RakNet to drop, so report them gone on the next update instead.
+		IPlayer* replayed = const_cast<IPlayer*>(&peer);
+		if (replay.peers.find(replayed) != replay.peers.end())
+		{
+			replay.disconnecting.insert(replayed);
+			return;
+		}
+
 		const PeerNetworkData::NetworkID& nid = netData.networkID;
 		const RakNet::PlayerID rid { unsigned(nid.address.v4), nid.port };
 
@@ -286,7 +357,7 @@ public:
 	template <size_t ID>
 	static void RPCHook(RakNet::RPCParameters* rpcParams, void* extra);
 	void onTick(Microseconds elapsed, TimePoint now) override;
-	void init(ICore* core);
+	void init(ICore* core, ILogger* logger);
 	void start();
 
 	void OnRakNetDisconnect(RakNet::PlayerIndex rid, PeerDisconnectReason reason);
@@ -311,6 +382,26 @@ public:
 	void onPlayerDisconnect(IPlayer& player, PeerDisconnectReason reason) override
 	{
 		query.buildPlayerDependentBuffers(&player);
+
+		// Recorded here rather than on the network disconnect so kicks are captured too.
+		if (capture.isOpen() && player.getNetworkData().network == this)
+		{
+			capture.write(player.getID(), PacketCaptureKind_Disconnect, reason, nullptr, 0);
+		}
+
+		// A replayed player can leave the pool before the capture says so, whether kicked or not.
+		if (replay.peers.erase(&player))
+		{
+			replay.disconnecting.erase(&player);
+			for (auto it = replay.players.begin(); it != replay.players.end(); ++it)
+			{
+				if (it->second == &player)
+				{
+					replay.players.erase(it);
+					break;
+				}
+			}
+		}
 	}
 
 	bool addRule(StringView rule, StringView value) override
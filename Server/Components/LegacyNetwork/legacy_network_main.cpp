@@ -7,17 +7,20 @@
  */
 
 #include "legacy_network_impl.hpp"
+#include <cstdlib>
 #include <sdk.hpp>
 
-class RakNetLegacyNetworkComponent final : public INetworkComponent
+class RakNetLegacyNetworkComponent final : public INetworkComponent, public ConsoleEventHandler
 {
 private:
 	RakNetLegacyNetwork legacyNetwork;
+	IConsoleComponent* console = nullptr;
 
 public:
 	void onLoad(ICore* core) override
 	{
-		legacyNetwork.init(core);
+		legacyNetwork.init(core, &core->getStructuredLogger().getLogger(getUID()));
+		legacyNetwork.setProfiler(&core->getTickProfiler());
 	}
 
 	void onReady() override
@@ -27,15 +30,94 @@ public:
 
 	void onInit(IComponentList* components) override
 	{
-		legacyNetwork.setQueryConsole(components->queryComponent<IConsoleComponent>());
+		console = components->queryComponent<IConsoleComponent>();
+		legacyNetwork.setQueryConsole(console);
+		if (console)
+		{
+			console->getEventDispatcher().addEventHandler(this);
+		}
 	}
 
 	void onFree(IComponent* component) override
 	{
-		if (component == legacyNetwork.getQueryConsole())
+		if (component == console)
 		{
 			legacyNetwork.setQueryConsole(nullptr);
+			console = nullptr;
+		}
+	}
+
+	bool onConsoleText(StringView command, StringView parameters, const ConsoleCommandSenderData& sender) override
+	{
+		if (command == "netcapture")
+		{
+			if (parameters.empty())
+			{
+				console->sendMessage(sender, legacyNetwork.isCapturing() ? "Capturing incoming packets, use \"netcapture stop\" to stop." : "Usage: netcapture <file in captures/> | stop");
+			}
+			else if (parameters == "stop")
+			{
+				const size_t records = legacyNetwork.stopCapture();
+				console->sendMessage(sender, "Captured " + std::to_string(records) + " messages.");
+			}
+			else if (legacyNetwork.startCapture(parameters))
+			{
+				console->sendMessage(sender, "Capturing incoming packets to captures/" + String(parameters) + ".");
+			}
+			else
+			{
+				console->sendMessage(sender, "Unable to open " + String(parameters) + ".");
+			}
+			return true;
+		}
+
+		if (command == "netreplay")
+		{
+			if (parameters.empty())
+			{
+				console->sendMessage(sender, legacyNetwork.isReplaying() ? "Replaying a capture, use \"netreplay stop\" to stop." : "Usage: netreplay <file in captures/> [speed] | stop");
+			}
+			else if (parameters == "stop")
+			{
+				const size_t records = legacyNetwork.stopReplay();
+				console->sendMessage(sender, "Replayed " + std::to_string(records) + " messages.");
+			}
+			else
+			{
+				StringView file = parameters;
+				float speed = 1.f;
+				const size_t split = parameters.find_last_of(' ');
+				if (split != StringView::npos)
+				{
+					char* end = nullptr;
+					const String speedText(parameters.substr(split + 1));
+					const float value = std::strtof(speedText.c_str(), &end);
+					if (end != speedText.c_str() && *end == '\0')
+					{
+						file = parameters.substr(0, split);
+						speed = value;
+					}
+				}
+
+				if (legacyNetwork.startReplay(file, speed))
+				{
+					console->sendMessage(sender, "Replaying " + String(file) + ".");
+				}
+				else
+				{
+					console->sendMessage(sender, "Unable to replay " + String(file) + ", it isn't a packet capture.");
+				}
+			}
+			return true;
 		}
+
+		return false;
+	}
+
+	void onConsoleCommandListRequest(FlatHashSet<StringView>& commands) override
+	{
+		commands.emplace("netcapture");
+		commands.emplace("netreplay");
 	}
 
 	INetwork* getNetwork() override
@@ -63,6 +145,14 @@ public:
 		delete this;
 	}
 
+	~RakNetLegacyNetworkComponent()
+	{
+		if (console)
+		{
+			console->getEventDispatcher().removeEventHandler(this);
+		}
+	}
+
 	void reset() override
 	{
 		// Nothing to reset here.
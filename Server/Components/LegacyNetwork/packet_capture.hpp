@@ -0,0 +1,219 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <ghc/filesystem.hpp>
+#include <types.hpp>
+
+using namespace Impl;
+
+/// Capture files start with this, followed by a little endian uint16_t version
+constexpr char PacketCaptureMagic[6] = { 'O', 'M', 'P', 'C', 'A', 'P' };
+constexpr uint16_t PacketCaptureVersion = 1;
+
+/// Captures are only read from and written to this directory, relative to the server
+constexpr const char* PacketCaptureDirectory = "captures";
+
+/// Larger messages aren't captured, and a record claiming to be larger means the file is corrupt
+constexpr uint32_t PacketCaptureMaxLength = 64 * 1024;
+
+/// Resolve a capture name to a file in the capture directory, creating the directory if needed
+/// @return false if the name is empty, absolute or tries to leave the capture directory
+inline bool getPacketCapturePath(StringView name, ghc::filesystem::path& path)
+{
+	const ghc::filesystem::path relative(String(name).c_str());
+	if (relative.empty() || relative.has_root_path())
+	{
+		return false;
+	}
+	for (const ghc::filesystem::path& part : relative)
+	{
+		if (part == "..")
+		{
+			return false;
+		}
+	}
+
+	const ghc::filesystem::path directory = ghc::filesystem::absolute(PacketCaptureDirectory);
+	if (!ghc::filesystem::exists(directory) || !ghc::filesystem::is_directory(directory))
+	{
+		ghc::filesystem::create_directory(directory);
+	}
+	path = directory / relative;
+	return true;
+}
+
+/// What a captured record holds
+enum PacketCaptureKind : uint8_t
+{
+	PacketCaptureKind_Packet, ///< A packet, its data starting with the packet ID
+	PacketCaptureKind_RPC, ///< An RPC's data
+	PacketCaptureKind_Connect, ///< The PlayerConnect or NPCConnect RPC that made a player
+	PacketCaptureKind_Disconnect, ///< A player left, the ID is the PeerDisconnectReason
+};
+
+/// One incoming message
+/// Stored as a 12 byte little endian header - time, player, kind, ID and data length - followed by the data
+struct PacketCaptureRecord
+{
+	uint32_t time; ///< Milliseconds since the capture started
+	uint16_t player; ///< The sender's player ID when captured
+	PacketCaptureKind kind;
+	uint8_t id; ///< The packet or RPC ID
+	DynamicArray<uint8_t> data;
+};
+
+/// Appends incoming messages to a capture file through a large stdio buffer
+class PacketCaptureWriter final : public NoCopy
+{
+public:
+	~PacketCaptureWriter()
+	{
+		close();
+	}
+
+	bool open(const ghc::filesystem::path& path)
+	{
+		close();
+		file_ = ::fopen(path.string().c_str(), "wb");
+		if (file_ == nullptr)
+		{
+			return false;
+		}
+		::setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+		::fwrite(PacketCaptureMagic, sizeof(PacketCaptureMagic), 1, file_);
+		::fwrite(&PacketCaptureVersion, sizeof(PacketCaptureVersion), 1, file_);
+		start_ = Time::now();
+		records_ = 0;
+		return true;
+	}
+
+	void close()
+	{
+		if (file_)
+		{
+			::fclose(file_);
+			file_ = nullptr;
+		}
+	}
+
+	bool isOpen() const
+	{
+		return file_ != nullptr;
+	}
+
+	size_t records() const
+	{
+		return records_;
+	}
+
+	void write(int player, PacketCaptureKind kind, uint8_t id, const void* data, size_t length)
+	{
+		if (length > PacketCaptureMaxLength)
+		{
+			return;
+		}
+
+		uint8_t header[12];
+		const uint32_t time = duration_cast<Milliseconds>(Time::now() - start_).count();
+		const uint16_t playerID = player;
+		const uint32_t dataLength = length;
+		memcpy(&header[0], &time, sizeof(time));
+		memcpy(&header[4], &playerID, sizeof(playerID));
+		header[6] = kind;
+		header[7] = id;
+		memcpy(&header[8], &dataLength, sizeof(dataLength));
+		::fwrite(header, sizeof(header), 1, file_);
+		if (length)
+		{
+			::fwrite(data, length, 1, file_);
+		}
+		++records_;
+	}
+
+private:
+	FILE* file_ = nullptr;
+	TimePoint start_;
+	size_t records_ = 0;
+};
+
+/// Reads the records of a capture file in order
+class PacketCaptureReader final : public NoCopy
+{
+public:
+	~PacketCaptureReader()
+	{
+		close();
+	}
+
+	/// @return false if the file can't be opened or isn't a capture of a supported version
+	bool open(const ghc::filesystem::path& path)
+	{
+		close();
+		file_ = ::fopen(path.string().c_str(), "rb");
+		if (file_ == nullptr)
+		{
+			return false;
+		}
+
+		char magic[sizeof(PacketCaptureMagic)];
+		uint16_t version;
+		if (::fread(magic, sizeof(magic), 1, file_) != 1 || memcmp(magic, PacketCaptureMagic, sizeof(magic)) != 0 || ::fread(&version, sizeof(version), 1, file_) != 1 || version != PacketCaptureVersion)
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void close()
+	{
+		if (file_)
+		{
+			::fclose(file_);
+			file_ = nullptr;
+		}
+	}
+
+	bool isOpen() const
+	{
+		return file_ != nullptr;
+	}
+
+	/// Read the next record, reusing its data buffer
+	/// @return false at the end of the file or a truncated or corrupt record
+	bool next(PacketCaptureRecord& record)
+	{
+		uint8_t header[12];
+		if (::fread(header, sizeof(header), 1, file_) != 1)
+		{
+			return false;
+		}
+
+		uint16_t player;
+		uint32_t length;
+		memcpy(&record.time, &header[0], sizeof(record.time));
+		memcpy(&player, &header[4], sizeof(player));
+		record.player = player;
+		record.kind = PacketCaptureKind(header[6]);
+		record.id = header[7];
+		memcpy(&length, &header[8], sizeof(length));
+		if (length > PacketCaptureMaxLength)
+		{
+			return false;
+		}
+		record.data.resize(length);
+		return length == 0 || ::fread(record.data.data(), length, 1, file_) == 1;
+	}
+
+private:
+	FILE* file_ = nullptr;
+};
@@ -0,0 +1,841 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include <Impl/network_impl.hpp>
+#include <Server/Components/Console/console.hpp>
+#include <Server/Components/Objects/objects.hpp>
+#include <Server/Components/Vehicles/vehicles.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <netcode.hpp>
+#include <sdk.hpp>
+
+using namespace Impl;
+
+/// Ticks after the players join before measuring, so the connection and stream in burst isn't counted
+constexpr Milliseconds WarmupTime = Seconds(3);
+
+/// How often a virtual player sends each kind of sync, close to the default client rates
+constexpr float FootSyncInterval = 30.f;
+constexpr float VehicleSyncInterval = 30.f;
+constexpr float AimSyncInterval = 100.f;
+constexpr float BulletSyncInterval = 1000.f;
+
+/// A scripted load, run with `loadtest <name> [players] [seconds]`
+struct LoadTestScenario
+{
+	StringView name;
+	int players; ///< The number of virtual players when none is given
+	int vehicles; ///< Vehicles created for the players to drive, players without one go on foot
+	int objects; ///< Objects created around the players' paths
+};
+
+static const LoadTestScenario Scenarios[] = {
+	{ "stadium", 1000, 0, 0 }, // Everyone running laps in view of each other, aiming and shooting
+	{ "highway", 500, 500, 0 }, // A driver in every vehicle, in lanes going both ways
+	{ "objects", 200, 0, 2000 }, // Players walking across a large object map
+};
+
+/// A virtual player and where it is on its path
+struct LoadTestPlayer
+{
+	IPlayer* player = nullptr;
+	bool disconnecting = false;
+	int index = 0;
+	IVehicle* vehicle = nullptr;
+
+	/// Milliseconds into the run when each sync is due next
+	float nextFootSync = 0.f;
+	float nextAimSync = 0.f;
+	float nextBulletSync = 0.f;
+};
+
+class LoadTestComponent;
+
+/// The virtual players' network, their sync is injected as if they sent it and what the server sends them is only counted
+class LoadTestNetwork final : public Network
+{
+private:
+	LoadTestComponent& component;
+
+public:
+	/// Bytes sent to all the virtual players, without any transport overhead
+	uint64_t bytesSent = 0;
+	/// Virtual players connected, to count broadcasts
+	size_t peers = 0;
+
+	LoadTestNetwork(LoadTestComponent& component)
+		: Network(256, 256)
+		, component(component)
+	{
+	}
+
+	ENetworkType getNetworkType() const override
+	{
+		return ENetworkType_LoadTest;
+	}
+
+	bool sendPacket(IPlayer& peer, Span<uint8_t> data, int channel, bool dispatchEvents) override
+	{
+		if (peer.getNetworkData().network != this)
+		{
+			return false;
+		}
+		// Spans hold bits.
+		bytesSent += (data.size() + 7) / 8;
+		return true;
+	}
+
+	bool broadcastPacket(Span<uint8_t> data, int channel, const IPlayer* exceptPeer, bool dispatchEvents) override
+	{
+		countBroadcast(data, 0, exceptPeer);
+		return true;
+	}
+
+	bool sendRPC(IPlayer& peer, int id, Span<uint8_t> data, int channel, bool dispatchEvents) override
+	{
+		if (id == INVALID_PACKET_ID || peer.getNetworkData().network != this)
+		{
+			return false;
+		}
+		// The RPC's ID goes before its data.
+		bytesSent += 1 + (data.size() + 7) / 8;
+		return true;
+	}
+
+	bool broadcastRPC(int id, Span<uint8_t> data, int channel, const IPlayer* exceptPeer, bool dispatchEvents) override
+	{
+		if (id == INVALID_PACKET_ID)
+		{
+			return false;
+		}
+		countBroadcast(data, 1, exceptPeer);
+		return true;
+	}
+
+	NetworkStats getStatistics(IPlayer* player = nullptr) override
+	{
+		return NetworkStats {};
+	}
+
+	unsigned getPing(const IPlayer& peer) override
+	{
+		return 0;
+	}
+
+	void disconnect(const IPlayer& peer) override;
+
+	void ban(const BanEntry& entry, Milliseconds expire = Milliseconds(0)) override
+	{
+	}
+
+	void unban(const BanEntry& entry) override
+	{
+	}
+
+	void update() override
+	{
+	}
+
+	/// Pass a packet from a virtual player to the handlers, like a network does when it receives one
+	void receivePacket(IPlayer& peer, int type, NetworkBitStream& bs)
+	{
+		const bool res = inEventDispatcher.stopAtFalse([&peer, type, &bs](NetworkInEventHandler* handler)
+			{
+				bs.SetReadOffset(8); // Ignore packet ID
+				return handler->onReceivePacket(peer, type, bs);
+			});
+
+		if (res)
+		{
+			packetInEventDispatcher.stopAtFalse(type, [&peer, &bs](SingleNetworkInEventHandler* handler)
+				{
+					bs.SetReadOffset(8); // Ignore packet ID
+					return handler->onReceive(peer, bs);
+				});
+		}
+	}
+
+	/// Pass an RPC from a virtual player to the handlers
+	void receiveRPC(IPlayer& peer, int id, NetworkBitStream& bs)
+	{
+		const bool res = inEventDispatcher.stopAtFalse([&peer, id, &bs](NetworkInEventHandler* handler)
+			{
+				bs.resetReadPointer();
+				return handler->onReceiveRPC(peer, id, bs);
+			});
+
+		if (res)
+		{
+			rpcInEventDispatcher.stopAtFalse(id, [&peer, &bs](SingleNetworkInEventHandler* handler)
+				{
+					bs.resetReadPointer();
+					return handler->onReceive(peer, bs);
+				});
+		}
+	}
+
+	void dispatchConnect(IPlayer& peer)
+	{
+		++peers;
+		networkEventDispatcher.dispatch(&NetworkEventHandler::onPeerConnect, peer);
+	}
+
+	void dispatchDisconnect(IPlayer& peer)
+	{
+		--peers;
+		networkEventDispatcher.dispatch(&NetworkEventHandler::onPeerDisconnect, peer, PeerDisconnectReason_Quit);
+	}
+
+private:
+	/// Count a broadcast once for every virtual player it goes to
+	void countBroadcast(Span<uint8_t> data, size_t headerBytes, const IPlayer* exceptPeer)
+	{
+		const size_t except = exceptPeer && exceptPeer->getNetworkData().network == this ? 1 : 0;
+		const uint64_t receivers = peers > except ? peers - except : 0;
+		bytesSent += (headerBytes + (data.size() + 7) / 8) * receivers;
+	}
+};
+
+/// Benchmarks the server's tick with virtual players connected through an in-process network
+/// Run `loadtest <stadium|highway|objects> [players] [seconds]` in the console, or set loadtest.run to a semicolon separated
+/// list of scenarios to run them once the server is ready and exit after the last one, which is how CI runs it.
+/// Commas work in config.json too, but `--config` splits its values on commas so they can't be used there.
+/// Each run prints the tick time percentiles, the bytes sent per player per second and the heap allocations per tick.
+class LoadTestComponent final : public INetworkComponent, public CoreEventHandler, public ConsoleEventHandler, public NoCopy
+{
+private:
+	ICore* core = nullptr;
+	IConsoleComponent* console = nullptr;
+	IVehiclesComponent* vehicles = nullptr;
+	IObjectsComponent* objects = nullptr;
+	LoadTestNetwork network;
+
+	StaticArray<LoadTestPlayer, PLAYER_POOL_SIZE> players;
+	uint16_t nextPort = 0;
+
+	/// Scenarios left to run from loadtest.run, and whether to exit once they're done
+	DynamicArray<const LoadTestScenario*> queued;
+	bool exitWhenDone = false;
+	int seconds = 30;
+
+	/// The running scenario
+	const LoadTestScenario* scenario = nullptr;
+	int playerCount = 0;
+	Milliseconds duration;
+	TimePoint start;
+	bool measuring = false;
+	TimePoint measureStart;
+	uint64_t measureBytes = 0;
+	uint64_t measureAllocations = 0;
+	unsigned measureTicks = 0;
+	DynamicArray<int> vehicleIDs;
+	DynamicArray<int> objectIDs;
+
+	static const LoadTestScenario* findScenario(StringView name)
+	{
+		for (const LoadTestScenario& scenario : Scenarios)
+		{
+			if (scenario.name == name)
+			{
+				return &scenario;
+			}
+		}
+		return nullptr;
+	}
+
+	/// Get where a player is on its path, facing the way it's going
+	void getPath(const LoadTestPlayer& data, float clock, Vector3& position, Vector3& velocity, float& angle) const
+	{
+		const float t = clock / 1000.f;
+		const int i = data.index;
+		if (scenario == &Scenarios[0])
+		{
+			// Ten rings of runners round the middle of the pitch, all of them in stream distance.
+			const float radius = 20.f + 4.f * (i % 10);
+			const float speed = 6.f;
+			const float theta = i * 2.39996f + t * speed / radius;
+			position = Vector3(radius * std::cos(theta), radius * std::sin(theta), 3.f);
+			velocity = Vector3(-std::sin(theta), std::cos(theta), 0.f) * (speed / 50.f); // Velocity is in game units
+			angle = glm::degrees(theta);
+		}
+		else if (scenario == &Scenarios[1])
+		{
+			// Eight lanes of a 2km road, wrapping at the ends, the odd lanes going the other way.
+			const float length = 2000.f;
+			const int lane = i % 8;
+			const float speed = lane % 2 ? -30.f : 30.f;
+			const float spacing = length * 8 / std::max(playerCount, 1);
+			const float x = std::fmod(i / 8 * spacing + t * std::abs(speed), length);
+			position = Vector3(lane % 2 ? length / 2 - x : x - length / 2, -14.f + lane * 4.f, 5.f);
+			velocity = Vector3(speed / 50.f, 0.f, 0.f);
+			angle = speed > 0.f ? 270.f : 90.f;
+		}
+		else
+		{
+			// Walking back and forth across the object grid, each player on their own row.
+			const float size = 900.f;
+			const float speed = 2.f;
+			const float d = std::fmod(i * 37.f + t * speed, size * 2);
+			const float x = d < size ? d : size * 2 - d;
+			position = Vector3(x - size / 2, size * i / std::max(playerCount, 1) - size / 2, 3.f);
+			velocity = Vector3(d < size ? speed : -speed, 0.f, 0.f) / 50.f;
+			angle = d < size ? 270.f : 90.f;
+		}
+	}
+
+	void sendFootSync(LoadTestPlayer& data, float clock)
+	{
+		Vector3 position, velocity;
+		float angle;
+		getPath(data, clock, position, velocity, angle);
+
+		// Written the way clients send it, which is what the handlers read.
+		NetworkBitStream bs;
+		bs.writeUINT8(NetCode::Packet::PlayerFootSync::PacketID);
+		bs.writeUINT16(0); // Left and right
+		bs.writeUINT16(uint16_t(-128)); // Forward
+		bs.writeUINT16(Key::SPRINT);
+		bs.Write(position);
+		bs.Write(GTAQuat(0.f, 0.f, angle).q);
+		bs.writeUINT8(100); // Health
+		bs.writeUINT8(0); // Armour
+		bs.writeUINT8(PlayerWeapon_M4);
+		bs.writeUINT8(SpecialAction_None);
+		bs.Write(velocity);
+		bs.Write(Vector3(0.f, 0.f, 0.f)); // Surfing offset
+		bs.writeUINT16(0); // Surfing ID
+		bs.writeUINT16(1231); // Running animation
+		bs.writeUINT16(4356);
+		network.receivePacket(*data.player, NetCode::Packet::PlayerFootSync::PacketID, bs);
+	}
+
+	void sendVehicleSync(LoadTestPlayer& data, float clock)
+	{
+		Vector3 position, velocity;
+		float angle;
+		getPath(data, clock, position, velocity, angle);
+
+		NetworkBitStream bs;
+		bs.writeUINT8(NetCode::Packet::PlayerVehicleSync::PacketID);
+		bs.writeUINT16(data.vehicle->getID());
+		bs.writeUINT16(0); // Left and right
+		bs.writeUINT16(uint16_t(-128)); // Forward
+		bs.writeUINT16(Key::SPRINT); // Accelerate
+		bs.Write(GTAQuat(0.f, 0.f, angle).q);
+		bs.Write(position);
+		bs.Write(velocity);
+		bs.writeFLOAT(1000.f); // Vehicle health
+		bs.writeUINT8(100); // Health
+		bs.writeUINT8(0); // Armour
+		bs.writeUINT8(0); // Weapon and additional key
+		bs.writeUINT8(0); // Siren
+		bs.writeUINT8(0); // Landing gear
+		bs.writeUINT16(0); // Trailer
+		bs.writeUINT32(0); // Hydra thrust angle
+		network.receivePacket(*data.player, NetCode::Packet::PlayerVehicleSync::PacketID, bs);
+	}
+
+	void sendAimSync(LoadTestPlayer& data, float clock)
+	{
+		Vector3 position, velocity;
+		float angle;
+		getPath(data, clock, position, velocity, angle);
+
+		// Aim at the middle of the path.
+		const Vector3 toMiddle = Vector3(0.f, 0.f, 3.f) - position;
+		const float distance = glm::length(toMiddle);
+		const Vector3 front = distance > 0.f ? toMiddle / distance : Vector3(1.f, 0.f, 0.f);
+
+		NetworkBitStream bs;
+		bs.writeUINT8(NetCode::Packet::PlayerAimSync::PacketID);
+		bs.writeUINT8(53); // Aiming with a rifle
+		bs.Write(front);
+		bs.Write(position + Vector3(0.f, 0.f, 0.7f));
+		bs.writeFLOAT(0.f);
+		bs.writeUINT8(PlayerWeaponState_MoreBullets << 6);
+		bs.writeUINT8(85); // 16:9
+		network.receivePacket(*data.player, NetCode::Packet::PlayerAimSync::PacketID, bs);
+	}
+
+	void sendBulletSync(LoadTestPlayer& data, float clock)
+	{
+		// Shoot the next runner, who's in stream distance in the stadium.
+		const LoadTestPlayer* target = nullptr;
+		for (int i = 1; i != PLAYER_POOL_SIZE && !target; ++i)
+		{
+			const LoadTestPlayer& other = players[(data.player->getID() + i) % PLAYER_POOL_SIZE];
+			if (other.player && !other.disconnecting)
+			{
+				target = &other;
+			}
+		}
+		if (!target)
+		{
+			return;
+		}
+
+		Vector3 origin, targetPosition, velocity;
+		float angle;
+		getPath(data, clock, origin, velocity, angle);
+		getPath(*target, clock, targetPosition, velocity, angle);
+
+		NetworkBitStream bs;
+		bs.writeUINT8(NetCode::Packet::PlayerBulletSync::PacketID);
+		bs.writeUINT8(PlayerBulletHitType_Player);
+		bs.writeUINT16(target->player->getID());
+		bs.Write(origin);
+		bs.Write(targetPosition);
+		bs.Write(Vector3(0.f, 0.f, 0.2f)); // Offset from the target
+		bs.writeUINT8(PlayerWeapon_M4);
+		network.receivePacket(*data.player, NetCode::Packet::PlayerBulletSync::PacketID, bs);
+	}
+
+	bool connectPlayer(int index)
+	{
+		PeerNetworkData netData {};
+		netData.network = &network;
+		netData.networkID.address.ipv6 = false;
+		PeerAddress::FromString(netData.networkID.address, "127.0.0.1");
+		netData.networkID.port = nextPort++;
+
+		PeerRequestParams params;
+		params.version = ClientVersion::ClientVersion_openmp;
+		params.versionName = "loadtest";
+		params.bot = false;
+		const String name = "LoadTest_" + std::to_string(index);
+		params.name = name;
+		params.serial = "";
+		params.isUsingOfficialClient = false;
+
+		Pair<NewConnectionResult, IPlayer*> result = core->getPlayers().requestPlayer(netData, params);
+		if (result.first != NewConnectionResult_Success)
+		{
+			return false;
+		}
+
+		IPlayer* player = result.second;
+		LoadTestPlayer& data = players[player->getID()];
+		data = LoadTestPlayer();
+		data.player = player;
+		data.index = index;
+		network.dispatchConnect(*player);
+
+		// Spread each kind of sync over its interval rather than sending everyone's in the same tick.
+		data.nextFootSync = float(index % int(FootSyncInterval));
+		data.nextAimSync = float(index % int(AimSyncInterval));
+		data.nextBulletSync = float(index % int(BulletSyncInterval));
+
+		// Players are only spawned after asking, like clients do from class selection.
+		NetworkBitStream requestSpawn;
+		network.receiveRPC(*player, NetCode::RPC::PlayerRequestSpawn::PacketID, requestSpawn);
+		NetworkBitStream spawn;
+		network.receiveRPC(*player, NetCode::RPC::PlayerSpawn::PacketID, spawn);
+		return true;
+	}
+
+	void startScenario(const LoadTestScenario& next, int count, int runSeconds)
+	{
+		scenario = &next;
+		duration = Seconds(runSeconds);
+		playerCount = 0;
+		measuring = false;
+
+		for (int i = 0; i != count; ++i)
+		{
+			if (!connectPlayer(i))
+			{
+				break;
+			}
+			++playerCount;
+		}
+
+		if (next.vehicles && vehicles)
+		{
+			int index = 0;
+			for (LoadTestPlayer& data : players)
+			{
+				if (!data.player || index >= next.vehicles)
+				{
+					continue;
+				}
+				Vector3 position, velocity;
+				float angle;
+				getPath(data, 0.f, position, velocity, angle);
+				data.vehicle = vehicles->create(false, 560, position, angle);
+				if (data.vehicle)
+				{
+					vehicleIDs.push_back(data.vehicle->getID());
+				}
+				++index;
+			}
+		}
+
+		if (next.objects && objects)
+		{
+			// A square grid covering the players' paths.
+			const int side = int(std::ceil(std::sqrt(float(next.objects))));
+			const float spacing = 900.f / side;
+			for (int i = 0; i != next.objects; ++i)
+			{
+				const Vector3 position((i % side) * spacing - 450.f, (i / side) * spacing - 450.f, 3.f);
+				IObject* object = objects->create(1225, position, Vector3(0.f, 0.f, 0.f));
+				if (object)
+				{
+					objectIDs.push_back(object->getID());
+				}
+			}
+		}
+
+		core->printLn("[loadtest] Running %.*s with %d players, %zu vehicles and %zu objects for %d seconds", PRINT_VIEW(next.name), playerCount, vehicleIDs.size(), objectIDs.size(), runSeconds);
+		start = Time::now();
+	}
+
+	void startMeasuring(TimePoint now)
+	{
+		measuring = true;
+		measureStart = now;
+		measureBytes = network.bytesSent;
+		measureAllocations = core->getStats().allocations;
+		measureTicks = 0;
+		core->getTickProfiler().reset();
+	}
+
+	void finishScenario(TimePoint now)
+	{
+		const double measured = duration_cast<Microseconds>(now - measureStart).count() / 1000000.0;
+		const double bytesPerPlayer = (network.bytesSent - measureBytes) / std::max(measured, 0.000001) / std::max(playerCount, 1);
+		const uint64_t allocations = core->getStats().allocations;
+
+		ITickProfiler& profiler = core->getTickProfiler();
+		TickProfileStats stats;
+		if (profiler.isEnabled() && profiler.getStats(profiler.addSection("Tick"), TickProfileWindow_Minute, stats) && stats.ticks)
+		{
+			core->printLn("[loadtest] %.*s: %u ticks, tick time p50 %.3fms, p99 %.3fms, max %.3fms", PRINT_VIEW(scenario->name), measureTicks, stats.p50.count() / 1000.0, stats.p99.count() / 1000.0, stats.max.count() / 1000.0);
+		}
+		else
+		{
+			core->printLn("[loadtest] %.*s: %u ticks, tick times need enable_tick_profiler", PRINT_VIEW(scenario->name), measureTicks);
+		}
+		core->printLn("[loadtest] %.*s: %.0f bytes per player per second", PRINT_VIEW(scenario->name), bytesPerPlayer);
+		if (allocations)
+		{
+			core->printLn("[loadtest] %.*s: %.1f allocations per tick", PRINT_VIEW(scenario->name), double(allocations - measureAllocations) / std::max(measureTicks, 1u));
+		}
+		else
+		{
+			core->printLn("[loadtest] %.*s: allocations need a BUILD_ALLOCATION_COUNTER build", PRINT_VIEW(scenario->name));
+		}
+
+		stopScenario();
+	}
+
+	void stopScenario()
+	{
+		for (LoadTestPlayer& data : players)
+		{
+			if (data.player && !data.disconnecting)
+			{
+				data.player->kick();
+			}
+		}
+		if (vehicles)
+		{
+			for (int id : vehicleIDs)
+			{
+				vehicles->release(id);
+			}
+		}
+		if (objects)
+		{
+			for (int id : objectIDs)
+			{
+				objects->release(id);
+			}
+		}
+		vehicleIDs.clear();
+		objectIDs.clear();
+		scenario = nullptr;
+	}
+
+public:
+	LoadTestComponent()
+		: network(*this)
+	{
+	}
+
+	/// Gets the component UID
+	/// @returns Component UID
+	UID getUID() override
+	{
+		return 0x2C7B5E13A98D4F60;
+	}
+
+	/// Gets the component name
+	/// @returns Component name
+	StringView componentName() const override
+	{
+		return "Load test";
+	}
+
+	/// Gets the component version
+	/// @returns Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(1, 0, 0, 0);
+	}
+
+	void provideConfiguration(ILogger& logger, IEarlyConfig& config, bool defaults) override
+	{
+		if (defaults)
+		{
+			config.setString("loadtest.run", "");
+			config.setInt("loadtest.seconds", seconds);
+		}
+		else
+		{
+			if (config.getType("loadtest.run") == ConfigOptionType_None)
+			{
+				config.setString("loadtest.run", "");
+			}
+			if (config.getType("loadtest.seconds") == ConfigOptionType_None)
+			{
+				config.setInt("loadtest.seconds", seconds);
+			}
+		}
+	}
+
+	/// Called for every component after components have been loaded
+	/// @param c Core
+	void onLoad(ICore* c) override
+	{
+		core = c;
+		core->getEventDispatcher().addEventHandler(this);
+	}
+
+	/// Called when all components have been initialised
+	/// @param components Component list to query
+	void onInit(IComponentList* components) override
+	{
+		console = components->queryComponent<IConsoleComponent>();
+		vehicles = components->queryComponent<IVehiclesComponent>();
+		objects = components->queryComponent<IObjectsComponent>();
+		if (console)
+		{
+			console->getEventDispatcher().addEventHandler(this);
+		}
+	}
+
+	void onReady() override
+	{
+		IConfig& config = core->getConfig();
+		// The profiler keeps a minute of ticks.
+		seconds = std::clamp(*config.getInt("loadtest.seconds"), 1, 60);
+
+		StringView run = config.getString("loadtest.run");
+		while (!run.empty())
+		{
+			const size_t end = std::min(run.find_first_of(";,"), run.size());
+			const StringView name = run.substr(0, end);
+			run = run.substr(std::min(end + 1, run.size()));
+			if (name.empty())
+			{
+				continue;
+			}
+
+			const LoadTestScenario* found = findScenario(name);
+			if (found)
+			{
+				queued.push_back(found);
+			}
+			else
+			{
+				core->logLn(LogLevel::Error, "[loadtest] Unknown scenario %.*s in loadtest.run", PRINT_VIEW(name));
+			}
+		}
+		exitWhenDone = !queued.empty();
+	}
+
+	/// Called when a component is about to be unloaded
+	/// @param component Component
+	void onFree(IComponent* component) override
+	{
+		if (component == console)
+		{
+			console = nullptr;
+		}
+		else if (component == vehicles)
+		{
+			vehicles = nullptr;
+		}
+		else if (component == objects)
+		{
+			objects = nullptr;
+		}
+	}
+
+	INetwork* getNetwork() override
+	{
+		return &network;
+	}
+
+	bool onConsoleText(StringView command, StringView parameters, const ConsoleCommandSenderData& sender) override
+	{
+		if (command != "loadtest")
+		{
+			return false;
+		}
+
+		if (scenario)
+		{
+			console->sendMessage(sender, "A load test is already running");
+			return true;
+		}
+
+		String args(parameters);
+		char name[16] = {};
+		int count = -1;
+		int runSeconds = seconds;
+		const int parsed = sscanf(args.c_str(), "%15s %d %d", name, &count, &runSeconds);
+		const LoadTestScenario* found = parsed >= 1 ? findScenario(name) : nullptr;
+		if (!found)
+		{
+			console->sendMessage(sender, "Usage: loadtest <stadium|highway|objects> [players] [seconds]");
+			return true;
+		}
+
+		startScenario(*found, count > 0 ? std::min(count, PLAYER_POOL_SIZE) : found->players, std::clamp(runSeconds, 1, 60));
+		return true;
+	}
+
+	void onConsoleCommandListRequest(FlatHashSet<StringView>& commands) override
+	{
+		commands.emplace("loadtest");
+	}
+
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		// Players kicked last tick leave now, so whoever kicked them could still use them.
+		for (LoadTestPlayer& data : players)
+		{
+			if (data.player && data.disconnecting)
+			{
+				IPlayer& player = *data.player;
+				data.player = nullptr;
+				data.disconnecting = false;
+				network.dispatchDisconnect(player);
+			}
+		}
+
+		if (!scenario)
+		{
+			if (!queued.empty() && network.peers == 0)
+			{
+				const LoadTestScenario* next = queued.front();
+				queued.erase(queued.begin());
+				startScenario(*next, next->players, seconds);
+			}
+			else if (queued.empty() && exitWhenDone && console)
+			{
+				exitWhenDone = false;
+				console->send("exit");
+			}
+			return;
+		}
+
+		if (!measuring && now - start >= WarmupTime)
+		{
+			startMeasuring(now);
+		}
+		else if (measuring)
+		{
+			++measureTicks;
+			if (now - measureStart >= duration)
+			{
+				finishScenario(now);
+				return;
+			}
+		}
+
+		const float clock = duration_cast<Microseconds>(now - start).count() / 1000.f;
+		const bool shooting = scenario == &Scenarios[0];
+		for (LoadTestPlayer& data : players)
+		{
+			if (!data.player || data.disconnecting)
+			{
+				continue;
+			}
+
+			if (data.nextFootSync <= clock)
+			{
+				if (data.vehicle)
+				{
+					sendVehicleSync(data, clock);
+					data.nextFootSync = std::max(data.nextFootSync + VehicleSyncInterval, clock);
+				}
+				else
+				{
+					sendFootSync(data, clock);
+					data.nextFootSync = std::max(data.nextFootSync + FootSyncInterval, clock);
+				}
+			}
+
+			if (shooting && data.nextAimSync <= clock)
+			{
+				sendAimSync(data, clock);
+				data.nextAimSync = std::max(data.nextAimSync + AimSyncInterval, clock);
+			}
+
+			if (shooting && data.nextBulletSync <= clock)
+			{
+				sendBulletSync(data, clock);
+				data.nextBulletSync = std::max(data.nextBulletSync + BulletSyncInterval, clock);
+			}
+		}
+	}
+
+	void disconnectPlayer(const IPlayer& player)
+	{
+		const int id = player.getID();
+		if (id >= 0 && id < PLAYER_POOL_SIZE && players[id].player == &player)
+		{
+			players[id].disconnecting = true;
+		}
+	}
+
+	void reset() override
+	{
+		if (scenario)
+		{
+			stopScenario();
+		}
+	}
+
+	void free() override
+	{
+		if (console)
+		{
+			console->getEventDispatcher().removeEventHandler(this);
+		}
+		if (core)
+		{
+			core->getEventDispatcher().removeEventHandler(this);
+		}
+	}
+} loadTestComponent;
+
+void LoadTestNetwork::disconnect(const IPlayer& peer)
+{
+	component.disconnectPlayer(peer);
+}
+
+COMPONENT_ENTRY_POINT()
+{
+	return &loadTestComponent;
+}
@@ -14,6 +14,7 @@ class MenusComponent final : public IMenusComponent, public MenuEventHandler, pu
 {
 private:
 	ICore* core = nullptr;
+	ILogger* logger = nullptr;
 	MarkedPoolStorage<Menu, IMenu, 1, MENU_POOL_SIZE> storage;
 	DefaultEventDispatcher<MenuEventHandler> eventDispatcher;
 	IPlayerPool* players = nullptr;
@@ -112,10 +113,13 @@ public:
 	void onLoad(ICore* core) override
 	{
 		this->core = core;
+		logger = &core->getStructuredLogger().getLogger(getUID());
 		players = &core->getPlayers();
 		players->getPlayerConnectDispatcher().addEventHandler(this);
 		players->getPoolEventDispatcher().addEventHandler(this);
 		NetCode::RPC::OnPlayerSelectedMenuRow::addEventHandler(*core, &playerSelectedMenuRowEventHandler);
+		eventDispatcher.setProfiler(&core->getTickProfiler(), "MenuEventHandler");
+		storage.getEventDispatcher().setProfiler(&core->getTickProfiler(), "MenuPoolEventHandler");
 		NetCode::RPC::OnPlayerExitedMenu::addEventHandler(*core, &playerExitedMenuEventHandler);
 	}
 
@@ -149,7 +153,7 @@ public:
 	{
 		if (columns > 2)
 		{
-			core->logLn(LogLevel::Error, "Invalid columns count %d used. Only menus with 2 columns can be created.", columns);
+			logger->logLn(LogLevel::Error, "Invalid columns count %d used. Only menus with 2 columns can be created.", columns);
 			return nullptr;
 		}
 		return storage.emplace(title, position, columns, col1Width, col2Width);
@@ -0,0 +1,432 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include <Server/Components/Databases/databases.hpp>
+#include <Server/Components/Vehicles/vehicles.hpp>
+#include <cstdarg>
+#include <cstdio>
+#include <httplib.h>
+#include <mutex>
+#include <netcode.hpp>
+#include <sdk.hpp>
+#include <thread>
+
+using namespace Impl;
+
+/// How often the main thread renders a new set of metrics for the endpoint to serve
+constexpr Milliseconds UpdateInterval = Seconds(1);
+
+/// Messages and bytes seen for one packet or RPC ID
+struct TrafficCounter
+{
+	uint64_t messages = 0;
+	uint64_t bytes = 0;
+};
+
+/// Serves the server's metrics in the Prometheus text format from a local HTTP endpoint
+/// Everything is collected and rendered in the main thread once per UpdateInterval, the endpoint's thread only hands
+/// out the last rendered text so a scrape never touches game state.
+class MetricsComponent final : public IComponent, public CoreEventHandler, public NetworkInEventHandler, public NetworkOutEventHandler
+{
+private:
+	ICore* core = nullptr;
+	ILogger* logger = nullptr;
+	IVehiclesComponent* vehicles = nullptr;
+	IDatabasesComponent* databases = nullptr;
+
+	bool enabled = false;
+	String bindAddress = "127.0.0.1";
+	int port = 9464;
+
+	httplib::Server server;
+	std::thread serverThread;
+	std::mutex textMutex;
+	String text;
+
+	/// Only written and read in the main thread, the networks dispatch from it
+	StaticArray<TrafficCounter, 256> packetsIn;
+	StaticArray<TrafficCounter, 256> packetsOut;
+	StaticArray<TrafficCounter, 256> rpcsIn;
+	StaticArray<TrafficCounter, 256> rpcsOut;
+
+	TimePoint lastUpdate;
+	String buffer;
+
+	struct SectionWriter : TickProfileEnumeratorCallback
+	{
+		MetricsComponent& self;
+		ITickProfiler& profiler;
+		bool ticks;
+
+		SectionWriter(MetricsComponent& self, ITickProfiler& profiler, bool ticks)
+			: self(self)
+			, profiler(profiler)
+			, ticks(ticks)
+		{
+		}
+
+		bool proc(int section, StringView name) override
+		{
+			TickProfileStats stats;
+			if (profiler.getStats(section, TickProfileWindow_TenSeconds, stats) && stats.ticks)
+			{
+				const String label = escapeLabel(name);
+				if (ticks)
+				{
+					self.append("omp_tick_section_ticks{section=\"%s\"} %u\n", label.c_str(), stats.ticks);
+				}
+				else
+				{
+					self.append("omp_tick_section_seconds{section=\"%s\",quantile=\"0.5\"} %.6f\n", label.c_str(), stats.p50.count() / 1000000.0);
+					self.append("omp_tick_section_seconds{section=\"%s\",quantile=\"0.99\"} %.6f\n", label.c_str(), stats.p99.count() / 1000000.0);
+					self.append("omp_tick_section_seconds{section=\"%s\",quantile=\"1\"} %.6f\n", label.c_str(), stats.max.count() / 1000000.0);
+				}
+			}
+			return true;
+		}
+	};
+
+	static String escapeLabel(StringView value)
+	{
+		String escaped;
+		escaped.reserve(value.size());
+		for (char c : value)
+		{
+			if (c == '\\' || c == '"')
+			{
+				escaped += '\\';
+				escaped += c;
+			}
+			else if (c == '\n')
+			{
+				escaped += "\\n";
+			}
+			else
+			{
+				escaped += c;
+			}
+		}
+		return escaped;
+	}
+
+	__ATTRIBUTE__((__format__(__printf__, 2, 3)))
+	void append(const char* fmt, ...)
+	{
+		char line[512];
+		va_list args;
+		va_start(args, fmt);
+		const int length = vsnprintf(line, sizeof(line), fmt, args);
+		va_end(args);
+		if (length > 0)
+		{
+			buffer.append(line, std::min<size_t>(length, sizeof(line) - 1));
+		}
+	}
+
+	void appendHeader(const char* name, const char* type, const char* help)
+	{
+		append("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+	}
+
+	void appendTraffic(const char* direction, const char* kind, const StaticArray<TrafficCounter, 256>& counters, bool bytes)
+	{
+		for (size_t id = 0; id != counters.size(); ++id)
+		{
+			if (counters[id].messages)
+			{
+				append("omp_network_%s_total{direction=\"%s\",kind=\"%s\",id=\"%zu\"} %llu\n", bytes ? "bytes" : "messages", direction, kind, id, (unsigned long long)(bytes ? counters[id].bytes : counters[id].messages));
+			}
+		}
+	}
+
+	void render()
+	{
+		buffer.clear();
+
+		appendHeader("omp_tick_rate", "gauge", "Server ticks in the last second.");
+		append("omp_tick_rate %u\n", core->tickRate());
+
+		ITickProfiler& profiler = core->getTickProfiler();
+		if (profiler.isEnabled())
+		{
+			// Each family's samples have to follow its own header, so enumerate once per family.
+			appendHeader("omp_tick_section_seconds", "gauge", "Time spent in each profiled part of a tick over the last 10 seconds, see enable_tick_profiler.");
+			SectionWriter secondsWriter(*this, profiler, false);
+			profiler.enumSections(secondsWriter);
+			appendHeader("omp_tick_section_ticks", "gauge", "Ticks each profiled part ran in over the last 10 seconds.");
+			SectionWriter ticksWriter(*this, profiler, true);
+			profiler.enumSections(ticksWriter);
+		}
+
+		IPlayerPool& players = core->getPlayers();
+		size_t streamedPlayers = 0;
+		for (IPlayer* player : players.entries())
+		{
+			streamedPlayers += player->streamedForPlayers().size();
+		}
+		appendHeader("omp_players", "gauge", "Connected players, including bots.");
+		append("omp_players %zu\n", players.entries().size());
+		appendHeader("omp_streamed_entities", "gauge", "Entities streamed in, counted once for each player they're streamed for.");
+		append("omp_streamed_entities{type=\"player\"} %zu\n", streamedPlayers);
+		if (vehicles)
+		{
+			size_t streamedVehicles = 0;
+			for (IVehicle* vehicle : *vehicles)
+			{
+				streamedVehicles += vehicle->streamedForPlayers().size();
+			}
+			append("omp_streamed_entities{type=\"vehicle\"} %zu\n", streamedVehicles);
+		}
+
+		appendHeader("omp_network_messages_total", "counter", "Packets and RPCs received and sent, a broadcast counts once.");
+		appendTraffic("in", "packet", packetsIn, false);
+		appendTraffic("in", "rpc", rpcsIn, false);
+		appendTraffic("out", "packet", packetsOut, false);
+		appendTraffic("out", "rpc", rpcsOut, false);
+		appendHeader("omp_network_bytes_total", "counter", "Payload bytes of the packets and RPCs received and sent, a broadcast counts once.");
+		appendTraffic("in", "packet", packetsIn, true);
+		appendTraffic("in", "rpc", rpcsIn, true);
+		appendTraffic("out", "packet", packetsOut, true);
+		appendTraffic("out", "rpc", rpcsOut, true);
+
+		unsigned long long wireBytesIn = 0;
+		unsigned long long wireBytesOut = 0;
+		for (INetwork* network : core->getNetworks())
+		{
+			const NetworkStats stats = network->getStatistics();
+			wireBytesIn += stats.bytesReceived;
+			wireBytesOut += stats.totalBytesSent;
+		}
+		appendHeader("omp_network_wire_bytes_total", "counter", "Bytes received and sent by the networks, including protocol overhead and resends.");
+		append("omp_network_wire_bytes_total{direction=\"in\"} %llu\n", wireBytesIn);
+		append("omp_network_wire_bytes_total{direction=\"out\"} %llu\n", wireBytesOut);
+
+		const CoreStats stats = core->getStats();
+		appendHeader("omp_http_requests_queued", "gauge", "HTTP requests waiting for or running on a client thread.");
+		append("omp_http_requests_queued %zu\n", stats.httpRequestsQueued);
+		if (stats.allocations)
+		{
+			appendHeader("omp_allocations_total", "counter", "Heap allocations made by the server.");
+			append("omp_allocations_total %llu\n", (unsigned long long)stats.allocations);
+		}
+
+		if (databases)
+		{
+			unsigned long long batches = 0;
+			unsigned long long queries = 0;
+			unsigned long long failed = 0;
+			long long maxLatency = 0;
+			const size_t count = databases->getDatabaseConnectionCount();
+			for (int id = 1, found = 0; found < int(count) && id <= DATABASE_CONNECTION_POOL_SIZE; ++id)
+			{
+				if (databases->isDatabaseConnectionIDValid(id))
+				{
+					++found;
+					const DatabaseWriteBatchStats& batchStats = databases->getDatabaseConnectionByID(id).getWriteBatchStats();
+					batches += batchStats.batches;
+					queries += batchStats.queries;
+					failed += batchStats.failedQueries;
+					maxLatency = std::max<long long>(maxLatency, batchStats.maxLatency.count());
+				}
+			}
+			appendHeader("omp_database_connections", "gauge", "Open database connections.");
+			append("omp_database_connections %zu\n", count);
+			appendHeader("omp_database_write_batches_total", "counter", "Queued write batches committed by the open connections.");
+			append("omp_database_write_batches_total %llu\n", batches);
+			appendHeader("omp_database_write_queries_total", "counter", "Queued writes executed by the open connections, by result.");
+			append("omp_database_write_queries_total{result=\"succeeded\"} %llu\n", queries - failed);
+			append("omp_database_write_queries_total{result=\"failed\"} %llu\n", failed);
+			appendHeader("omp_database_write_batch_max_seconds", "gauge", "Longest time a write batch took to execute and commit.");
+			append("omp_database_write_batch_max_seconds %.6f\n", maxLatency / 1000000.0);
+		}
+
+		std::lock_guard<std::mutex> lock(textMutex);
+		text.swap(buffer);
+	}
+
+	void startServer()
+	{
+		server.new_task_queue = []
+		{
+			return new httplib::ThreadPool(1);
+		};
+		server.Get("/metrics", [this](const httplib::Request&, httplib::Response& res)
+			{
+				std::lock_guard<std::mutex> lock(textMutex);
+				res.set_content(text, "text/plain; version=0.0.4");
+			});
+
+		if (!server.bind_to_port(bindAddress.c_str(), port))
+		{
+			logger->logLn(LogLevel::Error, "[metrics] Couldn't listen on %s:%d", bindAddress.c_str(), port);
+			return;
+		}
+		serverThread = std::thread([this]()
+			{
+				server.listen_after_bind();
+			});
+		logger->logLn(LogLevel::Message, "[metrics] Serving metrics on http://%s:%d/metrics", bindAddress.c_str(), port);
+	}
+
+public:
+	PROVIDE_UID(0x3C5E81A4F07B2D96);
+
+	StringView componentName() const override
+	{
+		return "Metrics";
+	}
+
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
+	}
+
+	void provideConfiguration(ILogger& logger, IEarlyConfig& config, bool defaults) override
+	{
+		if (defaults)
+		{
+			config.setBool("metrics.enable", enabled);
+			config.setString("metrics.bind", bindAddress);
+			config.setInt("metrics.port", port);
+		}
+		else
+		{
+			if (config.getType("metrics.enable") == ConfigOptionType_None)
+			{
+				config.setBool("metrics.enable", enabled);
+			}
+			if (config.getType("metrics.bind") == ConfigOptionType_None)
+			{
+				config.setString("metrics.bind", bindAddress);
+			}
+			if (config.getType("metrics.port") == ConfigOptionType_None)
+			{
+				config.setInt("metrics.port", port);
+			}
+		}
+	}
+
+	void onLoad(ICore* c) override
+	{
+		core = c;
+		logger = &core->getStructuredLogger().getLogger(getUID());
+		enabled = *core->getConfig().getBool("metrics.enable");
+		bindAddress = String(core->getConfig().getString("metrics.bind"));
+		port = *core->getConfig().getInt("metrics.port");
+	}
+
+	void onInit(IComponentList* components) override
+	{
+		vehicles = components->queryComponent<IVehiclesComponent>();
+		databases = components->queryComponent<IDatabasesComponent>();
+	}
+
+	void onReady() override
+	{
+		if (!enabled)
+		{
+			return;
+		}
+
+		core->getEventDispatcher().addEventHandler(this, EventPriority_Lowest);
+		for (INetwork* network : core->getNetworks())
+		{
+			network->getInEventDispatcher().addEventHandler(this, EventPriority_Highest);
+			network->getOutEventDispatcher().addEventHandler(this, EventPriority_Highest);
+		}
+
+		render();
+		lastUpdate = Time::now();
+		startServer();
+	}
+
+	void onFree(IComponent* component) override
+	{
+		if (component == vehicles)
+		{
+			vehicles = nullptr;
+		}
+		else if (component == databases)
+		{
+			databases = nullptr;
+		}
+	}
+
+	bool onReceivePacket(IPlayer& peer, int id, NetworkBitStream& bs) override
+	{
+		TrafficCounter& counter = packetsIn[id & 0xFF];
+		++counter.messages;
+		counter.bytes += bs.GetNumberOfBytesUsed();
+		return true;
+	}
+
+	bool onReceiveRPC(IPlayer& peer, int id, NetworkBitStream& bs) override
+	{
+		TrafficCounter& counter = rpcsIn[id & 0xFF];
+		++counter.messages;
+		counter.bytes += bs.GetNumberOfBytesUsed();
+		return true;
+	}
+
+	bool onSendPacket(IPlayer* peer, int id, NetworkBitStream& bs) override
+	{
+		TrafficCounter& counter = packetsOut[id & 0xFF];
+		++counter.messages;
+		counter.bytes += bs.GetNumberOfBytesUsed();
+		return true;
+	}
+
+	bool onSendRPC(IPlayer* peer, int id, NetworkBitStream& bs) override
+	{
+		TrafficCounter& counter = rpcsOut[id & 0xFF];
+		++counter.messages;
+		counter.bytes += bs.GetNumberOfBytesUsed();
+		return true;
+	}
+
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		if (now - lastUpdate >= UpdateInterval)
+		{
+			lastUpdate = now;
+			render();
+		}
+	}
+
+	void reset() override
+	{
+	}
+
+	void free() override
+	{
+		delete this;
+	}
+
+	~MetricsComponent()
+	{
+		if (serverThread.joinable())
+		{
+			server.stop();
+			serverThread.join();
+		}
+		if (core && enabled)
+		{
+			core->getEventDispatcher().removeEventHandler(this);
+			for (INetwork* network : core->getNetworks())
+			{
+				network->getInEventDispatcher().removeEventHandler(this);
+				network->getOutEventDispatcher().removeEventHandler(this);
+			}
+		}
+	}
+};
+
+COMPONENT_ENTRY_POINT()
+{
+	return new MetricsComponent();
+}
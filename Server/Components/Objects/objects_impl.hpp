@@ -240,6 +240,8 @@ public:
 		this->core = core;
 		this->players = &core->getPlayers();
 		core->getEventDispatcher().addEventHandler(this);
+		eventDispatcher.setProfiler(&core->getTickProfiler(), "ObjectEventHandler");
+		storage.getEventDispatcher().setProfiler(&core->getTickProfiler(), "ObjectPoolEventHandler");
 		players->getPlayerSpawnDispatcher().addEventHandler(this, EventPriority::EventPriority_FairlyHigh + 1 /* want this to be called before Pawn */);
 		players->getPlayerStreamDispatcher().addEventHandler(this, EventPriority::EventPriority_FairlyLow - 1 /* want this to be called after Pawn but before Core */);
 		players->getPlayerConnectDispatcher().addEventHandler(this, EventPriority::EventPriority_FairlyLow - 1 /* want this to be called after Pawn but before Core */);
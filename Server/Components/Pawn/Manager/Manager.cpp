@@ -13,6 +13,8 @@
 
 #include "Manager.hpp"
 #include "../PluginManager/PluginManager.hpp"
+#include "../commands.hpp"
+#include "../database_queries.hpp"
 #include "../utils.hpp"
 
 #ifdef WIN32
@@ -61,6 +63,9 @@ PawnManager::~PawnManager()
 		mainScript_->Call("OnGameModeExit", DefaultReturnValue_False);
 		CallInSides("OnGameModeExit", DefaultReturnValue_False);
 		PawnTimerImpl::Get()->killTimers(mainScript_->GetAMX());
+		PawnCommandImpl::Get()->removeCommands(mainScript_->GetAMX());
+		PawnDatabaseQueries::Get()->removeQueries(mainScript_->GetID());
+		PawnProfiler::Get()->detach(mainScript_->GetAMX());
 		pluginManager.AmxUnload(mainScript_->GetAMX());
 		eventDispatcher.dispatch(&PawnEventHandler::onAmxUnload, *mainScript_);
 	}
@@ -69,6 +74,9 @@ PawnManager::~PawnManager()
 		IPawnScript& script = *cur;
 		script.Call("OnFilterScriptExit", DefaultReturnValue_False);
 		PawnTimerImpl::Get()->killTimers(script.GetAMX());
+		PawnCommandImpl::Get()->removeCommands(script.GetAMX());
+		PawnDatabaseQueries::Get()->removeQueries(script.GetID());
+		PawnProfiler::Get()->detach(script.GetAMX());
 		pluginManager.AmxUnload(script.GetAMX());
 		eventDispatcher.dispatch(&PawnEventHandler::onAmxUnload, script);
 	}
@@ -84,6 +92,7 @@ void PawnManager::OnServerCommandList(FlatHashSet<StringView>& commands)
 	commands.emplace("loadscript");
 	commands.emplace("unloadscript");
 	commands.emplace("reloadscript");
+	commands.emplace("pawnprof");
 }
 
 bool PawnManager::OnServerCommand(const ConsoleCommandSenderData& sender, std::string const& cmd, std::string const& args)
@@ -179,6 +188,48 @@ bool PawnManager::OnServerCommand(const ConsoleCommandSenderData& sender, std::s
 		}
 		return true;
 	}
+	else if (cmd == "pawnprof")
+	{
+		PawnProfiler* profiler = PawnProfiler::Get();
+		if (args == "start")
+		{
+			profiler->start();
+			console->sendMessage(sender, profiler->enabled ? "Pawn profiler started." : "Pawn profiler started, natives are only timed with pawn.enable_profiler set.");
+		}
+		else if (args == "stop")
+		{
+			profiler->stop();
+			console->sendMessage(sender, "Pawn profiler stopped.");
+		}
+		else if (args == "reset")
+		{
+			profiler->reset();
+			console->sendMessage(sender, "Pawn profiler reset.");
+		}
+		else if (args.rfind("dump ", 0) == 0)
+		{
+			const std::string path = args.substr(5);
+			if (profiler->dump(path))
+			{
+				console->sendMessage(sender, "Pawn profile written to '" + path + "'.");
+			}
+			else
+			{
+				console->sendMessage(sender, "Pawn profile couldn't be written to '" + path + "'.");
+			}
+		}
+		else
+		{
+			DynamicArray<String> lines;
+			profiler->top(lines, 20);
+			console->sendMessage(sender, "Usage: pawnprof [start|stop|reset|dump <file>], top functions by exclusive time:");
+			for (const String& line : lines)
+			{
+				console->sendMessage(sender, line);
+			}
+		}
+		return true;
+	}
 	return false;
 }
 
@@ -241,18 +292,18 @@ void PawnManager::CheckNatives(PawnScript& script)
 		{
 			if (!is_deprecated)
 			{
-				core->logLn(LogLevel::Error, "Function not registered: %s", func.name);
+				logger->logLn(LogLevel::Error, "Function not registered: %s", func.name);
 			}
 			else
 			{
-				core->logLn(LogLevel::Error, "Function %s was removed and replaced by %s.", func.name, itr->second.c_str());
+				logger->logLn(LogLevel::Error, "Function %s was removed and replaced by %s.", func.name, itr->second.c_str());
 			}
 		}
 		else
 		{
 			if (is_deprecated)
 			{
-				core->logLn(LogLevel::Warning, "Deprecated function %s used. This function was replaced by %s.", func.name, itr->second.c_str());
+				logger->logLn(LogLevel::Warning, "Deprecated function %s used. This function was replaced by %s.", func.name, itr->second.c_str());
 				any_deprecated = true;
 			}
 		}
@@ -260,7 +311,7 @@ void PawnManager::CheckNatives(PawnScript& script)
 
 	if (any_deprecated)
 	{
-		core->logLn(LogLevel::Warning, "Deprecated functions will be removed in the next open.mp release.");
+		logger->logLn(LogLevel::Warning, "Deprecated functions will be removed in the next open.mp release.");
 	}
 }
 
@@ -279,7 +330,7 @@ bool PawnManager::Changemode(std::string const& name)
 	// and what can actually be loaded.  So while this is "old" C, it is better in this use-case.
 	if ((fp = fopen(canon_path.c_str(), "rb")) == NULL)
 	{
-		core->printLn("Could not find:\n\n\t %s %s", normal_script_name.c_str(),
+		logger->printLn("Could not find:\n\n\t %s %s", normal_script_name.c_str(),
 			R"(
 While attempting to load a PAWN gamemode, a file-not-found error was
 encountered.  This could be caused by many things:
@@ -403,7 +454,7 @@ void PawnManager::ProcessTick(Microseconds elapsed, TimePoint now)
 		else if (err != AMX_ERR_NONE)
 		{
 			// If there's no `main` ignore it for now.
-			core->logLn(LogLevel::Error, "%d %s", err, aux_StrError(err));
+			logger->logLn(LogLevel::Error, "%d %s", err, aux_StrError(err));
 		}
 	}
 }
@@ -464,6 +515,7 @@ void PawnManager::openAMX(PawnScript& script, bool isEntryScript, bool restartin
 	eventDispatcher.dispatch(&PawnEventHandler::onAmxLoad, script);
 	pawn_natives::AmxLoad(script.GetAMX());
 	pluginManager.AmxLoad(script.GetAMX());
+	PawnProfiler::Get()->attach(script.GetAMX(), script.name_);
 
 	cell amxAddr;
 	cell* realAddr;
@@ -519,7 +571,7 @@ void PawnManager::openAMX(PawnScript& script, bool isEntryScript, bool restartin
 		else if (err != AMX_ERR_NOTFOUND)
 		{
 			// If there's no `main` ignore it for now.
-			core->logLn(LogLevel::Error, "%s", aux_StrError(err));
+			logger->logLn(LogLevel::Error, "%s", aux_StrError(err));
 		}
 		// TODO: `AMX_EXEC_CONT` support.
 	}
@@ -569,7 +621,7 @@ bool PawnManager::Load(std::string const& name, bool isEntryScript, bool restart
 
 	std::string canon_path;
 	utils::Canonicalise(basePath_ + scriptPath_ + normal_script_name, canon_path);
-	PawnScript* ptr = new PawnScript(++id_, canon_path, core);
+	PawnScript* ptr = new PawnScript(++id_, canon_path, core, jitScripts_.find(normal_script_name) != jitScripts_.end());
 
 	if (!ptr || !ptr->IsLoaded())
 	{
@@ -630,6 +682,9 @@ void PawnManager::closeAMX(PawnScript& script, bool isEntryScript)
 	}
 
 	PawnTimerImpl::Get()->killTimers(script.GetAMX());
+	PawnCommandImpl::Get()->removeCommands(script.GetAMX());
+	PawnDatabaseQueries::Get()->removeQueries(script.GetID());
+	PawnProfiler::Get()->detach(script.GetAMX());
 	pluginManager.AmxUnload(script.GetAMX());
 	eventDispatcher.dispatch(&PawnEventHandler::onAmxUnload, script);
 	amxToScript_.erase(script.GetAMX());
@@ -731,3 +786,14 @@ void PawnManager::SetScriptPath(std::string const& path)
 		scriptPath_ = path + '/';
 	}
 }
+
+void PawnManager::SetJITScripts(Span<const StringView> names)
+{
+	jitScripts_.clear();
+	for (StringView name : names)
+	{
+		std::string normal_script_name;
+		utils::NormaliseScriptName(std::string(name), normal_script_name);
+		jitScripts_.emplace(normal_script_name);
+	}
+}
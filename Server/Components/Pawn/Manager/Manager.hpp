@@ -25,6 +25,7 @@
 #include <Server/Components/Objects/objects.hpp>
 #include <Server/Components/Pawn/pawn.hpp>
 #include <Server/Components/Pickups/pickups.hpp>
+#include <Server/Components/Playback/playback.hpp>
 #include <Server/Components/Recordings/recordings.hpp>
 #include <Server/Components/TextDraws/textdraws.hpp>
 #include <Server/Components/TextLabels/textlabels.hpp>
@@ -55,6 +56,8 @@ public:
 	FlatHashMap<AMX*, PawnScript*> amxToScript_;
 	DefaultEventDispatcher<PawnEventHandler> eventDispatcher;
 	PawnPluginManager pluginManager;
+	/// Logs as the Pawn component, so its `logging.levels` entry applies
+	ILogger* logger = nullptr;
 
 private:
 	int gamemodeIndex_ = 0;
@@ -67,6 +70,7 @@ private:
 	TimePoint nextSleep_;
 	bool unloadNextTick_ = false;
 	String nextScriptName_ = "";
+	FlatHashSet<String> jitScripts_;
 
 	// To preserve main script `sleep` information between callbacks.
 	struct
@@ -98,11 +102,13 @@ public:
 
 	void printPawnLog(const std::string& type, const std::string& message)
 	{
-		core->printLn("[PAWN-LOG] %s: %s", type.c_str(), message.c_str());
+		logger->printLn("[PAWN-LOG] %s: %s", type.c_str(), message.c_str());
 	}
 
 	void SetBasePath(std::string const& path);
 	void SetScriptPath(std::string const& path);
+	/// Set the scripts to compile to native code when they're loaded, from `pawn.jit_scripts`
+	void SetJITScripts(Span<const StringView> names);
 
 	bool Load(std::string const& name, bool primary = false, bool restarting = false);
 	bool Load(DynamicArray<StringView> const& mainScripts);
@@ -31,7 +31,7 @@ static const void
 		  reinterpret_cast<void*>(&amx_Callback),
 		  reinterpret_cast<void*>(&amx_Cleanup),
 		  reinterpret_cast<void*>(&amx_Clone),
-		  reinterpret_cast<void*>(&amx_Exec),
+		  reinterpret_cast<void*>(&amx_ExecProfiled),
 		  reinterpret_cast<void*>(&amx_FindNative),
 		  reinterpret_cast<void*>(&amx_FindPublic),
 		  reinterpret_cast<void*>(&amx_FindPubVar),
@@ -348,7 +348,7 @@ PawnPlugin::PawnPlugin(std::string const& path, ICore* core)
 		{
 			failMsg_ = "Unknown error";
 		}
-		serverCore->printLn("Could not load plugin:\n%s", failMsg_.c_str());
+		PawnManager::Get()->logger->printLn("Could not load plugin:\n%s", failMsg_.c_str());
 		return;
 	}
 
@@ -359,11 +359,11 @@ PawnPlugin::PawnPlugin(std::string const& path, ICore* core)
 	{
 		if (FindSym<void*>(pluginHandle_, "ComponentEntryPoint"))
 		{
-			serverCore->printLn("This file is an open.mp component. Please move it to components/ folder.");
+			PawnManager::Get()->logger->printLn("This file is an open.mp component. Please move it to components/ folder.");
 		}
 		else
 		{
-			serverCore->printLn("This file is not a SA-MP plugin.");
+			PawnManager::Get()->logger->printLn("This file is not a SA-MP plugin.");
 		}
 		return;
 	}
@@ -386,7 +386,7 @@ PawnPlugin::PawnPlugin(std::string const& path, ICore* core)
 	// Zero value means it failed to load
 	if (!Load_(PLUGIN_FUNCTIONS))
 	{
-		serverCore->printLn("Plugin failed to initialize.");
+		PawnManager::Get()->logger->printLn("Plugin failed to initialize.");
 		return;
 	}
 
@@ -473,6 +473,6 @@ void PluginLogprintf(const char* fmt, ...)
 {
 	va_list args;
 	va_start(args, fmt);
-	PawnManager::Get()->core->vprintLn(fmt, args);
+	PawnManager::Get()->logger->vprintLn(fmt, args);
 	va_end(args);
 }
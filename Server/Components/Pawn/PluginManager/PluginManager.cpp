@@ -70,7 +70,7 @@ void PawnPluginManager::Load(std::string const& name)
 	{
 		if (pluginName == brokenPlugin.name)
 		{
-			core->logLn(LogLevel::Error,
+			PawnManager::Get()->logger->logLn(LogLevel::Error,
 				"Skipping legacy plugin '%.*s'; %.*s",
 				PRINT_VIEW(brokenPlugin.name), PRINT_VIEW(brokenPlugin.message));
 			return;
@@ -116,7 +116,7 @@ void PawnPluginManager::Spawn(std::string const& name)
 		utils::Canonicalise(basePath_ + pluginPath_ + name, canon);
 	}
 
-	core->printLn("Loading plugin: %s", name.c_str());
+	PawnManager::Get()->logger->printLn("Loading plugin: %s", name.c_str());
 
 	std::unique_ptr<PawnPlugin> ptr = std::make_unique<PawnPlugin>(canon, core);
 
@@ -15,6 +15,15 @@
 
 #include <assert.h>
 #include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
 
 #include "Script.hpp"
 #include "../Manager/Manager.hpp"
@@ -46,6 +55,115 @@ extern "C"
 /// A map of per-AMX caches
 static FlatHashMap<AMX*, AMXCache*> cache;
 
+#if defined JIT
+/// Allocate a block the JIT's native code can run from, heap memory isn't executable under NX/DEP
+static void* allocExecutable(size_t size)
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+	return VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+#else
+	void* block = mmap(nullptr, size, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return block == MAP_FAILED ? nullptr : block;
+#endif
+}
+#endif
+
+static void freeExecutable(void* block, size_t size)
+{
+	if (block == nullptr)
+	{
+		return;
+	}
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+	VirtualFree(block, 0, MEM_RELEASE);
+#else
+	munmap(block, size);
+#endif
+}
+
+/// Free a program loaded by `aux_LoadProgramJIT`, like `aux_FreeProgram` does for the interpreter
+static void aux_FreeProgramJIT(AMX* amx, size_t codeSize)
+{
+	if (amx->base != nullptr)
+	{
+		amx_Cleanup(amx);
+		freeExecutable(amx->base, codeSize);
+		memset(amx, 0, sizeof(AMX));
+	}
+}
+
+/// Load a program like `aux_LoadProgram`, then compile it to native code with the runtime's JIT
+/// On failure nothing is left allocated, so the program can be loaded again for the interpreter
+/// @param codeSize Set to the size of the native block, to free it with `aux_FreeProgramJIT`
+static int aux_LoadProgramJIT(AMX* amx, char const* filename, size_t& codeSize)
+{
+#if defined JIT
+	FILE* fp = fopen(filename, "rb");
+	if (fp == nullptr)
+	{
+		return AMX_ERR_NOTFOUND;
+	}
+
+	AMX_HEADER hdr;
+	if (fread(&hdr, sizeof(hdr), 1, fp) != 1 || hdr.magic != AMX_MAGIC || hdr.size > hdr.stp)
+	{
+		fclose(fp);
+		return AMX_ERR_FORMAT;
+	}
+
+	// The JIT compiles `break` opcodes to nothing, so debug hooks would never be called. Only scripts with debug
+	// information have them, so keep those on the interpreter and a hook sees the same calls whichever is used.
+	if (hdr.flags & AMX_FLAG_DEBUG)
+	{
+		fclose(fp);
+		return AMX_ERR_DEBUG;
+	}
+
+	// The data, heap and stack follow the code in the same block, like with the interpreter.
+	unsigned char* program = static_cast<unsigned char*>(malloc(hdr.stp));
+	if (program == nullptr)
+	{
+		fclose(fp);
+		return AMX_ERR_MEMORY;
+	}
+	rewind(fp);
+	const bool read = fread(program, 1, hdr.size, fp) == size_t(hdr.size);
+	fclose(fp);
+	if (!read)
+	{
+		free(program);
+		return AMX_ERR_FORMAT;
+	}
+
+	// Ask `amx_Init` to leave the opcodes unrelocated and size the native code, instead of preparing the interpreter.
+	memset(amx, 0, sizeof(AMX));
+	amx->flags = AMX_FLAG_JITC;
+	int err = amx_Init(amx, program);
+	if (err == AMX_ERR_NONE)
+	{
+		const size_t nativeSize = amx->code_size;
+		void* native = allocExecutable(nativeSize);
+		void* reloc = malloc(amx->reloc_size);
+		err = native && reloc ? amx_InitJIT(amx, reloc, native) : AMX_ERR_MEMORY;
+		free(reloc);
+		if (err == AMX_ERR_NONE)
+		{
+			// `amx_InitJIT` copied the header and data in to the native block, which is now the program's base.
+			free(program);
+			codeSize = nativeSize;
+			return AMX_ERR_NONE;
+		}
+		amx_Cleanup(amx);
+		freeExecutable(native, nativeSize);
+	}
+	free(program);
+	memset(amx, 0, sizeof(AMX));
+	return err;
+#else
+	return AMX_ERR_INIT_JIT;
+#endif
+}
+
 void PawnScript::tryLoad(std::string const& path)
 {
 	if (loaded_)
@@ -56,7 +174,15 @@ void PawnScript::tryLoad(std::string const& path)
 		amx_FileCleanup(&amx_);
 		amx_CoreCleanup(&amx_);
 		amx_ArgsCleanup(&amx_);
-		aux_FreeProgram(&amx_);
+		if (jitCodeSize_)
+		{
+			aux_FreeProgramJIT(&amx_, jitCodeSize_);
+			jitCodeSize_ = 0;
+		}
+		else
+		{
+			aux_FreeProgram(&amx_);
+		}
 		cache.erase(&amx_);
 	}
 	loaded_ = false;
@@ -64,11 +190,29 @@ void PawnScript::tryLoad(std::string const& path)
 	{
 		return;
 	}
-	int err = aux_LoadProgram(&amx_, const_cast<char*>(path.c_str()), nullptr);
+	int err = AMX_ERR_INIT_JIT;
+	if (jit_)
+	{
+		err = aux_LoadProgramJIT(&amx_, path.c_str(), jitCodeSize_);
+		if (err == AMX_ERR_DEBUG)
+		{
+			PawnManager::Get()->logger->logLn(LogLevel::Warning, "%s was compiled with debug information, using the interpreter so debug hooks are called", path.c_str());
+			err = AMX_ERR_INIT_JIT;
+		}
+		else if (err != AMX_ERR_NONE && err != AMX_ERR_NOTFOUND)
+		{
+			PawnManager::Get()->logger->logLn(LogLevel::Warning, "Could not compile %s to native code (%s), using the interpreter", path.c_str(), aux_StrError(err));
+			err = AMX_ERR_INIT_JIT;
+		}
+	}
+	if (err == AMX_ERR_INIT_JIT)
+	{
+		err = aux_LoadProgram(&amx_, const_cast<char*>(path.c_str()), nullptr);
+	}
 	switch (err)
 	{
 	case AMX_ERR_NOTFOUND:
-		serverCore->printLn("Could not find:\n\n\t %s %s", path.c_str(),
+		PawnManager::Get()->logger->printLn("Could not find:\n\n\t %s %s", path.c_str(),
 			R"(
 While attempting to load a PAWN script, a file-not-found error was
 encountered.  This could be caused by many things:
@@ -88,7 +232,7 @@ encountered.  This could be caused by many things:
 		loaded_ = true;
 		break;
 	default:
-		serverCore->printLn("%s", aux_StrError(err));
+		PawnManager::Get()->logger->printLn("%s", aux_StrError(err));
 		break;
 	}
 	if (loaded_)
@@ -103,9 +247,11 @@ encountered.  This could be caused by many things:
 	}
 }
 
-PawnScript::PawnScript(int id, std::string const& path, ICore* core)
+PawnScript::PawnScript(int id, std::string const& path, ICore* core, bool jit)
 	: serverCore(core)
 	, loaded_(false)
+	, jit_(jit)
+	, jitCodeSize_(0)
 	, id_(id)
 {
 	tryLoad(path);
@@ -116,6 +262,11 @@ PawnScript::~PawnScript()
 	tryLoad("");
 }
 
+void PawnScript::PrintError(int err)
+{
+	PawnManager::Get()->logger->logLn(LogLevel::Error, "%s", aux_StrError(err));
+}
+
 int AMXAPI amx_GetNativeByIndex(AMX const* amx, int index, AMX_NATIVE_INFO* ret)
 {
 	AMX_HEADER*
@@ -438,7 +589,7 @@ __attribute__((noinline)) int AMXAPI amx_Register_impl(AMX* amx, const AMX_NATIV
 		}
 		else if (funcptr != NULL && PawnManager::Get()->core)
 		{
-			PawnManager::Get()->core->logLn(LogLevel::Warning, "Tried to register native which is already registered: %s", GETENTRYNAME(hdr, func));
+			PawnManager::Get()->logger->logLn(LogLevel::Warning, "Tried to register native which is already registered: %s", GETENTRYNAME(hdr, func));
 		} /* if */
 	} /* for */
 	if (err == AMX_ERR_NONE)
@@ -464,10 +615,10 @@ __attribute__((noinline)) int AMXAPI amx_Allot_impl(AMX* amx, int cells, cell* a
 
 	if (amx->stk < amx->hea + cells * sizeof(cell))
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Error, "Unable to find enough memory for your data.");
-		PawnManager::Get()->core->logLn(LogLevel::Error, "Size: %i bytes, Available space: %i bytes, Need extra size: %i bytes",
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "Unable to find enough memory for your data.");
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "Size: %i bytes, Available space: %i bytes, Need extra size: %i bytes",
 			int(amx->hea + cells * sizeof(cell)), amx->stk, int(amx->hea + cells * sizeof(cell) - amx->stk));
-		PawnManager::Get()->core->logLn(LogLevel::Error, "You can increase your available memory size by using `#pragma dynamic %i`.",
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "You can increase your available memory size by using `#pragma dynamic %i`.",
 			int(amx->hea / sizeof(cell) + cells));
 		return AMX_ERR_MEMORY;
 	}
@@ -23,6 +23,8 @@
 #include <amx/amx.h>
 #include <amx/amxaux.h>
 
+#include "../profiler.hpp"
+
 using namespace Impl;
 
 /// A struct for different AMX caches
@@ -35,7 +37,8 @@ struct AMXCache
 class PawnScript : public IPawnScript
 {
 public:
-	PawnScript(int id, std::string const& path, ICore* core);
+	/// @param jit Whether to compile the script to native code, falling back to the interpreter if that's not possible or it has debug information
+	PawnScript(int id, std::string const& path, ICore* core, bool jit = false);
 	virtual ~PawnScript();
 
 	// Wrap the AMX API.
@@ -43,7 +46,7 @@ public:
 	int Callback(cell index, cell* result, const cell* params) override { return amx_Callback(&amx_, index, result, params); }
 	int Cleanup() override { return amx_Cleanup(&amx_); }
 	int Clone(AMX* amxClone, void* data) const override { return amx_Clone(amxClone, const_cast<AMX*>(&amx_), data); }
-	int Exec(cell* retval, int index) override { return amx_Exec(&amx_, retval, index); }
+	int Exec(cell* retval, int index) override { return amx_ExecProfiled(&amx_, retval, index); }
 	int FindNative(char const* name, int* index) const override { return amx_FindNative(const_cast<AMX*>(&amx_), name, index); }
 	int FindPublic(char const* funcname, int* index) const override { return amx_FindPublic(const_cast<AMX*>(&amx_), funcname, index); }
 	int FindPubVar(char const* varname, cell* amx_addr) const override { return amx_FindPubVar(const_cast<AMX*>(&amx_), varname, amx_addr); }
@@ -100,7 +103,7 @@ public:
 	void SetFRM(cell v) override { amx_.frm = v; }
 
 	AMX* GetAMX() override { return &amx_; }
-	void PrintError(int err) override { serverCore->logLn(LogLevel::Error, "%s", aux_StrError(err)); }
+	void PrintError(int err) override;
 	int GetID() const override { return id_; }
 	bool IsLoaded() const override { return loaded_; }
 
@@ -113,6 +116,9 @@ private:
 	AMX amx_;
 	AMXCache cache_;
 	bool loaded_;
+	bool jit_;
+	/// The size of the native code block when the script was compiled with the JIT, 0 when it's interpreted
+	size_t jitCodeSize_;
 	String name_;
 
 	int id_;
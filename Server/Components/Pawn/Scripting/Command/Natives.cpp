@@ -0,0 +1,26 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include "../../commands.hpp"
+#include "../Types.hpp"
+
+SCRIPT_API(AddPlayerCommand, bool(std::string const& name, std::string const& callback, int cooldown))
+{
+	return PawnCommandImpl::Get()->addCommand(name, callback, Milliseconds(std::max(cooldown, 0)), GetAMX());
+}
+
+SCRIPT_API(RemovePlayerCommand, bool(std::string const& name))
+{
+	return PawnCommandImpl::Get()->removeCommand(name, GetAMX());
+}
+
+SCRIPT_API(IsPlayerCommandRegistered, bool(std::string const& name))
+{
+	IPlayerPool* players = PawnManager::Get()->players;
+	return players && players->getPlayerCommands().get(name) != nullptr;
+}
@@ -119,7 +119,7 @@ SCRIPT_API(GetPlayers, int(DynamicArray<int>& outputPlayers))
 	IPlayerPool* players = PawnManager::Get()->players;
 	if (outputPlayers.size() < players->entries().size())
 	{
-		PawnManager::Get()->core->printLn(
+		PawnManager::Get()->logger->printLn(
 			"There are %zu players in your server but array size used in `GetPlayers` is %zu; Use a bigger size in your script.",
 			players->entries().size(),
 			outputPlayers.size());
@@ -145,7 +145,7 @@ SCRIPT_API(GetActors, int(DynamicArray<int>& outputActors))
 	{
 		if (outputActors.size() < actors->count())
 		{
-			PawnManager::Get()->core->printLn(
+			PawnManager::Get()->logger->printLn(
 				"There are %zu actors in your server but array size used in `GetActors` is %zu; Use a bigger size in your script.",
 				actors->count(),
 				outputActors.size());
@@ -172,7 +172,7 @@ SCRIPT_API(GetVehicles, int(DynamicArray<int>& outputVehicles))
 	{
 		if (outputVehicles.size() < vehicles->count())
 		{
-			PawnManager::Get()->core->printLn(
+			PawnManager::Get()->logger->printLn(
 				"There are %zu vehicles in your server but array size used in `GetVehicles` is %zu; Use a bigger size in your script.",
 				vehicles->count(),
 				outputVehicles.size());
@@ -193,7 +193,7 @@ SCRIPT_API(GetVehicles, int(DynamicArray<int>& outputVehicles))
 
 SCRIPT_API(print, bool(const std::string& text))
 {
-	PawnManager::Get()->core->printLn("%s", text.c_str());
+	PawnManager::Get()->logger->printLn("%s", text.c_str());
 	return false;
 }
 
@@ -298,7 +298,7 @@ SCRIPT_API(DisableNameTagLOS, bool())
 
 SCRIPT_API(EnableTirePopping, bool(bool enable))
 {
-	PawnManager::Get()->core->logLn(LogLevel::Warning, "EnableTirePopping() function is removed.");
+	PawnManager::Get()->logger->logLn(LogLevel::Warning, "EnableTirePopping() function is removed.");
 	return true;
 }
 
@@ -352,7 +352,7 @@ int getConfigOptionAsInt(std::string const& cvar)
 	{
 		if (res.first)
 		{
-			PawnManager::Get()->core->logLn(LogLevel::Warning, "Deprecated console variable \"%s\", use \"%.*s\" instead.", cvar.c_str(), PRINT_VIEW(res.second));
+			PawnManager::Get()->logger->logLn(LogLevel::Warning, "Deprecated console variable \"%s\", use \"%.*s\" instead.", cvar.c_str(), PRINT_VIEW(res.second));
 		}
 		if (!(v1 = config->getInt(res.second)))
 		{
@@ -372,7 +372,7 @@ int getConfigOptionAsInt(std::string const& cvar)
 	}
 	else if (v0)
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Warning, "Boolean console variable \"%s\" retreived as integer.", cvar.c_str());
+		PawnManager::Get()->logger->logLn(LogLevel::Warning, "Boolean console variable \"%s\" retreived as integer.", cvar.c_str());
 		return *v0;
 	}
 	else
@@ -391,7 +391,7 @@ bool getConfigOptionAsBool(std::string const& cvar)
 	{
 		if (res.first)
 		{
-			PawnManager::Get()->core->logLn(LogLevel::Warning, "Deprecated console variable \"%s\", use \"%.*s\" instead.", cvar.c_str(), PRINT_VIEW(res.second));
+			PawnManager::Get()->logger->logLn(LogLevel::Warning, "Deprecated console variable \"%s\", use \"%.*s\" instead.", cvar.c_str(), PRINT_VIEW(res.second));
 		}
 		if (!(v0 = config->getBool(res.second)))
 		{
@@ -411,7 +411,7 @@ bool getConfigOptionAsBool(std::string const& cvar)
 	}
 	else if (v1)
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Warning, "Integer console variable \"%s\" retreived as boolean.", cvar.c_str());
+		PawnManager::Get()->logger->logLn(LogLevel::Warning, "Integer console variable \"%s\" retreived as boolean.", cvar.c_str());
 		return *v1 != 0;
 	}
 	else
@@ -429,7 +429,7 @@ float getConfigOptionAsFloat(std::string const& cvar)
 	{
 		if (res.first)
 		{
-			PawnManager::Get()->core->logLn(LogLevel::Warning, "Deprecated console variable \"%s\", use \"%.*s\" instead.", cvar.c_str(), PRINT_VIEW(res.second));
+			PawnManager::Get()->logger->logLn(LogLevel::Warning, "Deprecated console variable \"%s\", use \"%.*s\" instead.", cvar.c_str(), PRINT_VIEW(res.second));
 		}
 		var = config->getFloat(res.second);
 	}
@@ -458,7 +458,7 @@ int getConfigOptionAsString(std::string const& cvar, OutputOnlyString& buffer)
 	{
 		if (res.first)
 		{
-			PawnManager::Get()->core->logLn(LogLevel::Warning, "Deprecated console variable \"%s\", use \"%.*s\" instead.", cvar.c_str(), PRINT_VIEW(res.second));
+			PawnManager::Get()->logger->logLn(LogLevel::Warning, "Deprecated console variable \"%s\", use \"%.*s\" instead.", cvar.c_str(), PRINT_VIEW(res.second));
 		}
 		if (gm)
 		{
@@ -692,6 +692,13 @@ SCRIPT_API(SendPlayerMessageToAllf, bool(IPlayer& sender, cell const* format))
 	return true;
 }
 
+SCRIPT_API(SendPlayerMessageInRange, bool(IPlayer& sender, float range, cell const* format))
+{
+	AmxStringFormatter message(format, GetAMX(), GetParams(), 3);
+	PawnManager::Get()->players->sendChatMessageInRange(sender, message, range);
+	return true;
+}
+
 SCRIPT_API(SendRconCommand, bool(cell const* format))
 {
 	IConsoleComponent* console = PawnManager::Get()->console;
@@ -763,7 +770,7 @@ SCRIPT_API(SetWorldTime, bool(int hour))
 
 SCRIPT_API(SHA256_PassHash, int(std::string const& password, std::string const& salt, OutputOnlyString& output))
 {
-	PawnManager::Get()->core->logLn(LogLevel::Warning, "Using unsafe hashing function SHA256_PassHash");
+	PawnManager::Get()->logger->logLn(LogLevel::Warning, "Using unsafe hashing function SHA256_PassHash");
 
 	// Scope-allocated string, copy it
 	StaticArray<char, 64 + 1> hash;
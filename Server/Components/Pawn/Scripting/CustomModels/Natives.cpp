@@ -58,7 +58,7 @@ SCRIPT_API(RedirectDownload, bool(IPlayer& player, std::string const& url))
 	}
 	if (!data->sendDownloadUrl(url))
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Warning, "This native can be used only within OnPlayerRequestDownload callback.");
+		PawnManager::Get()->logger->logLn(LogLevel::Warning, "This native can be used only within OnPlayerRequestDownload callback.");
 		return false;
 	}
 	return true;
@@ -10,6 +10,7 @@
 #include "sdk.hpp"
 #include <ghc/filesystem.hpp>
 #include "../../format.hpp"
+#include "../../database_queries.hpp"
 
 static int getFlags(cell* params)
 {
@@ -312,6 +313,91 @@ SCRIPT_API(DB_GetLegacyDBResult, int(IDatabaseResultSet& result))
 }
 #endif
 
+SCRIPT_API(DB_PrepareStatement, int(IDatabaseConnection& db, const std::string& query))
+{
+	IDatabaseStatement* database_statement(db.prepareStatement(query));
+	return database_statement ? database_statement->getID() : 0;
+}
+
+SCRIPT_API(DB_FreeStatement, bool(IDatabaseStatement& statement))
+{
+	return PawnManager::Get()->databases->freeStatement(statement);
+}
+
+SCRIPT_API(DB_GetParameterIndex, int(IDatabaseStatement& statement, const std::string& parameter))
+{
+	return statement.getParameterIndex(parameter);
+}
+
+SCRIPT_API(DB_BindInt, bool(IDatabaseStatement& statement, int parameter, int value))
+{
+	return statement.bindInt(parameter, value);
+}
+
+SCRIPT_API(DB_BindFloat, bool(IDatabaseStatement& statement, int parameter, float value))
+{
+	return statement.bindFloat(parameter, value);
+}
+
+SCRIPT_API(DB_BindString, bool(IDatabaseStatement& statement, int parameter, const std::string& value))
+{
+	return statement.bindString(parameter, value);
+}
+
+SCRIPT_API(DB_BindNull, bool(IDatabaseStatement& statement, int parameter))
+{
+	return statement.bindNull(parameter);
+}
+
+SCRIPT_API(DB_ClearBindings, bool(IDatabaseStatement& statement))
+{
+	statement.clearBindings();
+	return true;
+}
+
+SCRIPT_API(DB_ExecuteStatement, int(IDatabaseStatement& statement))
+{
+	IDatabaseResultSet* database_result_set(statement.execute());
+	return database_result_set ? database_result_set->getID() : 0;
+}
+
+SCRIPT_API(DB_ExecuteQueryAsync, bool(IDatabaseConnection& db, const std::string& query, const std::string& callback, const std::string& format))
+{
+	return PawnDatabaseQueries::Get()->executeQueryAsync(db, query, callback, format.c_str(), GetAMX(), &GetParams()[5]);
+}
+
+SCRIPT_API(DB_QueueWrite, bool(IDatabaseConnection& db, cell const* format))
+{
+	AmxStringFormatter query(format, GetAMX(), GetParams(), 2);
+	return db.queueWrite(query);
+}
+
+SCRIPT_API(DB_FlushWrites, bool(IDatabaseConnection& db))
+{
+	return db.flushWrites();
+}
+
+SCRIPT_API(DB_GetWriteBatchStats, bool(IDatabaseConnection& db, int& batches, int& queries, int& failedQueries, int& lastLatency, int& maxLatency))
+{
+	const DatabaseWriteBatchStats& stats = db.getWriteBatchStats();
+	batches = static_cast<int>(stats.batches);
+	queries = static_cast<int>(stats.queries);
+	failedQueries = static_cast<int>(stats.failedQueries);
+	lastLatency = static_cast<int>(stats.lastLatency.count());
+	maxLatency = static_cast<int>(stats.maxLatency.count());
+	return true;
+}
+
+SCRIPT_API(DB_ApplyDurabilitySettings, bool(IDatabaseConnection& db))
+{
+	return db.applyDurabilitySettings();
+}
+
+SCRIPT_API(DB_GetDatabaseStatementCount, int())
+{
+	return static_cast<int>(PawnManager::Get()->databases->getDatabaseStatementCount());
+}
+
 SCRIPT_API(DB_GetDatabaseConnectionCount, int())
 {
 	return static_cast<int>(PawnManager::Get()->databases->getDatabaseConnectionCount());
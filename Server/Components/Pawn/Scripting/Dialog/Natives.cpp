@@ -28,7 +28,7 @@ SCRIPT_API(ShowPlayerDialog, bool(IPlayer& player, int dialog, int style, const
 		static bool warned = false;
 		if (!warned)
 		{
-			PawnManager::Get()->core->logLn(LogLevel::Warning, "Invalid dialog ID %d used.  Use `HidePlayerDialog()`.", dialog);
+			PawnManager::Get()->logger->logLn(LogLevel::Warning, "Invalid dialog ID %d used.  Use `HidePlayerDialog()`.", dialog);
 			warned = true;
 		}
 
@@ -16,6 +16,7 @@
 #include "Menu/Events.hpp"
 #include "Object/Events.hpp"
 #include "Pickup/Events.hpp"
+#include "Playback/Events.hpp"
 #include "Player/Events.hpp"
 #include "TextDraw/Events.hpp"
 #include "Vehicle/Events.hpp"
@@ -68,6 +69,10 @@ Scripting::~Scripting()
 	{
 		mgr->pickups->getEventDispatcher().removeEventHandler(PickupEvents::Get());
 	}
+	if (mgr->playback)
+	{
+		mgr->playback->getEventDispatcher().removeEventHandler(PlaybackEvents::Get());
+	}
 	if (mgr->vehicles)
 	{
 		mgr->vehicles->getEventDispatcher().removeEventHandler(VehicleEvents::Get());
@@ -136,6 +141,10 @@ void Scripting::addEvents() const
 	{
 		mgr->pickups->getEventDispatcher().addEventHandler(PickupEvents::Get());
 	}
+	if (mgr->playback)
+	{
+		mgr->playback->getEventDispatcher().addEventHandler(PlaybackEvents::Get());
+	}
 	if (mgr->vehicles)
 	{
 		mgr->vehicles->getEventDispatcher().addEventHandler(VehicleEvents::Get());
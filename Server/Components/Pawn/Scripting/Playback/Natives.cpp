@@ -0,0 +1,65 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include "../Types.hpp"
+#include "Server/Components/Playback/playback.hpp"
+
+SCRIPT_API(ConnectPlaybackBot, int(std::string const& name))
+{
+	IPlaybackComponent* playback = PawnManager::Get()->playback;
+	if (playback)
+	{
+		IPlayer* bot = playback->connectBot(name);
+		if (bot)
+		{
+			return bot->getID();
+		}
+	}
+	return INVALID_PLAYER_ID;
+}
+
+SCRIPT_API(StartBotPlayback, bool(IPlayer& player, std::string const& file, float speed, bool loop))
+{
+	IPlaybackComponent* playback = PawnManager::Get()->playback;
+	if (playback)
+	{
+		return playback->startPlayback(player, file, speed, loop);
+	}
+	return false;
+}
+
+SCRIPT_API(StopBotPlayback, bool(IPlayer& player))
+{
+	IPlaybackComponent* playback = PawnManager::Get()->playback;
+	if (playback && playback->isPlaying(player))
+	{
+		playback->stopPlayback(player);
+		return true;
+	}
+	return false;
+}
+
+SCRIPT_API(IsBotPlayingBack, bool(IPlayer& player))
+{
+	IPlaybackComponent* playback = PawnManager::Get()->playback;
+	if (playback)
+	{
+		return playback->isPlaying(player);
+	}
+	return false;
+}
+
+SCRIPT_API(SetBotPlaybackSpeed, bool(IPlayer& player, float speed))
+{
+	IPlaybackComponent* playback = PawnManager::Get()->playback;
+	if (playback)
+	{
+		return playback->setPlaybackSpeed(player, speed);
+	}
+	return false;
+}
@@ -39,6 +39,13 @@ SCRIPT_API(SendClientMessageToAllf, bool(uint32_t colour, cell const* format))
 	return true;
 }
 
+SCRIPT_API(SendClientMessageInRange, bool(IPlayer& player, uint32_t colour, float range, cell const* format))
+{
+	AmxStringFormatter msg(format, GetAMX(), GetParams(), 4);
+	PawnManager::Get()->players->sendClientMessageInRange(player, Colour::FromRGBA(colour), msg, range);
+	return true;
+}
+
 SCRIPT_API(SetPlayerCameraPos, bool(IPlayer& player, Vector3 vec))
 {
 	player.setCameraPosition(vec);
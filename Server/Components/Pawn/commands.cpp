@@ -0,0 +1,111 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include "commands.hpp"
+
+bool PawnCommandHandler::onPlayerCommand(IPlayer& player, StringView name, StringView params, Span<const StringView> args)
+{
+	// Check if the script is still loaded.
+	auto& amx_map = PawnManager::Get()->amxToScript_;
+	auto script_itr = amx_map.find(amx);
+	if (script_itr == amx_map.end())
+	{
+		return false;
+	}
+	// The public can remove this command, which mustn't free the handler while it's still running.
+	PawnCommandImpl::Get()->beginDispatch();
+	const bool ret = !!script_itr->second->Call(callback, DefaultReturnValue_False, player.getID(), params);
+	PawnCommandImpl::Get()->endDispatch();
+	return ret;
+}
+
+bool PawnCommandImpl::addCommand(StringView name, StringView callback, Milliseconds cooldown, AMX* amx)
+{
+	IPlayerPool* players = PawnManager::Get()->players;
+	if (!players || !amx)
+	{
+		return false;
+	}
+
+	std::unique_ptr<PawnCommandHandler> handler(new PawnCommandHandler());
+	handler->amx = amx;
+	handler->name = String(name);
+	handler->callback = String(callback);
+	if (!players->getPlayerCommands().add(name, *handler, cooldown))
+	{
+		return false;
+	}
+	handlers.push_back(std::move(handler));
+	return true;
+}
+
+bool PawnCommandImpl::removeCommand(StringView name, AMX* amx)
+{
+	IPlayerPool* players = PawnManager::Get()->players;
+	if (!players)
+	{
+		return false;
+	}
+
+	IPlayerCommands& commands = players->getPlayerCommands();
+	PlayerCommandHandler* registered = commands.get(name);
+	auto it = std::find_if(handlers.begin(), handlers.end(), [registered](const std::unique_ptr<PawnCommandHandler>& handler)
+		{
+			return handler.get() == registered;
+		});
+	if (registered == nullptr || it == handlers.end() || (*it)->amx != amx)
+	{
+		return false;
+	}
+
+	commands.remove(name);
+	release(it);
+	return true;
+}
+
+void PawnCommandImpl::removeCommands(AMX* amx)
+{
+	IPlayerPool* players = PawnManager::Get()->players;
+	for (auto it = handlers.begin(); it != handlers.end();)
+	{
+		if ((*it)->amx == amx)
+		{
+			if (players)
+			{
+				players->getPlayerCommands().remove((*it)->name);
+			}
+			it = release(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+void PawnCommandImpl::beginDispatch()
+{
+	++dispatching;
+}
+
+void PawnCommandImpl::endDispatch()
+{
+	if (--dispatching == 0)
+	{
+		released.clear();
+	}
+}
+
+DynamicArray<std::unique_ptr<PawnCommandHandler>>::iterator PawnCommandImpl::release(DynamicArray<std::unique_ptr<PawnCommandHandler>>::iterator it)
+{
+	if (dispatching)
+	{
+		released.push_back(std::move(*it));
+	}
+	return handlers.erase(it);
+}
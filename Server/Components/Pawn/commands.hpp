@@ -0,0 +1,50 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include "Manager/Manager.hpp"
+#include <amx/amx.h>
+
+/// A command registered by a script, calls its public with the player and the parameters
+struct PawnCommandHandler final : PlayerCommandHandler
+{
+	AMX* amx = nullptr;
+	String name;
+	String callback;
+
+	bool onPlayerCommand(IPlayer& player, StringView name, StringView params, Span<const StringView> args) override;
+};
+
+/// The commands scripts registered with IPlayerCommands, removed when their script is unloaded
+struct PawnCommandImpl : public Singleton<PawnCommandImpl>
+{
+	/// @return false if the name is invalid or already registered
+	bool addCommand(StringView name, StringView callback, Milliseconds cooldown, AMX* amx);
+
+	/// Remove a command registered by a script
+	/// @return false if the command doesn't exist or belongs to another script
+	bool removeCommand(StringView name, AMX* amx);
+
+	/// Remove every command a script registered
+	void removeCommands(AMX* amx);
+
+	/// Called around a command's public, so handlers removed while it runs are only freed once it returns
+	void beginDispatch();
+	void endDispatch();
+
+private:
+	/// Free a handler, or keep it until the running command returns
+	/// @return The handler after it
+	DynamicArray<std::unique_ptr<PawnCommandHandler>>::iterator release(DynamicArray<std::unique_ptr<PawnCommandHandler>>::iterator it);
+
+	DynamicArray<std::unique_ptr<PawnCommandHandler>> handlers;
+	/// Handlers removed while a command was running
+	DynamicArray<std::unique_ptr<PawnCommandHandler>> released;
+	int dispatching = 0;
+};
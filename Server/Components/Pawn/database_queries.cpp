@@ -0,0 +1,90 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include "database_queries.hpp"
+
+void PawnDatabaseQueryHandler::onDatabaseQueryExecuted(IDatabaseResultSet* resultSet)
+{
+	// The script is still loaded, as unloading it clears the ID, but look the public up again in case it was reloaded.
+	AMX* amx = scriptID ? PawnManager::Get()->AMXFromID(scriptID) : nullptr;
+	int funcidx;
+	if (amx && amx_FindPublic(amx, callback.c_str(), &funcidx) == AMX_ERR_NONE && funcidx != INT_MAX)
+	{
+		cell ret;
+		cell heap;
+		cell* physical;
+		int err = pushPawnTimerArgs(amx, args, data, heap, physical);
+		if (err == AMX_ERR_NONE)
+		{
+			amx_Push(amx, resultSet ? resultSet->getID() : 0);
+			if ((err = amx_ExecProfiled(amx, &ret, funcidx)) != AMX_ERR_NONE)
+			{
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "DB_ExecuteQueryAsync: There was a problem in calling %s: %s", callback.c_str(), aux_StrError(err));
+			}
+			if (!data.empty())
+			{
+				amx_Release(amx, heap);
+			}
+		}
+		else
+		{
+			PawnManager::Get()->logger->logLn(LogLevel::Error, "DB_ExecuteQueryAsync: Not enough space in heap for %s: %s", callback.c_str(), aux_StrError(err));
+		}
+	}
+	PawnDatabaseQueries::Get()->release(this);
+}
+
+void PawnDatabaseQueryHandler::onDatabaseQueryCancelled()
+{
+	PawnDatabaseQueries::Get()->release(this);
+}
+
+bool PawnDatabaseQueries::executeQueryAsync(IDatabaseConnection& db, StringView query, StringView callback, const char* fmt, AMX* amx, const cell* params)
+{
+	const String name(callback);
+	int funcidx;
+	if (amx_FindPublic(amx, name.c_str(), &funcidx) != AMX_ERR_NONE || funcidx == INT_MAX)
+	{
+		PawnManager::Get()->logger->logLn(LogLevel::Warning, "DB_ExecuteQueryAsync: \"public %s\" doesn't exist in your script.", name.c_str());
+		return false;
+	}
+
+	std::unique_ptr<PawnDatabaseQueryHandler> handler(new PawnDatabaseQueryHandler(PawnManager::Get()->IDFromAMX(amx), callback));
+	StringView message;
+	int err = collectPawnTimerArgs(amx, fmt, params, handler->args, handler->data, handler->refs, message);
+	if (err != AMX_ERR_NONE)
+	{
+		amx_RaiseError(amx, err);
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "DB_ExecuteQueryAsync: %.*s: %s", PRINT_VIEW(message), aux_StrError(err));
+		return false;
+	}
+
+	if (!db.executeQueryAsync(query, handler.get()))
+	{
+		return false;
+	}
+	pending.insert(handler.release());
+	return true;
+}
+
+void PawnDatabaseQueries::removeQueries(int scriptID)
+{
+	for (PawnDatabaseQueryHandler* handler : pending)
+	{
+		if (handler->scriptID == scriptID)
+		{
+			handler->scriptID = 0;
+		}
+	}
+}
+
+void PawnDatabaseQueries::release(PawnDatabaseQueryHandler* handler)
+{
+	pending.erase(handler);
+	delete handler;
+}
@@ -0,0 +1,52 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include "timers.hpp"
+
+/// A DB_ExecuteQueryAsync callback and its arguments, freed once it's been called
+struct PawnDatabaseQueryHandler final : DatabaseQueryHandler
+{
+	/// The script that queued the query, 0 once it's been unloaded so its public isn't called
+	int scriptID;
+	String callback;
+	/// The arguments in the order they're pushed, i.e. last to first
+	DynamicArray<PawnTimerArg> args;
+	/// The arrays and strings copied on to the heap for the call
+	DynamicArray<cell> data;
+	/// Offsets in to `data` of references, which aren't used after the call
+	DynamicArray<cell> refs;
+
+	PawnDatabaseQueryHandler(int scriptID, StringView callback)
+		: scriptID(scriptID)
+		, callback(callback)
+	{
+	}
+
+	void onDatabaseQueryExecuted(IDatabaseResultSet* resultSet) override;
+
+	void onDatabaseQueryCancelled() override;
+};
+
+/// The DB_ExecuteQueryAsync callbacks waiting for their results, dropped when their script is unloaded
+struct PawnDatabaseQueries : public Singleton<PawnDatabaseQueries>
+{
+	/// Queue a query with a callback in the script
+	/// @return false if the arguments are invalid or the query couldn't be queued
+	bool executeQueryAsync(IDatabaseConnection& db, StringView query, StringView callback, const char* fmt, AMX* amx, const cell* params);
+
+	/// Stop calling a script's callbacks, their queries still run
+	void removeQueries(int scriptID);
+
+	/// Forget a handler once it's been called or cancelled
+	void release(PawnDatabaseQueryHandler* handler);
+
+private:
+	FlatPtrHashSet<PawnDatabaseQueryHandler> pending;
+};
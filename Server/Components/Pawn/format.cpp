@@ -49,7 +49,7 @@
 		{                                                                                                                                              \
 			formatStr = const_cast<char*>("");                                                                                                         \
 		}                                                                                                                                              \
-		PawnManager::Get()->core->logLn(LogLevel::Error, "String formatted incorrectly - parameter: %d, total: %d, format: %s", arg, args, formatStr); \
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "String formatted incorrectly - parameter: %d, total: %d, format: %s", arg, args, formatStr); \
 		return 0;                                                                                                                                      \
 	}
 
@@ -748,13 +748,13 @@ reswitch:
 			amx_GetAddr(amx, params[arg], &cptr);
 			if (!cptr)
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Invalid vector string handle provided");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Invalid vector string handle provided");
 				return 0;
 			}
 			cell* ptr = reinterpret_cast<cell*>(*cptr);
 			if (!ptr)
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Invalid vector string handle provided (%d)", *cptr);
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Invalid vector string handle provided (%d)", *cptr);
 				return 0;
 			}
 
@@ -881,7 +881,7 @@ AmxStringFormatter::AmxStringFormatter(cell const* format, AMX* amx, cell const*
 			{
 				fmt = const_cast<char*>("");
 			}
-			PawnManager::Get()->core->logLn(LogLevel::Warning, "Insufficient specifiers given: \"%s\" does not format %u parameters.", fmt, diff);
+			PawnManager::Get()->logger->logLn(LogLevel::Warning, "Insufficient specifiers given: \"%s\" does not format %u parameters.", fmt, diff);
 		}
 	}
 }
@@ -25,7 +25,7 @@ static StaticArray<void*, NUM_AMX_FUNCS> AMX_FUNCTIONS = {
 	reinterpret_cast<void*>(&amx_Callback),
 	reinterpret_cast<void*>(&amx_Cleanup),
 	reinterpret_cast<void*>(&amx_Clone),
-	reinterpret_cast<void*>(&amx_Exec),
+	reinterpret_cast<void*>(&amx_ExecProfiled),
 	reinterpret_cast<void*>(&amx_FindNative),
 	reinterpret_cast<void*>(&amx_FindPublic),
 	reinterpret_cast<void*>(&amx_FindPubVar),
@@ -111,9 +111,11 @@ public:
 		core = c;
 		// store core instance and add event handlers
 		PawnManager::Get()->core = core;
+		PawnManager::Get()->logger = &core->getStructuredLogger().getLogger(getUID());
 		PawnManager::Get()->config = &core->getConfig();
 		PawnManager::Get()->players = &core->getPlayers();
 		PawnManager::Get()->pluginManager.core = core;
+		PawnManager::Get()->eventDispatcher.setProfiler(&core->getTickProfiler(), "PawnEventHandler");
 		core->getEventDispatcher().addEventHandler(this);
 
 		// Set AMXFILE environment variable to "{current_dir}/scriptfiles"
@@ -160,6 +162,7 @@ public:
 		mgr->menus = components->queryComponent<IMenusComponent>();
 		mgr->objects = components->queryComponent<IObjectsComponent>();
 		mgr->pickups = components->queryComponent<IPickupsComponent>();
+		mgr->playback = components->queryComponent<IPlaybackComponent>();
 		mgr->recordings = components->queryComponent<IRecordingsComponent>();
 		mgr->textdraws = components->queryComponent<ITextDrawsComponent>();
 		mgr->textlabels = components->queryComponent<ITextLabelsComponent>();
@@ -184,6 +187,12 @@ public:
 		// read values of plugins, main_scripts and side_scripts from config file
 		IConfig& config = core->getConfig();
 
+		PawnProfiler::Get()->enabled = *config.getBool("pawn.enable_profiler");
+
+		DynamicArray<StringView> jitScripts(config.getStringsCount("pawn.jit_scripts"));
+		config.getStrings("pawn.jit_scripts", Span<StringView>(jitScripts.data(), jitScripts.size()));
+		mgr->SetJITScripts(Span<const StringView>(jitScripts.data(), jitScripts.size()));
+
 		// load plugins
 		DynamicArray<StringView> plugins(config.getStringsCount("pawn.legacy_plugins"));
 		config.getStrings("pawn.legacy_plugins", Span<StringView>(plugins.data(), plugins.size()));
@@ -277,6 +286,7 @@ public:
 		COMPONENT_UNLOADED(mgr->menus)
 		COMPONENT_UNLOADED(mgr->objects)
 		COMPONENT_UNLOADED(mgr->pickups)
+		COMPONENT_UNLOADED(mgr->playback)
 		COMPONENT_UNLOADED(mgr->recordings)
 		COMPONENT_UNLOADED(mgr->textdraws)
 		COMPONENT_UNLOADED(mgr->textlabels)
@@ -294,6 +304,19 @@ public:
 			config.setStrings("pawn.main_scripts", Span<StringView>(scripts, 1));
 			config.setStrings("pawn.side_scripts", Span<StringView>());
 			config.setStrings("pawn.legacy_plugins", Span<StringView>());
+			config.setBool("pawn.enable_profiler", false);
+			config.setStrings("pawn.jit_scripts", Span<StringView>());
+		}
+		else
+		{
+			if (config.getType("pawn.enable_profiler") == ConfigOptionType_None)
+			{
+				config.setBool("pawn.enable_profiler", false);
+			}
+			if (config.getType("pawn.jit_scripts") == ConfigOptionType_None)
+			{
+				config.setStrings("pawn.jit_scripts", Span<StringView>());
+			}
 		}
 	}
 
@@ -308,6 +331,7 @@ public:
 			PawnManager::Get()->console->getEventDispatcher().removeEventHandler(this);
 		}
 		PawnManager::Destroy();
+		PawnProfiler::Destroy();
 	}
 
 	void free() override { delete this; }
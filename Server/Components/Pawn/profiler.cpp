@@ -0,0 +1,212 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include "profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+
+int AMXAPI amx_ExecProfiled(AMX* amx, cell* retval, int index)
+{
+	PawnProfiler* profiler = PawnProfiler::Get();
+	if (!profiler->running)
+	{
+		return amx_Exec(amx, retval, index);
+	}
+
+	profiler->enter(amx, false, index);
+	const int err = amx_Exec(amx, retval, index);
+	profiler->leave();
+	return err;
+}
+
+static int AMXAPI amx_CallbackProfiled(AMX* amx, cell index, cell* result, const cell* params)
+{
+	PawnProfiler* profiler = PawnProfiler::Get();
+	AMX_CALLBACK callback = profiler->getCallback(amx);
+	if (!profiler->running)
+	{
+		return callback(amx, index, result, params);
+	}
+
+	profiler->enter(amx, true, index);
+	const int err = callback(amx, index, result, params);
+	profiler->leave();
+	return err;
+}
+
+void PawnProfiler::attach(AMX* amx, StringView scriptName)
+{
+	// The AMX might be reused from a script that was unloaded, or have been seen before it was attached.
+	Script& script = scripts_[amx];
+	script.name = String(scriptName);
+	script.callback = nullptr;
+	script.publics.clear();
+	script.natives.clear();
+
+	if (enabled)
+	{
+		script.callback = amx->callback;
+		amx->callback = &amx_CallbackProfiled;
+		// Stop natives being patched in to direct calls on their first use, which would bypass the hook.
+		amx->sysreq_d = 0;
+	}
+}
+
+void PawnProfiler::detach(AMX* amx)
+{
+	auto it = scripts_.find(amx);
+	if (it != scripts_.end())
+	{
+		if (it->second.callback)
+		{
+			amx->callback = it->second.callback;
+		}
+		scripts_.erase(it);
+	}
+}
+
+AMX_CALLBACK PawnProfiler::getCallback(AMX* amx) const
+{
+	auto it = scripts_.find(amx);
+	return it == scripts_.end() || it->second.callback == nullptr ? &amx_Callback : it->second.callback;
+}
+
+void PawnProfiler::start()
+{
+	running = true;
+}
+
+void PawnProfiler::stop()
+{
+	running = false;
+}
+
+void PawnProfiler::reset()
+{
+	// Calls might be in progress, so keep the call tree and only clear the statistics.
+	for (Function& function : functions_)
+	{
+		function.calls = 0;
+		function.inclusive = Nanoseconds(0);
+		function.exclusive = Nanoseconds(0);
+	}
+	for (Node& node : nodes_)
+	{
+		node.calls = 0;
+		node.inclusive = Nanoseconds(0);
+		node.exclusive = Nanoseconds(0);
+	}
+}
+
+bool PawnProfiler::dump(const String& path) const
+{
+	FILE* file = ::fopen(path.c_str(), "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	String stack;
+	for (const Node& node : nodes_)
+	{
+		const long long us = duration_cast<Microseconds>(node.exclusive).count();
+		if (us == 0)
+		{
+			continue;
+		}
+
+		// Build the stack root first by walking up from the leaf.
+		stack.clear();
+		for (uint32_t i = &node - nodes_.data(); i != RootNode; i = nodes_[i].parent)
+		{
+			const String& name = functions_[nodes_[i].function].name;
+			stack.insert(0, stack.empty() ? name : name + ';');
+		}
+		fprintf(file, "%s %lld\n", stack.c_str(), us);
+	}
+
+	fclose(file);
+	return true;
+}
+
+void PawnProfiler::top(DynamicArray<String>& lines, size_t count) const
+{
+	DynamicArray<const Function*> sorted;
+	for (const Function& function : functions_)
+	{
+		if (function.calls)
+		{
+			sorted.push_back(&function);
+		}
+	}
+
+	count = std::min(count, sorted.size());
+	std::partial_sort(sorted.begin(), sorted.begin() + count, sorted.end(), [](const Function* a, const Function* b)
+		{
+			return a->exclusive > b->exclusive;
+		});
+
+	char line[256];
+	for (size_t i = 0; i != count; ++i)
+	{
+		const Function& function = *sorted[i];
+		snprintf(line, sizeof(line), "%-48s %10u calls %12lld us inclusive %12lld us exclusive", function.name.c_str(), function.calls,
+			static_cast<long long>(duration_cast<Microseconds>(function.inclusive).count()),
+			static_cast<long long>(duration_cast<Microseconds>(function.exclusive).count()));
+		lines.emplace_back(line);
+	}
+}
+
+uint32_t PawnProfiler::getFunction(AMX* amx, bool native, int index)
+{
+	auto script = scripts_.find(amx);
+	if (script == scripts_.end())
+	{
+		// A script that wasn't loaded by this component, e.g. by a plugin.
+		script = scripts_.emplace(amx, Script { "unknown", nullptr }).first;
+	}
+
+	FlatHashMap<int, uint32_t>& lookup = native ? script->second.natives : script->second.publics;
+	auto it = lookup.find(index);
+	if (it != lookup.end())
+	{
+		return it->second;
+	}
+
+	char name[sNAMEMAX + 1] = "";
+	if (index == AMX_EXEC_MAIN)
+	{
+		strcpy(name, "main");
+	}
+	else if (index == AMX_EXEC_CONT)
+	{
+		strcpy(name, "<sleep>");
+	}
+	else if ((native ? amx_GetNative(amx, index, name) : amx_GetPublic(amx, index, name)) != AMX_ERR_NONE)
+	{
+		snprintf(name, sizeof(name), native ? "<native %d>" : "<public %d>", index);
+	}
+
+	// Reloaded scripts reuse their functions, and so their nodes, instead of growing the tree on every load.
+	String qualified = script->second.name + ':' + name;
+	auto existing = functionLookup_.find(qualified);
+	uint32_t function;
+	if (existing == functionLookup_.end())
+	{
+		function = functions_.size();
+		functions_.emplace_back();
+		functions_.back().name = qualified;
+		functionLookup_.emplace(std::move(qualified), function);
+	}
+	else
+	{
+		function = existing->second;
+	}
+	lookup.emplace(index, function);
+	return function;
+}
@@ -0,0 +1,142 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include "Singleton.hpp"
+#include <amx/amx.h>
+#include <sdk.hpp>
+
+using namespace Impl;
+
+/// `amx_Exec` which times the public in the profiler while it's running
+int AMXAPI amx_ExecProfiled(AMX* amx, cell* retval, int index);
+
+/// Times publics, and the natives of scripts loaded while `pawn.enable_profiler` is set
+/// Calls are aggregated per call stack so they can be exported as folded stacks for flamegraphs
+struct PawnProfiler : public Singleton<PawnProfiler>
+{
+	/// Whether scripts are being profiled, checked before every public call
+	bool running = false;
+
+	/// Whether scripts should get the native hook when they're loaded, from `pawn.enable_profiler`
+	bool enabled = false;
+
+	/// Name a script's functions and hook its natives if enabled, called when it's loaded
+	void attach(AMX* amx, StringView scriptName);
+
+	/// Unhook a script and forget its functions' lookups, called when it's unloaded
+	/// Its statistics are kept and picked up again if a script with the same name is loaded
+	void detach(AMX* amx);
+
+	/// Get the native callback a script had before it was hooked
+	AMX_CALLBACK getCallback(AMX* amx) const;
+
+	void start();
+	void stop();
+	void reset();
+
+	/// Write the call stacks to a file in the folded format, one `script:public;script:native <microseconds>` per line
+	bool dump(const String& path) const;
+
+	/// Get the functions with the most exclusive time, descending
+	void top(DynamicArray<String>& lines, size_t count) const;
+
+	void enter(AMX* amx, bool native, int index)
+	{
+		const uint32_t function = getFunction(amx, native, index);
+		const uint32_t parent = frames_.empty() ? RootNode : frames_.back().node;
+		const uint64_t key = (uint64_t(parent) << 32) | function;
+		auto it = nodeLookup_.find(key);
+		uint32_t node;
+		if (it == nodeLookup_.end())
+		{
+			node = nodes_.size();
+			nodes_.push_back({ function, parent });
+			nodeLookup_.emplace(key, node);
+		}
+		else
+		{
+			node = it->second;
+		}
+
+		++functions_[function].active;
+		frames_.push_back({ node, Nanoseconds(0), Time::now() });
+	}
+
+	void leave()
+	{
+		const Nanoseconds elapsed = Time::now() - frames_.back().start;
+		const Frame frame = frames_.back();
+		frames_.pop_back();
+
+		Node& node = nodes_[frame.node];
+		++node.calls;
+		node.inclusive += elapsed;
+		node.exclusive += elapsed - frame.children;
+
+		Function& function = functions_[node.function];
+		++function.calls;
+		function.exclusive += elapsed - frame.children;
+		// Only count the outermost call of a recursive function to not add its time twice.
+		if (--function.active == 0)
+		{
+			function.inclusive += elapsed;
+		}
+
+		if (!frames_.empty())
+		{
+			frames_.back().children += elapsed;
+		}
+	}
+
+private:
+	static constexpr uint32_t RootNode = UINT32_MAX;
+
+	struct Function
+	{
+		String name;
+		unsigned calls = 0;
+		unsigned active = 0;
+		Nanoseconds inclusive = Nanoseconds(0);
+		Nanoseconds exclusive = Nanoseconds(0);
+	};
+
+	struct Node
+	{
+		uint32_t function;
+		uint32_t parent;
+		unsigned calls = 0;
+		Nanoseconds inclusive = Nanoseconds(0);
+		Nanoseconds exclusive = Nanoseconds(0);
+	};
+
+	struct Frame
+	{
+		uint32_t node;
+		Nanoseconds children;
+		TimePoint start;
+	};
+
+	struct Script
+	{
+		String name;
+		AMX_CALLBACK callback;
+		FlatHashMap<int, uint32_t> publics;
+		FlatHashMap<int, uint32_t> natives;
+	};
+
+	uint32_t getFunction(AMX* amx, bool native, int index);
+
+	FlatHashMap<AMX*, Script> scripts_;
+	DynamicArray<Function> functions_;
+	FlatHashMap<String, uint32_t> functionLookup_;
+	DynamicArray<Node> nodes_;
+	FlatHashMap<uint64_t, uint32_t> nodeLookup_;
+	DynamicArray<Frame> frames_;
+};
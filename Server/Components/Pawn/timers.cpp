@@ -7,6 +7,7 @@
  */
 
 #include "timers.hpp"
+#include <algorithm>
 
 Pair<size_t, PawnTimerHandler*> PawnTimerImpl::newTimer(const char* callback, Milliseconds interval, bool repeating, AMX* amx)
 {
@@ -19,15 +20,18 @@ Pair<size_t, PawnTimerHandler*> PawnTimerImpl::newTimer(const char* callback, Mi
 		// Also checking the callbackId value because SAMPGDK's FindPublic hook returns AMX_ERR_NONE.
 		if (amx_FindPublic(amx, callback, &callbackId) != AMX_ERR_NONE || callbackId == INT_MAX)
 		{
-			PawnManager::Get()->core->logLn(LogLevel::Warning, "SetTimer(Ex): There was a problem in creating the timer, \"public %s\" doesn't exist in your script.", callback);
+			PawnManager::Get()->logger->logLn(LogLevel::Warning, "SetTimer(Ex): There was a problem in creating the timer, \"public %s\" doesn't exist in your script.", callback);
 			return std::make_pair(0u, static_cast<PawnTimerHandler*>(nullptr));
 		}
 
-		PawnTimerHandler* handler = new PawnTimerHandler(callback, amx);
+		PawnTimerHandler* handler = allocateHandler();
+		handler->amx = amx;
+		handler->funcidx = callbackId;
+		handler->callback = StringView(callback);
 		ITimer* timer = timers->create(handler, interval, repeating);
 		if (timer == nullptr)
 		{
-			delete handler;
+			releaseHandler(handler);
 		}
 		else
 		{
@@ -50,78 +54,149 @@ int PawnTimerImpl::setTimerEx(const char* callback, Milliseconds interval, bool
 	PawnTimerHandler* handler = res.second;
 	if (res.second)
 	{
-		int err = AMX_ERR_NONE;
-		handler->fmt = fmt;
+		StringView message;
+		int err = collectPawnTimerArgs(amx, fmt, params, handler->args, handler->data, handler->refs, message);
+		if (err != AMX_ERR_NONE)
+		{
+			return newTimerExError(handler, amx, err, message);
+		}
+	}
+	return res.first;
+}
+
+int collectPawnTimerArgs(AMX* amx, const char* fmt, const cell* params, DynamicArray<PawnTimerArg>& args, DynamicArray<cell>& data, DynamicArray<cell>& refs, StringView& message)
+{
+	int err = AMX_ERR_NONE;
 
-		cell* data;
-		cell* len1;
-		int len2;
+	cell* addr;
+	cell* len1;
+	int len2;
 
-		// Collect data and parameters
-		for (size_t i = 0; fmt[i]; ++i)
+	// Collect data and parameters, building the list of values to push when the public is called.
+	for (size_t i = 0; fmt[i]; ++i)
+	{
+		switch (fmt[i])
 		{
-			switch (fmt[i])
+		case 'a':
+			++i;
+			if (fmt[i] != 'i' && fmt[i] != 'd')
+			{
+				message = "Error in pushing parameters; Array not followed by size";
+				return AMX_ERR_PARAMS;
+			}
+			if (
+				(err = amx_GetAddr(amx, params[i - 1], &addr)) != AMX_ERR_NONE || (err = amx_GetAddr(amx, params[i], &len1)) != AMX_ERR_NONE || *len1 < 1)
+			{
+				message = "Error in pushing parameters";
+				return err == AMX_ERR_NONE ? AMX_ERR_PARAMS : err;
+			}
+			// Store the offset in to the new heap data, then the size, then copy the data.
+			args.push_back({ cell(data.size() * sizeof(cell)), true });
+			args.push_back({ *len1, false });
+			data.insert(data.end(), addr, addr + *len1);
+			break;
+		case 's':
+			if ((err = amx_GetAddr(amx, params[i], &addr)) != AMX_ERR_NONE || (err = amx_StrSize(addr, &len2)) != AMX_ERR_NONE)
+			{
+				message = "Error in pushing parameters";
+				return err;
+			}
+			// Store the offset in to the new heap data, then copy the data.
+			args.push_back({ cell(data.size() * sizeof(cell)), true });
+			data.insert(data.end(), addr, addr + len2);
+			break;
+		case 'v':
+			if ((err = amx_GetAddr(amx, params[i], &addr)) != AMX_ERR_NONE)
+			{
+				message = "Error in pushing parameters";
+				return err;
+			}
+			// Store the offset in to the new heap data, then copy the data.
+			refs.push_back(data.size() * sizeof(cell));
+			args.push_back({ cell(data.size() * sizeof(cell)), true });
+			data.push_back(*addr);
+			break;
+		default:
+			if ((err = amx_GetAddr(amx, params[i], &addr)) != AMX_ERR_NONE)
 			{
-			case 'a':
-				++i;
-				if (fmt[i] != 'i' && fmt[i] != 'd')
-				{
-					err = AMX_ERR_PARAMS;
-					return newTimerExError(handler, amx, err, "Error in pushing parameters; Array not followed by size");
-				}
-				if (
-					(err = amx_GetAddr(amx, params[i - 1], &data)) != AMX_ERR_NONE || (err = amx_GetAddr(amx, params[i], &len1)) != AMX_ERR_NONE || *len1 < 1)
-				{
-					if (err == AMX_ERR_NONE)
-					{
-						err = AMX_ERR_PARAMS;
-					}
-					return newTimerExError(handler, amx, err, "Error in pushing parameters");
-				}
-				// Store the offset in to the new heap data, then the size, then copy the data.
-				handler->params.push_back(handler->data.size() * sizeof(cell));
-				handler->params.push_back(*len1);
-				handler->data.insert(handler->data.end(), data, data + *len1);
-				break;
-			case 's':
-				if ((err = amx_GetAddr(amx, params[i], &data)) != AMX_ERR_NONE || (err = amx_StrSize(data, &len2)) != AMX_ERR_NONE)
-				{
-					return newTimerExError(handler, amx, err, "Error in pushing parameters");
-				}
-				// Store the offset in to the new heap data, then copy the data.
-				handler->params.push_back(handler->data.size() * sizeof(cell));
-				handler->data.insert(handler->data.end(), data, data + len2);
-				break;
-			case 'v':
-				if ((err = amx_GetAddr(amx, params[i], &data)) != AMX_ERR_NONE)
-				{
-					return newTimerExError(handler, amx, err, "Error in pushing parameters");
-				}
-				// Store the offset in to the new heap data, then copy the data.
-				handler->params.push_back(handler->data.size() * sizeof(cell));
-				handler->data.push_back(*data);
-				break;
-			default:
-				if ((err = amx_GetAddr(amx, params[i], &data)) != AMX_ERR_NONE)
-				{
-					return newTimerExError(handler, amx, err, "Error in pushing parameters");
-				}
-				handler->params.push_back(*data);
-				break;
+				message = "Error in pushing parameters";
+				return err;
 			}
+			args.push_back({ *addr, false });
+			break;
 		}
 	}
-	return res.first;
+
+	// Arguments are pushed last first.
+	std::reverse(args.begin(), args.end());
+	return AMX_ERR_NONE;
+}
+
+int pushPawnTimerArgs(AMX* amx, const DynamicArray<PawnTimerArg>& args, const DynamicArray<cell>& data, cell& heap, cell*& physical)
+{
+	// First copy all the data in to the heap.
+	heap = 0;
+	physical = nullptr;
+	if (!data.empty())
+	{
+		int err = amx_Allot(amx, data.size(), &heap, &physical);
+		if (err != AMX_ERR_NONE)
+		{
+			return err;
+		}
+		// Copy the arrays, strings and references all at once.
+		memcpy(physical, data.data(), data.size() * sizeof(cell));
+	}
+
+	for (const PawnTimerArg& arg : args)
+	{
+		// Heap data is pushed as its address relative to DAT.
+		amx_Push(amx, arg.onHeap ? heap + arg.value : arg.value);
+	}
+	return AMX_ERR_NONE;
 }
 
 int PawnTimerImpl::newTimerExError(PawnTimerHandler* handler, AMX* amx, int err, StringView message)
 {
 	amx_RaiseError(amx, err);
-	PawnManager::Get()->core->logLn(LogLevel::Error, "SetTimerEx: %.*s: %s", PRINT_VIEW(message), aux_StrError(err));
-	delete handler;
+	PawnManager::Get()->logger->logLn(LogLevel::Error, "SetTimerEx: %.*s: %s", PRINT_VIEW(message), aux_StrError(err));
+	// The timer owns the handler, it's released when the timer is destroyed on the next tick.
+	ITimer* timer = getTimer(handler->poolID);
+	if (timer)
+	{
+		timer->kill();
+	}
 	return 0;
 }
 
+PawnTimerHandler* PawnTimerImpl::allocateHandler()
+{
+	static constexpr size_t SlabSize = 64;
+
+	if (freeHandlers.empty())
+	{
+		slabs.emplace_back(new PawnTimerHandler[SlabSize]);
+		for (size_t i = SlabSize; i--;)
+		{
+			freeHandlers.push_back(&slabs.back()[i]);
+		}
+	}
+
+	PawnTimerHandler* handler = freeHandlers.back();
+	freeHandlers.pop_back();
+	return handler;
+}
+
+void PawnTimerImpl::releaseHandler(PawnTimerHandler* handler)
+{
+	handler->amx = nullptr;
+	handler->poolID = -1;
+	handler->args.clear();
+	handler->data.clear();
+	handler->refs.clear();
+	freeHandlers.push_back(handler);
+}
+
 void PawnTimerImpl::killTimers(AMX* amx)
 {
 	for (auto& kv : pool)
@@ -133,3 +208,51 @@ void PawnTimerImpl::killTimers(AMX* amx)
 		}
 	}
 }
+
+void PawnTimerHandler::timeout(ITimer& timer)
+{
+	if (!amx)
+	{
+		return;
+	}
+
+	cell ret;
+	cell out;
+	cell* in;
+	int err = pushPawnTimerArgs(amx, args, data, out, in);
+	if (err != AMX_ERR_NONE)
+	{
+		// Not enough space in this heap.  Try again later.
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "SetTimer(Ex): Not enough space in heap for %.*s timer: %s", PRINT_VIEW(callback), aux_StrError(err));
+		amx_RaiseError(amx, err);
+		return;
+	}
+
+	if ((err = amx_ExecProfiled(amx, &ret, funcidx)) == AMX_ERR_NONE)
+	{
+		// Retrieve reference parameters for the next call.
+		for (cell offset : refs)
+		{
+			data[offset / sizeof(cell)] = *reinterpret_cast<cell*>(reinterpret_cast<char*>(in) + offset);
+		}
+	}
+	else
+	{
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "SetTimer(Ex): There was a problem in calling %.*s: %s", PRINT_VIEW(callback), aux_StrError(err));
+
+		// Raising an error here will cause the entire mode to stop executing in some cases.
+		// amx_RaiseError(amx, err);
+	}
+
+	if (!data.empty())
+	{
+		// Dispose of the entire heap data at once.
+		amx_Release(amx, out);
+	}
+}
+
+void PawnTimerHandler::free(ITimer& timer)
+{
+	PawnTimerImpl::Get()->remove(poolID);
+	PawnTimerImpl::Get()->releaseHandler(this);
+}
@@ -12,7 +12,45 @@
 #include <Impl/pool_impl.hpp>
 #include <amx/amx.h>
 
-struct PawnTimerHandler;
+/// A value pushed when a timer is called
+struct PawnTimerArg
+{
+	cell value; ///< The value, or the offset in to the copied data for heap arguments
+	bool onHeap; ///< Whether the value is relative to the data copied on to the heap
+};
+
+/// Copy the arguments of a SetTimerEx style native, described by `fmt`, in to a list of values to push
+/// @param args The values to push, in the order they're pushed, i.e. last to first
+/// @param data The arrays, strings and references to copy on to the heap for each call
+/// @param refs Offsets in to `data` of references, to copy back after each call
+/// @param message Set to a description of the error if there is one
+/// @return AMX_ERR_NONE, or the error
+int collectPawnTimerArgs(AMX* amx, const char* fmt, const cell* params, DynamicArray<PawnTimerArg>& args, DynamicArray<cell>& data, DynamicArray<cell>& refs, StringView& message);
+
+/// Copy collected arguments' data on to the heap and push them, ready to call a public
+/// @param heap Set to the heap address to release after the call, if there's any data
+/// @param physical Set to the physical address of the data on the heap
+/// @return AMX_ERR_NONE, or the error if the data doesn't fit on the heap
+int pushPawnTimerArgs(AMX* amx, const DynamicArray<PawnTimerArg>& args, const DynamicArray<cell>& data, cell& heap, cell*& physical);
+
+/// A Pawn timer's callback and arguments, recycled through PawnTimerImpl's free list so the arguments' storage is
+/// reused by later timers
+struct PawnTimerHandler final : TimerTimeOutHandler, PoolIDProvider
+{
+	AMX* amx = nullptr;
+	int funcidx = 0;
+	HybridString<sNAMEMAX + 1> callback;
+	/// The arguments in the order they're pushed, i.e. last to first
+	DynamicArray<PawnTimerArg> args;
+	/// The arrays and strings copied on to the heap for each call
+	DynamicArray<cell> data;
+	/// Offsets in to `data` of references, which are copied back after each call
+	DynamicArray<cell> refs;
+
+	void timeout(ITimer& timer) override;
+
+	void free(ITimer& timer) override;
+};
 
 struct PawnTimerImpl : public Singleton<PawnTimerImpl>
 {
@@ -36,6 +74,12 @@ private:
 	Pair<size_t, PawnTimerHandler*> newTimer(const char* callback, Milliseconds interval, bool repeating, AMX* amx);
 	int newTimerExError(PawnTimerHandler* handler, AMX* amx, int err, StringView message);
 
+	/// Take a handler from the free list, allocating a new slab of them if it's empty
+	PawnTimerHandler* allocateHandler();
+
+	/// Put a handler back in to the free list, keeping its arguments' storage
+	void releaseHandler(PawnTimerHandler* handler);
+
 	size_t insert(ITimer* timer)
 	{
 		bool wrappedOnce = false;
@@ -77,105 +121,6 @@ private:
 
 	FlatHashMap<uint32_t, ITimer*> pool;
 	uint32_t idx = 1;
-};
-
-struct PawnTimerHandler final : TimerTimeOutHandler, PoolIDProvider
-{
-	AMX* amx;
-	HybridString<sNAMEMAX + 1> callback;
-	HybridString<64> fmt;
-	DynamicArray<cell> params;
-	DynamicArray<cell> data;
-
-	PawnTimerHandler(String callback, AMX* amx)
-		: amx(amx)
-		, callback(callback)
-	{
-	}
-
-	void timeout(ITimer& timer) override
-	{
-		if (!amx)
-		{
-			return;
-		}
-
-		const bool hasParams = !fmt.empty();
-
-		// Call it.
-		// First copy all the data in to the heap.
-		cell ret;
-		cell out;
-		cell* in;
-		int err = AMX_ERR_NONE;
-		if (hasParams)
-		{
-			// Not enough space in this heap.  Try again later.
-			if ((err = amx_Allot(amx, data.size(), &out, &in)) != AMX_ERR_NONE)
-			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "SetTimer(Ex): Not enough space in heap for %.*s timer: %s", PRINT_VIEW(callback), aux_StrError(err));
-				amx_RaiseError(amx, err);
-				return;
-			}
-			if (data.data())
-			{
-				// Push the parameters (many all at once).
-				memcpy(in, data.data(), data.size() * sizeof(cell));
-			}
-			for (size_t i = params.size(); i--;)
-			{
-				switch (fmt[i])
-				{
-				case 'a':
-				case 's':
-				case 'v':
-					// Copy the data in to the heap, then push the address relative to DAT.
-					amx_Push(amx, out + params[i]);
-					break;
-				default:
-					// Just push the address.
-					amx_Push(amx, params[i]);
-					break;
-				}
-			}
-		}
-
-		int funcidx;
-		// Step 4: Call the function.
-		if ((err = amx_FindPublic(amx, callback.data(), &funcidx)) == AMX_ERR_NONE && (err = amx_Exec(amx, &ret, funcidx)) == AMX_ERR_NONE)
-		{
-			if (hasParams)
-			{
-				// Step 5: Retrieve reference parameters.
-				for (size_t i = 0, len = params.size(); i != len; ++i)
-				{
-					switch (fmt[i])
-					{
-					case 'v':
-						data[params[i] / sizeof(cell)] = *((char*)in + params[i]);
-						break;
-					}
-				}
-			}
-		}
-		else
-		{
-			PawnManager::Get()->core->logLn(LogLevel::Error, "SetTimer(Ex): There was a problem in calling %.*s: %s", PRINT_VIEW(callback), aux_StrError(err));
-
-			// Raising an error here will cause the entire mode to stop executing in some cases.
-			// amx_RaiseError(amx, err);
-		}
-
-		if (hasParams)
-		{
-			// Dispose of the entire stack at once.
-			amx_Release(amx, out);
-		}
-	}
-
-	void free(ITimer& timer) override
-	{
-		PawnTimerImpl::Get()->remove(poolID);
-		delete this;
-	}
+	DynamicArray<std::unique_ptr<PawnTimerHandler[]>> slabs;
+	DynamicArray<PawnTimerHandler*> freeHandlers;
 };
@@ -39,7 +39,7 @@ extern "C"
 	{                                                                                                                                         \
 		if (amx_NumParams(params) != (n))                                                                                                     \
 		{                                                                                                                                     \
-			PawnManager::Get()->core->logLn(LogLevel::Error, "Incorrect parameters given to `%s`: %u != %u", name, amx_NumParams(params), n); \
+			PawnManager::Get()->logger->logLn(LogLevel::Error, "Incorrect parameters given to `%s`: %u != %u", name, amx_NumParams(params), n); \
 			return 0;                                                                                                                         \
 		}                                                                                                                                     \
 	} while (0)
@@ -49,7 +49,7 @@ extern "C"
 	{                                                                                                                                           \
 		if (amx_NumParams(params) < (n))                                                                                                        \
 		{                                                                                                                                       \
-			PawnManager::Get()->core->logLn(LogLevel::Error, "Insufficient parameters given to `%s`: %u < %u", name, amx_NumParams(params), n); \
+			PawnManager::Get()->logger->logLn(LogLevel::Error, "Insufficient parameters given to `%s`: %u < %u", name, amx_NumParams(params), n); \
 			return 0;                                                                                                                           \
 		}                                                                                                                                       \
 	} while (0)
@@ -77,7 +77,7 @@ inline cell AMX_NATIVE_CALL pawn_format(AMX* amx, cell const* params)
 
 	if (num < 3)
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Error, "Incorrect parameters given to `format`: %u < %u", num, 3);
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "Incorrect parameters given to `format`: %u < %u", num, 3);
 		return -1;
 	}
 
@@ -87,7 +87,7 @@ inline cell AMX_NATIVE_CALL pawn_format(AMX* amx, cell const* params)
 	amx_GetAddr(amx, params[3], &cinput);
 	if (cinput == nullptr)
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Error, "Invalid format string given to `format`/");
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "Invalid format string given to `format`/");
 		return -1;
 	}
 
@@ -95,7 +95,7 @@ inline cell AMX_NATIVE_CALL pawn_format(AMX* amx, cell const* params)
 	{
 		char* fmt;
 		amx_StrParamChar(amx, params[3], fmt);
-		PawnManager::Get()->core->logLn(LogLevel::Error, "Invalid output length (%d) given to `format`. fmt: \"%s\"", maxlen, fmt);
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "Invalid output length (%d) given to `format`. fmt: \"%s\"", maxlen, fmt);
 		return -1;
 	}
 
@@ -114,7 +114,7 @@ inline cell AMX_NATIVE_CALL pawn_format(AMX* amx, cell const* params)
 	{
 		char* fmt;
 		amx_StrParamChar(amx, params[3], fmt);
-		PawnManager::Get()->core->logLn(LogLevel::Warning, "Insufficient specifiers given to `format`: \"%s\" < %u", fmt, num - 3);
+		PawnManager::Get()->logger->logLn(LogLevel::Warning, "Insufficient specifiers given to `format`: \"%s\" < %u", fmt, num - 3);
 	}
 
 	cell* coutput;
@@ -137,7 +137,7 @@ inline cell AMX_NATIVE_CALL pawn_printf(AMX* amx, cell const* params)
 
 	if (num < 1)
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Error, "Incorrect parameters given to `printf`: %u < %u", num, 1);
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "Incorrect parameters given to `printf`: %u < %u", num, 1);
 		return 0;
 	}
 
@@ -146,7 +146,7 @@ inline cell AMX_NATIVE_CALL pawn_printf(AMX* amx, cell const* params)
 	amx_GetAddr(amx, params[1], &cstr);
 	if (cstr == nullptr)
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Error, "Invalid format string given to `printf`/");
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "Invalid format string given to `printf`/");
 		return 0;
 	}
 
@@ -156,12 +156,12 @@ inline cell AMX_NATIVE_CALL pawn_printf(AMX* amx, cell const* params)
 	{
 		char* fmt;
 		amx_StrParamChar(amx, params[1], fmt);
-		PawnManager::Get()->core->logLn(LogLevel::Warning, "Insufficient specifiers given to `printf`: \"%s\" < %u", fmt, num - 1);
+		PawnManager::Get()->logger->logLn(LogLevel::Warning, "Insufficient specifiers given to `printf`: \"%s\" < %u", fmt, num - 1);
 	}
 
 	if (len > 0)
 	{
-		PawnManager::Get()->core->printLn("%s", buf);
+		PawnManager::Get()->logger->printLn("%s", buf);
 	}
 
 	return 0;
@@ -176,7 +176,7 @@ inline cell AMX_NATIVE_CALL pawn_settimer(AMX* amx, cell const* params)
 
 	if (params[2] < 0)
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Error, "Invalid SetTimer interval (%i) when calling: %s", params[2], callback);
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "Invalid SetTimer interval (%i) when calling: %s", params[2], callback);
 		return false;
 	}
 
@@ -192,7 +192,7 @@ inline cell AMX_NATIVE_CALL pawn_settimerex(AMX* amx, cell const* params)
 
 	if (params[2] < 0)
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Error, "Invalid SetTimerEx interval (%i) when calling: %s", params[2], callback);
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "Invalid SetTimerEx interval (%i) when calling: %s", params[2], callback);
 		return false;
 	}
 
@@ -278,7 +278,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_Call(AMX* amx, cell const* params)
 	amx_StrParamChar(amx, params[2], fmat);
 	if (num != (int)(2 + strlen(fmat)))
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Warning, "Parameter count does not match specifier in `Script_Call`. callback: %s - fmat: %s - count: %d)", name, fmat, num - 2);
+		PawnManager::Get()->logger->logLn(LogLevel::Warning, "Parameter count does not match specifier in `Script_Call`. callback: %s - fmat: %s - count: %d)", name, fmat, num - 2);
 	}
 	cell *
 		data,
@@ -291,7 +291,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_Call(AMX* amx, cell const* params)
 		case 'a':
 			if (fmat[i + 1] != 'i' && fmat[i + 1] != 'd')
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Array not followed by size in `Script_Call`");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Array not followed by size in `Script_Call`");
 				amx->hea = hea;
 				amx->stk = stk;
 				return 0;
@@ -302,7 +302,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_Call(AMX* amx, cell const* params)
 			// Just put the pointer directly.
 			if (amx_Push(amx, params[i + 3]) != AMX_ERR_NONE)
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_Call`");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_Call`");
 				amx->hea = hea;
 				amx->stk = stk;
 				return 0;
@@ -313,7 +313,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_Call(AMX* amx, cell const* params)
 			// passed by reference to varargs functions.
 			if (amx_GetAddr(amx, params[i + 3], &data) != AMX_ERR_NONE || amx_Push(amx, *data) != AMX_ERR_NONE)
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_Call`");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_Call`");
 				amx->hea = hea;
 				amx->stk = stk;
 				return 0;
@@ -324,7 +324,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_Call(AMX* amx, cell const* params)
 	cell
 		ret
 		= 0;
-	if (amx_Exec(amx, &ret, index) != AMX_ERR_NONE)
+	if (amx_ExecProfiled(amx, &ret, index) != AMX_ERR_NONE)
 	{
 		ret = 0;
 	}
@@ -347,7 +347,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallByIndex(AMX* amx, cell const* params
 	amx_StrParamChar(amx, params[2], fmat);
 	if (num != (int)(2 + strlen(fmat)))
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Warning, "Parameter count does not match specifier in `Script_CallByIndex`. callback index: %d - fmat: %s - count: %d)", index, fmat, num - 2);
+		PawnManager::Get()->logger->logLn(LogLevel::Warning, "Parameter count does not match specifier in `Script_CallByIndex`. callback index: %d - fmat: %s - count: %d)", index, fmat, num - 2);
 	}
 	cell *
 		data,
@@ -360,7 +360,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallByIndex(AMX* amx, cell const* params
 		case 'a':
 			if (fmat[i + 1] != 'i' && fmat[i + 1] != 'd')
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Array not followed by size in `Script_CallByIndex`");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Array not followed by size in `Script_CallByIndex`");
 				amx->hea = hea;
 				amx->stk = stk;
 				return 0;
@@ -371,7 +371,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallByIndex(AMX* amx, cell const* params
 			// Just put the pointer directly.
 			if (amx_Push(amx, params[i + 3]) != AMX_ERR_NONE)
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallByIndex`");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallByIndex`");
 				amx->hea = hea;
 				amx->stk = stk;
 				return 0;
@@ -382,7 +382,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallByIndex(AMX* amx, cell const* params
 			// passed by reference to varargs functions.
 			if (amx_GetAddr(amx, params[i + 3], &data) != AMX_ERR_NONE || amx_Push(amx, *data) != AMX_ERR_NONE)
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallByIndex`");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallByIndex`");
 				amx->hea = hea;
 				amx->stk = stk;
 				return 0;
@@ -393,7 +393,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallByIndex(AMX* amx, cell const* params
 	cell
 		ret
 		= 0;
-	if (amx_Exec(amx, &ret, index) != AMX_ERR_NONE)
+	if (amx_ExecProfiled(amx, &ret, index) != AMX_ERR_NONE)
 	{
 		ret = 0;
 	}
@@ -413,7 +413,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallOne(AMX* amx, cell const* params)
 	amx = PawnManager::Get()->AMXFromID(params[1]);
 	if (amx == nullptr)
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Error, "Could not find target script (%u) in `Script_CallOne`", params[1]);
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "Could not find target script (%u) in `Script_CallOne`", params[1]);
 		return 0;
 	}
 	amx_StrParamChar(amx, params[2], name);
@@ -426,7 +426,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallOne(AMX* amx, cell const* params)
 	amx_StrParamChar(amx, params[3], fmat);
 	if (num != (int)(2 + strlen(fmat)))
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Warning, "Parameter count does not match specifier in `Script_CallOne`. callback: %s - fmat: %s - count: %d)", name, fmat, num - 2);
+		PawnManager::Get()->logger->logLn(LogLevel::Warning, "Parameter count does not match specifier in `Script_CallOne`. callback: %s - fmat: %s - count: %d)", name, fmat, num - 2);
 	}
 	cell *
 		data,
@@ -439,7 +439,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallOne(AMX* amx, cell const* params)
 		case 'a':
 			if (fmat[i + 1] != 'i' && fmat[i + 1] != 'd')
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Array not followed by size in `Script_CallOne`");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Array not followed by size in `Script_CallOne`");
 				amx->hea = hea;
 				amx->stk = stk;
 				return 0;
@@ -450,7 +450,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallOne(AMX* amx, cell const* params)
 			// Just put the pointer directly.
 			if (amx_Push(amx, params[i + 4]) != AMX_ERR_NONE)
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallOne`");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallOne`");
 				amx->hea = hea;
 				amx->stk = stk;
 				return 0;
@@ -461,7 +461,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallOne(AMX* amx, cell const* params)
 			// passed by reference to varargs functions.
 			if (amx_GetAddr(amx, params[i + 4], &data) != AMX_ERR_NONE || amx_Push(amx, *data) != AMX_ERR_NONE)
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallOne`");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallOne`");
 				amx->hea = hea;
 				amx->stk = stk;
 				return 0;
@@ -472,7 +472,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallOne(AMX* amx, cell const* params)
 	cell
 		ret
 		= 0;
-	if (amx_Exec(amx, &ret, index) != AMX_ERR_NONE)
+	if (amx_ExecProfiled(amx, &ret, index) != AMX_ERR_NONE)
 	{
 		ret = 0;
 	}
@@ -490,7 +490,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallOneByIndex(AMX* amx, cell const* par
 	amx = PawnManager::Get()->AMXFromID(params[1]);
 	if (amx == nullptr)
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Error, "Could not find target script (%u) in `Script_CallOneByIndex`", params[1]);
+		PawnManager::Get()->logger->logLn(LogLevel::Error, "Could not find target script (%u) in `Script_CallOneByIndex`", params[1]);
 		return 0;
 	}
 	int
@@ -501,7 +501,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallOneByIndex(AMX* amx, cell const* par
 	amx_StrParamChar(amx, params[3], fmat);
 	if (num != (int)(2 + strlen(fmat)))
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Warning, "Parameter count does not match specifier in `Script_CallOneByIndex`. callback index: %d - fmat: %s - count: %d)", index, fmat, num - 2);
+		PawnManager::Get()->logger->logLn(LogLevel::Warning, "Parameter count does not match specifier in `Script_CallOneByIndex`. callback index: %d - fmat: %s - count: %d)", index, fmat, num - 2);
 	}
 	cell *
 		data,
@@ -514,7 +514,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallOneByIndex(AMX* amx, cell const* par
 		case 'a':
 			if (fmat[i + 1] != 'i' && fmat[i + 1] != 'd')
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Array not followed by size in `Script_CallOneByIndex`");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Array not followed by size in `Script_CallOneByIndex`");
 				amx->hea = hea;
 				amx->stk = stk;
 				return 0;
@@ -525,7 +525,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallOneByIndex(AMX* amx, cell const* par
 			// Just put the pointer directly.
 			if (amx_Push(amx, params[i + 4]) != AMX_ERR_NONE)
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallOneByIndex`");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallOneByIndex`");
 				amx->hea = hea;
 				amx->stk = stk;
 				return 0;
@@ -536,7 +536,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallOneByIndex(AMX* amx, cell const* par
 			// passed by reference to varargs functions.
 			if (amx_GetAddr(amx, params[i + 4], &data) != AMX_ERR_NONE || amx_Push(amx, *data) != AMX_ERR_NONE)
 			{
-				PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallOneByIndex`");
+				PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallOneByIndex`");
 				amx->hea = hea;
 				amx->stk = stk;
 				return 0;
@@ -547,7 +547,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallOneByIndex(AMX* amx, cell const* par
 	cell
 		ret
 		= 0;
-	if (amx_Exec(amx, &ret, index) != AMX_ERR_NONE)
+	if (amx_ExecProfiled(amx, &ret, index) != AMX_ERR_NONE)
 	{
 		ret = 0;
 	}
@@ -570,7 +570,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallAll(AMX* amx, cell const* params)
 	amx_StrParamChar(amx, params[2], fmat);
 	if (num != (int)(2 + strlen(fmat)))
 	{
-		PawnManager::Get()->core->logLn(LogLevel::Warning, "Parameter count does not match specifier in `Script_CallAll`. callback: %s - fmat: %s - count: %d)", name, fmat, num - 2);
+		PawnManager::Get()->logger->logLn(LogLevel::Warning, "Parameter count does not match specifier in `Script_CallAll`. callback: %s - fmat: %s - count: %d)", name, fmat, num - 2);
 	}
 	struct parameter_s
 	{
@@ -605,13 +605,13 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallAll(AMX* amx, cell const* params)
 			++i;
 			if (fmat[i] != 'i' && fmat[i] != 'd')
 			{
-				manager->core->logLn(LogLevel::Error, "Array not followed by size in `Script_CallAll`");
+				manager->logger->logLn(LogLevel::Error, "Array not followed by size in `Script_CallAll`");
 				return 0;
 			}
 			if (
 				amx_GetAddr(amx, params[i + 2], &data) != AMX_ERR_NONE || amx_GetAddr(amx, params[i + 3], &len1) != AMX_ERR_NONE || *len1 < 1)
 			{
-				manager->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
+				manager->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
 				return 0;
 			}
 			pushes.push_back({ data, { (size_t)*len1 } });
@@ -621,7 +621,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallAll(AMX* amx, cell const* params)
 			// Just put the pointer directly.
 			if (amx_GetAddr(amx, params[i + 3], &data) != AMX_ERR_NONE || amx_StrSize(data, &len2) != AMX_ERR_NONE)
 			{
-				manager->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
+				manager->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
 				return 0;
 			}
 			pushes.push_back({ data, { (size_t)len2 } });
@@ -632,7 +632,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallAll(AMX* amx, cell const* params)
 			// and references.
 			if (amx_GetAddr(amx, params[i + 3], &data) != AMX_ERR_NONE)
 			{
-				manager->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
+				manager->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
 				return 0;
 			}
 			pushes.push_back({ data, { 0 } });
@@ -664,7 +664,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallAll(AMX* amx, cell const* params)
 					// Copy the data to the heap, then push the address.
 					if (amx_PushArray(amx, nullptr, nullptr, pushes[i].src_, pushes[i].len_) != AMX_ERR_NONE)
 					{
-						PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
+						PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
 						goto pawn_CallRemoteFunction_gmnext;
 					}
 					break;
@@ -672,7 +672,7 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallAll(AMX* amx, cell const* params)
 					// Copy the data to the heap, then push the address.
 					if (amx_PushArray(amx, nullptr, &pushes[i].dest_, pushes[i].src_, 1) != AMX_ERR_NONE)
 					{
-						PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
+						PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
 						goto pawn_CallRemoteFunction_gmnext;
 					}
 					break;
@@ -681,14 +681,14 @@ inline cell AMX_NATIVE_CALL pawn_Script_CallAll(AMX* amx, cell const* params)
 					// passed by reference to varargs functions.
 					if (amx_Push(amx, *pushes[i].src_) != AMX_ERR_NONE)
 					{
-						PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
+						PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
 						goto pawn_CallRemoteFunction_gmnext;
 					}
 					break;
 				}
 			}
 			// Step 4: Call the function.
-			if (amx_Exec(amx, &ret, index) != AMX_ERR_NONE)
+			if (amx_ExecProfiled(amx, &ret, index) != AMX_ERR_NONE)
 				goto pawn_CallRemoteFunction_gmnext;
 			// Step 5: Copy the reference parameters back out again.
 			for (size_t j = 0; fmat[j]; ++j)
@@ -729,7 +729,7 @@ pawn_CallRemoteFunction_gmnext:
 					// Copy the data to the heap, then push the address.
 					if (amx_PushArray(amx, nullptr, nullptr, pushes[i].src_, pushes[i].len_) != AMX_ERR_NONE)
 					{
-						PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
+						PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
 						goto pawn_CallRemoteFunction_fsnext;
 					}
 					break;
@@ -737,7 +737,7 @@ pawn_CallRemoteFunction_gmnext:
 					// Copy the data to the heap, then push the address.
 					if (amx_PushArray(amx, nullptr, &pushes[i].dest_, pushes[i].src_, 1) != AMX_ERR_NONE)
 					{
-						PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
+						PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
 						goto pawn_CallRemoteFunction_fsnext;
 					}
 					break;
@@ -746,14 +746,14 @@ pawn_CallRemoteFunction_gmnext:
 					// passed by reference to varargs functions.
 					if (amx_Push(amx, *pushes[i].src_) != AMX_ERR_NONE)
 					{
-						PawnManager::Get()->core->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
+						PawnManager::Get()->logger->logLn(LogLevel::Error, "Error pushing parameters in `Script_CallAll`");
 						goto pawn_CallRemoteFunction_fsnext;
 					}
 					break;
 				}
 			}
 			// Step 4: Call the function.
-			if (amx_Exec(amx, &ret, index) != AMX_ERR_NONE)
+			if (amx_ExecProfiled(amx, &ret, index) != AMX_ERR_NONE)
 				goto pawn_CallRemoteFunction_fsnext;
 			// Step 5: Copy the reference parameters back out again.
 			for (size_t j = 0; fmat[j]; ++j)
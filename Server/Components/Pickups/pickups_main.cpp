@@ -8,6 +8,7 @@
 
 #include "pickup.hpp"
 #include <Impl/events_impl.hpp>
+#include <Impl/streaming_impl.hpp>
 #include <legacy_id_mapper.hpp>
 
 using namespace Impl;
@@ -92,7 +93,7 @@ public:
 	}
 };
 
-class PickupsComponent final : public IPickupsComponent, public PlayerConnectEventHandler, public PlayerUpdateEventHandler, public PoolEventHandler<IPlayer>
+class PickupsComponent final : public IPickupsComponent, public CoreEventHandler, public PlayerConnectEventHandler, public PlayerUpdateEventHandler, public PoolEventHandler<IPlayer>
 {
 private:
 	ICore* core = nullptr;
@@ -105,6 +106,81 @@ private:
 	StreamConfigHelper streamConfigHelper;
 	FiniteLegacyIDMapper<PICKUP_POOL_SIZE> legacyIDs_;
 
+	struct PickupStreamSnapshot
+	{
+		int id;
+		Pickup* pickup;
+		Vector3 position;
+		int virtualWorld;
+	};
+
+	struct PickupViewerSnapshot
+	{
+		IPlayer* player;
+		Vector3 position;
+		int virtualWorld;
+	};
+
+	struct PickupStreamer final : public ParallelStreamer<PickupStreamSnapshot, PickupViewerSnapshot>
+	{
+		PickupsComponent& self;
+		float maxDist = 0.f;
+
+		PickupStreamer(PickupsComponent& self)
+			: self(self)
+		{
+		}
+
+		void snapshotEntities(DynamicArray<PickupStreamSnapshot>& entities) override
+		{
+			maxDist = self.streamConfigHelper.getDistanceSqr();
+			for (IPickup* p : self.storage)
+			{
+				Pickup* pickup = static_cast<Pickup*>(p);
+				entities.push_back({ pickup->getID(), pickup, pickup->getPosition(), pickup->getVirtualWorld() });
+			}
+		}
+
+		bool snapshotViewer(IPlayer& player, PickupViewerSnapshot& viewer) override
+		{
+			if (player.getState() == PlayerState_None)
+			{
+				return false;
+			}
+			viewer = { &player, player.getPosition(), player.getVirtualWorld() };
+			return true;
+		}
+
+		bool shouldStreamIn(const PickupViewerSnapshot& viewer, const PickupStreamSnapshot& entity) const override
+		{
+			const Vector3 dist3D = entity.position - viewer.position;
+			return !entity.pickup->isPickupHiddenForPlayer(*viewer.player) && (viewer.virtualWorld == entity.virtualWorld || entity.virtualWorld == -1) && glm::dot(dist3D, dist3D) < maxDist;
+		}
+
+		bool streamedIn(const PickupViewerSnapshot& viewer, const PickupStreamSnapshot& entity) const override
+		{
+			return entity.pickup->isStreamedInForPlayer(*viewer.player);
+		}
+
+		void streamIn(IPlayer& player, const PickupStreamSnapshot& entity) override
+		{
+			Pickup* pickup = self.storage.get(entity.id);
+			if (pickup && pickup == entity.pickup)
+			{
+				pickup->streamInForPlayer(player);
+			}
+		}
+
+		void streamOut(IPlayer& player, const PickupStreamSnapshot& entity) override
+		{
+			Pickup* pickup = self.storage.get(entity.id);
+			if (pickup && pickup == entity.pickup)
+			{
+				pickup->streamOutForPlayer(player);
+			}
+		}
+	} pickupStreamer;
+
 	struct PlayerPickUpPickupEventHandler : public SingleNetworkInEventHandler
 	{
 		PickupsComponent& self;
@@ -159,7 +235,8 @@ public:
 	}
 
 	PickupsComponent()
-		: playerPickUpPickupEventHandler(*this)
+		: pickupStreamer(*this)
+		, playerPickUpPickupEventHandler(*this)
 	{
 	}
 
@@ -167,9 +244,12 @@ public:
 	{
 		this->core = core;
 		players = &core->getPlayers();
+		core->getEventDispatcher().addEventHandler(this);
 		players->getPlayerUpdateDispatcher().addEventHandler(this);
 		players->getPlayerConnectDispatcher().addEventHandler(this);
 		players->getPoolEventDispatcher().addEventHandler(this);
+		eventDispatcher.setProfiler(&core->getTickProfiler(), "PickupEventHandler");
+		storage.getEventDispatcher().setProfiler(&core->getTickProfiler(), "PickupPoolEventHandler");
 		NetCode::RPC::OnPlayerPickUpPickup::addEventHandler(*core, &playerPickUpPickupEventHandler);
 		streamConfigHelper = StreamConfigHelper(core->getConfig());
 	}
@@ -178,6 +258,7 @@ public:
 	{
 		if (core)
 		{
+			core->getEventDispatcher().removeEventHandler(this);
 			players->getPlayerUpdateDispatcher().removeEventHandler(this);
 			players->getPlayerConnectDispatcher().removeEventHandler(this);
 			players->getPoolEventDispatcher().removeEventHandler(this);
@@ -246,6 +327,7 @@ public:
 		if (pickup && !pickup->isStatic())
 		{
 			static_cast<Pickup*>(pickup)->destream();
+			pickupStreamer.remove(index);
 			storage.release(index, false);
 		}
 	}
@@ -278,37 +360,19 @@ public:
 
 	bool onPlayerUpdate(IPlayer& player, TimePoint now) override
 	{
-		const float maxDist = streamConfigHelper.getDistanceSqr();
 		if (streamConfigHelper.shouldStream(player.getID(), now))
 		{
-			const PlayerState state = player.getState();
-			if (state == PlayerState_None)
-			{
-				return true;
-			}
-			Vector3 pos = player.getPosition();
-			for (IPickup* p : storage)
-			{
-				Pickup* pickup = static_cast<Pickup*>(p);
-
-				const Vector3 dist3D = pickup->getPosition() - pos;
-				const bool shouldBeStreamedIn = !pickup->isPickupHiddenForPlayer(player) && (player.getVirtualWorld() == pickup->getVirtualWorld() || pickup->getVirtualWorld() == -1) && glm::dot(dist3D, dist3D) < maxDist;
-
-				const bool isStreamedIn = pickup->isStreamedInForPlayer(player);
-				if (!isStreamedIn && shouldBeStreamedIn)
-				{
-					pickup->streamInForPlayer(player);
-				}
-				else if (isStreamedIn && !shouldBeStreamedIn)
-				{
-					pickup->streamOutForPlayer(player);
-				}
-			}
+			pickupStreamer.queue(player);
 		}
 
 		return true;
 	}
 
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		pickupStreamer.update(*core);
+	}
+
 	virtual int toLegacyID(int zoneid) const override
 	{
 		return legacyIDs_.toLegacy(zoneid);
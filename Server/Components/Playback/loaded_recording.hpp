@@ -0,0 +1,70 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include "../Recordings/recording_format.hpp"
+#include <ghc/filesystem.hpp>
+
+/// A `.rec` file read in to memory, shared by every bot playing it so it's only read once
+/// A private copy rather than a mapping, so a script recording over the file while it plays can't pull pages from under the bots
+class LoadedRecording final : public NoCopy
+{
+public:
+	/// Read a file and check its header
+	/// @return false if the file can't be read or isn't a version 1000 or 2000 recording
+	bool open(const ghc::filesystem::path& path)
+	{
+		ghc::filesystem::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			return false;
+		}
+		const std::streamoff size = file.tellg();
+		if (size < std::streamoff(sizeof(RecordingHeader)))
+		{
+			return false;
+		}
+		data_.resize(size_t(size));
+		file.seekg(0);
+		if (!file.read(data_.data(), size))
+		{
+			data_.clear();
+			return false;
+		}
+
+		memcpy(&header_, data_.data(), sizeof(header_));
+		return (header_.version == RecordingVersionLegacy || header_.version == RecordingVersionCompact)
+			&& (header_.type == PlayerRecordingType_Driver || header_.type == PlayerRecordingType_OnFoot);
+	}
+
+	bool isCompact() const
+	{
+		return header_.version == RecordingVersionCompact;
+	}
+
+	PlayerRecordingType getType() const
+	{
+		return PlayerRecordingType(header_.type);
+	}
+
+	/// The first frame's data
+	const char* begin() const
+	{
+		return data_.data() + sizeof(RecordingHeader);
+	}
+
+	const char* end() const
+	{
+		return data_.data() + data_.size();
+	}
+
+private:
+	DynamicArray<char> data_;
+	RecordingHeader header_ = {};
+};
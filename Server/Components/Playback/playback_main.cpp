@@ -0,0 +1,539 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include "loaded_recording.hpp"
+#include <Impl/network_impl.hpp>
+#include <Server/Components/Playback/playback.hpp>
+#include <Server/Components/Vehicles/vehicles.hpp>
+#include <netcode.hpp>
+#include <sdk.hpp>
+
+/// A loaded recording with the number of bots playing it, freed when the last one stops
+struct SharedRecording
+{
+	String name;
+	LoadedRecording data;
+	unsigned users = 0;
+};
+
+struct PlaybackBot
+{
+	IPlayer* player = nullptr;
+	bool disconnecting = false;
+
+	SharedRecording* recording = nullptr;
+	const char* pos = nullptr;
+	float speed = 1.f;
+	bool loop = false;
+	/// Milliseconds into the recording, advanced by the tick time scaled by the speed
+	double clock = 0.0;
+
+	/// The next frame to send, read ahead to know when it's due
+	bool hasNext = false;
+	OnFootRecordingFrame onFootNext;
+	DriverRecordingFrame driverNext;
+	CompactRecordingCodec<OnFootRecordingFrame> onFootCodec;
+	CompactRecordingCodec<DriverRecordingFrame> driverCodec;
+};
+
+class PlaybackComponent;
+
+/// The bots' network, sync is injected into the in event dispatchers as if the bots sent it and nothing is sent back
+class PlaybackNetwork final : public Network
+{
+private:
+	PlaybackComponent& component;
+
+public:
+	PlaybackNetwork(PlaybackComponent& component)
+		: Network(256, 256)
+		, component(component)
+	{
+	}
+
+	ENetworkType getNetworkType() const override
+	{
+		return ENetworkType_Playback;
+	}
+
+	bool sendPacket(IPlayer& peer, Span<uint8_t> data, int channel, bool dispatchEvents) override
+	{
+		return peer.getNetworkData().network == this;
+	}
+
+	bool broadcastPacket(Span<uint8_t> data, int channel, const IPlayer* exceptPeer, bool dispatchEvents) override
+	{
+		return true;
+	}
+
+	bool sendRPC(IPlayer& peer, int id, Span<uint8_t> data, int channel, bool dispatchEvents) override
+	{
+		return id != INVALID_PACKET_ID && peer.getNetworkData().network == this;
+	}
+
+	bool broadcastRPC(int id, Span<uint8_t> data, int channel, const IPlayer* exceptPeer, bool dispatchEvents) override
+	{
+		return id != INVALID_PACKET_ID;
+	}
+
+	NetworkStats getStatistics(IPlayer* player = nullptr) override
+	{
+		return NetworkStats {};
+	}
+
+	unsigned getPing(const IPlayer& peer) override
+	{
+		return 0;
+	}
+
+	void disconnect(const IPlayer& peer) override;
+
+	void ban(const BanEntry& entry, Milliseconds expire = Milliseconds(0)) override
+	{
+		// Bots have no address to ban.
+	}
+
+	void unban(const BanEntry& entry) override
+	{
+	}
+
+	void update() override
+	{
+	}
+
+	/// Pass a packet from a bot to the handlers, like a network does when it receives one
+	void receivePacket(IPlayer& peer, int type, NetworkBitStream& bs)
+	{
+		const bool res = inEventDispatcher.stopAtFalse([&peer, type, &bs](NetworkInEventHandler* handler)
+			{
+				bs.SetReadOffset(8); // Ignore packet ID
+				return handler->onReceivePacket(peer, type, bs);
+			});
+
+		if (res)
+		{
+			packetInEventDispatcher.stopAtFalse(type, [&peer, &bs](SingleNetworkInEventHandler* handler)
+				{
+					bs.SetReadOffset(8); // Ignore packet ID
+					return handler->onReceive(peer, bs);
+				});
+		}
+	}
+
+	/// Pass an RPC from a bot to the handlers
+	void receiveRPC(IPlayer& peer, int id, NetworkBitStream& bs)
+	{
+		const bool res = inEventDispatcher.stopAtFalse([&peer, id, &bs](NetworkInEventHandler* handler)
+			{
+				bs.resetReadPointer();
+				return handler->onReceiveRPC(peer, id, bs);
+			});
+
+		if (res)
+		{
+			rpcInEventDispatcher.stopAtFalse(id, [&peer, &bs](SingleNetworkInEventHandler* handler)
+				{
+					bs.resetReadPointer();
+					return handler->onReceive(peer, bs);
+				});
+		}
+	}
+
+	void dispatchConnect(IPlayer& peer)
+	{
+		networkEventDispatcher.dispatch(&NetworkEventHandler::onPeerConnect, peer);
+	}
+
+	void dispatchDisconnect(IPlayer& peer)
+	{
+		networkEventDispatcher.dispatch(&NetworkEventHandler::onPeerDisconnect, peer, PeerDisconnectReason_Quit);
+	}
+};
+
+class PlaybackComponent final : public IPlaybackComponent, public CoreEventHandler
+{
+private:
+	ICore* core = nullptr;
+	PlaybackNetwork network;
+	DefaultEventDispatcher<PlaybackEventHandler> eventDispatcher;
+	StaticArray<PlaybackBot, PLAYER_POOL_SIZE> bots;
+	size_t botCount = 0;
+	uint16_t nextPort = 0;
+	FlatPtrHashMap<String, SharedRecording> recordings;
+
+	PlaybackBot* getBot(const IPlayer& player)
+	{
+		const int id = player.getID();
+		if (id < 0 || id >= PLAYER_POOL_SIZE || bots[id].player != &player)
+		{
+			return nullptr;
+		}
+		return &bots[id];
+	}
+
+	const PlaybackBot* getBot(const IPlayer& player) const
+	{
+		return const_cast<PlaybackComponent*>(this)->getBot(player);
+	}
+
+	SharedRecording* acquireRecording(StringView file)
+	{
+		String name(file);
+		auto it = recordings.find(name);
+		if (it != recordings.end())
+		{
+			++it->second->users;
+			return it->second;
+		}
+
+		SharedRecording* recording = new SharedRecording();
+		if (!recording->data.open(ghc::filesystem::absolute("scriptfiles") / ghc::filesystem::path(name + ".rec")))
+		{
+			delete recording;
+			return nullptr;
+		}
+		recording->name = name;
+		recording->users = 1;
+		recordings.emplace(name, recording);
+		return recording;
+	}
+
+	void releaseRecording(SharedRecording* recording)
+	{
+		if (--recording->users == 0)
+		{
+			recordings.erase(recording->name);
+			delete recording;
+		}
+	}
+
+	void release(PlaybackBot& bot)
+	{
+		if (bot.recording)
+		{
+			releaseRecording(bot.recording);
+			bot.recording = nullptr;
+		}
+		bot.hasNext = false;
+	}
+
+	void rewind(PlaybackBot& bot)
+	{
+		bot.pos = bot.recording->data.begin();
+		bot.clock = 0.0;
+		bot.onFootCodec.reset();
+		bot.driverCodec.reset();
+		if (bot.recording->data.getType() == PlayerRecordingType_OnFoot)
+		{
+			bot.hasNext = readFrame(bot, bot.onFootNext, bot.onFootCodec);
+		}
+		else
+		{
+			bot.hasNext = readFrame(bot, bot.driverNext, bot.driverCodec);
+		}
+	}
+
+	template <typename Frame>
+	static bool readFrame(PlaybackBot& bot, Frame& frame, CompactRecordingCodec<Frame>& codec)
+	{
+		const char* end = bot.recording->data.end();
+		if (bot.recording->data.isCompact())
+		{
+			return codec.decode(bot.pos, end, frame);
+		}
+
+		if (size_t(end - bot.pos) < sizeof(Frame))
+		{
+			return false;
+		}
+		memcpy(&frame, bot.pos, sizeof(Frame));
+		bot.pos += sizeof(Frame);
+		return true;
+	}
+
+	/// Send the last frame that's due, several can be due at once when the speed is high or a tick was slow
+	template <typename Frame>
+	void advance(PlaybackBot& bot, Frame& next, CompactRecordingCodec<Frame>& codec)
+	{
+		Frame frame;
+		bool due = false;
+		while (bot.hasNext && next.time <= bot.clock)
+		{
+			frame = next;
+			due = true;
+			bot.hasNext = readFrame(bot, next, codec);
+		}
+
+		// Finish with the bot's state before calling handlers, which can start or stop its playback.
+		bool ended = false;
+		if (!bot.hasNext)
+		{
+			if (bot.loop)
+			{
+				rewind(bot);
+			}
+			else
+			{
+				release(bot);
+				ended = true;
+			}
+		}
+
+		IPlayer& player = *bot.player;
+		if (due)
+		{
+			sendFrame(player, frame);
+		}
+		if (ended)
+		{
+			eventDispatcher.dispatch(&PlaybackEventHandler::onPlaybackEnd, player);
+		}
+	}
+
+	template <typename Packet, typename Frame>
+	void sendPacket(IPlayer& player, const Frame& frame)
+	{
+		// Frames are the sync packets' data as clients send it, after the time.
+		NetworkBitStream bs;
+		bs.writeUINT8(Packet::PacketID);
+		bs.Write(reinterpret_cast<const char*>(&frame) + sizeof(frame.time), int(sizeof(Frame) - sizeof(frame.time)));
+		network.receivePacket(player, Packet::PacketID, bs);
+	}
+
+	void sendFrame(IPlayer& player, const OnFootRecordingFrame& frame)
+	{
+		sendPacket<NetCode::Packet::PlayerFootSync>(player, frame);
+	}
+
+	void sendFrame(IPlayer& player, DriverRecordingFrame& frame)
+	{
+		// Drive the vehicle the bot was put in rather than the one that was recorded.
+		IPlayerVehicleData* vehicleData = queryExtension<IPlayerVehicleData>(player);
+		if (vehicleData && vehicleData->getVehicle())
+		{
+			frame.vehicleID = vehicleData->getVehicle()->getID();
+		}
+		sendPacket<NetCode::Packet::PlayerVehicleSync>(player, frame);
+	}
+
+	void spawn(IPlayer& player)
+	{
+		const PlayerState state = player.getState();
+		if (state == PlayerState_None || state == PlayerState_Wasted)
+		{
+			NetworkBitStream bs;
+			network.receiveRPC(player, NetCode::RPC::PlayerSpawn::PacketID, bs);
+		}
+	}
+
+public:
+	PlaybackComponent()
+		: network(*this)
+	{
+	}
+
+	StringView componentName() const override
+	{
+		return "Playback";
+	}
+
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
+	}
+
+	void onLoad(ICore* c) override
+	{
+		core = c;
+		core->getEventDispatcher().addEventHandler(this);
+		eventDispatcher.setProfiler(&core->getTickProfiler(), "PlaybackEventHandler");
+		network.setProfiler(&core->getTickProfiler());
+	}
+
+	INetwork* getNetwork() override
+	{
+		return &network;
+	}
+
+	IEventDispatcher<PlaybackEventHandler>& getEventDispatcher() override
+	{
+		return eventDispatcher;
+	}
+
+	IPlayer* connectBot(StringView name) override
+	{
+		PeerNetworkData netData {};
+		netData.network = &network;
+		netData.networkID.address.ipv6 = false;
+		PeerAddress::FromString(netData.networkID.address, "127.0.0.1");
+		netData.networkID.port = nextPort++;
+
+		PeerRequestParams params;
+		params.version = ClientVersion::ClientVersion_openmp;
+		params.versionName = "playback";
+		params.bot = true;
+		params.name = name;
+		params.serial = "";
+		params.isUsingOfficialClient = false;
+
+		Pair<NewConnectionResult, IPlayer*> result = core->getPlayers().requestPlayer(netData, params);
+		if (result.first != NewConnectionResult_Success)
+		{
+			return nullptr;
+		}
+
+		IPlayer* player = result.second;
+		PlaybackBot& bot = bots[player->getID()];
+		bot.player = player;
+		bot.disconnecting = false;
+		++botCount;
+		network.dispatchConnect(*player);
+		return player;
+	}
+
+	void disconnectBot(const IPlayer& player)
+	{
+		PlaybackBot* bot = getBot(player);
+		if (bot)
+		{
+			// The player is removed on the next tick, so whoever kicked it can still use it.
+			release(*bot);
+			bot->disconnecting = true;
+		}
+	}
+
+	bool startPlayback(IPlayer& player, StringView file, float speed, bool loop) override
+	{
+		PlaybackBot* bot = getBot(player);
+		if (!bot || bot->disconnecting || speed < 0.f)
+		{
+			return false;
+		}
+
+		SharedRecording* recording = acquireRecording(file);
+		if (!recording)
+		{
+			return false;
+		}
+
+		release(*bot);
+		bot->recording = recording;
+		bot->speed = speed;
+		bot->loop = loop;
+		rewind(*bot);
+		spawn(player);
+		return true;
+	}
+
+	void stopPlayback(IPlayer& player) override
+	{
+		PlaybackBot* bot = getBot(player);
+		if (bot)
+		{
+			release(*bot);
+		}
+	}
+
+	bool isPlaying(const IPlayer& player) const override
+	{
+		const PlaybackBot* bot = getBot(player);
+		return bot && bot->recording;
+	}
+
+	bool setPlaybackSpeed(IPlayer& player, float speed) override
+	{
+		PlaybackBot* bot = getBot(player);
+		if (!bot || !bot->recording || speed < 0.f)
+		{
+			return false;
+		}
+		bot->speed = speed;
+		return true;
+	}
+
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		if (botCount == 0)
+		{
+			return;
+		}
+
+		const double elapsedMs = elapsed.count() / 1000.0;
+		for (PlaybackBot& bot : bots)
+		{
+			if (bot.player == nullptr)
+			{
+				continue;
+			}
+
+			if (bot.disconnecting)
+			{
+				IPlayer& player = *bot.player;
+				bot.player = nullptr;
+				bot.disconnecting = false;
+				--botCount;
+				network.dispatchDisconnect(player);
+				continue;
+			}
+
+			if (!bot.recording)
+			{
+				continue;
+			}
+
+			bot.clock += elapsedMs * bot.speed;
+			if (bot.recording->data.getType() == PlayerRecordingType_OnFoot)
+			{
+				advance(bot, bot.onFootNext, bot.onFootCodec);
+			}
+			else
+			{
+				advance(bot, bot.driverNext, bot.driverCodec);
+			}
+		}
+	}
+
+	void reset() override
+	{
+		// Scripts connect their bots again when they're loaded.
+		for (PlaybackBot& bot : bots)
+		{
+			if (bot.player)
+			{
+				bot.player->kick();
+			}
+		}
+	}
+
+	void free() override
+	{
+		delete this;
+	}
+
+	~PlaybackComponent()
+	{
+		for (PlaybackBot& bot : bots)
+		{
+			release(bot);
+		}
+		if (core)
+		{
+			core->getEventDispatcher().removeEventHandler(this);
+		}
+	}
+};
+
+void PlaybackNetwork::disconnect(const IPlayer& peer)
+{
+	component.disconnectBot(peer);
+}
+
+COMPONENT_ENTRY_POINT()
+{
+	return new PlaybackComponent();
+}
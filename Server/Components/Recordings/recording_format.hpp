@@ -0,0 +1,240 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <Server/Components/Recordings/recordings.hpp>
+#include <sdk.hpp>
+#include <cstddef>
+#include <cstring>
+
+using namespace Impl;
+
+/// `.rec` files start with a version and the recording type, both uint32
+/// Version 1000 is SA-MP's format that NPCs play back: every frame is written whole, in the layouts below
+/// Version 2000 is the compact format: every frame is a varint of the milliseconds since the previous one, a varint mask of
+/// the fields that changed since the previous frame, then the changed fields' bytes in the layout's order
+/// Frames are compared with an all-zero frame before the first one
+static constexpr uint32_t RecordingVersionLegacy = 1000;
+static constexpr uint32_t RecordingVersionCompact = 2000;
+
+#pragma pack(push, 1)
+struct RecordingHeader
+{
+	uint32_t version;
+	uint32_t type;
+};
+
+/// One on foot frame of a version 1000 recording
+struct OnFootRecordingFrame
+{
+	uint32_t time;
+	uint16_t leftRight;
+	uint16_t upDown;
+	uint16_t keys;
+	float position[3];
+	float rotation[4];
+	uint8_t health;
+	uint8_t armour;
+	uint8_t weaponAdditionalKey;
+	uint8_t specialAction;
+	float velocity[3];
+	float surfingOffset[3];
+	uint16_t surfingID;
+	uint16_t animationID;
+	uint16_t animationFlags;
+};
+
+/// One driver frame of a version 1000 recording
+struct DriverRecordingFrame
+{
+	uint32_t time;
+	uint16_t vehicleID;
+	uint16_t leftRight;
+	uint16_t upDown;
+	uint16_t keys;
+	float rotation[4];
+	float position[3];
+	float velocity[3];
+	float health;
+	uint8_t playerHealth;
+	uint8_t playerArmour;
+	uint8_t additionalKeyWeapon;
+	uint8_t siren;
+	uint8_t landingGear;
+	uint16_t trailerID;
+	uint32_t hydraThrustAngle;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(RecordingHeader) == 8, "Recording header layout changed");
+static_assert(sizeof(OnFootRecordingFrame) == 72, "On foot recording frame layout changed");
+static_assert(sizeof(DriverRecordingFrame) == 67, "Driver recording frame layout changed");
+
+/// A field of a frame that's stored only when it changes in the compact format
+struct RecordingFrameField
+{
+	uint8_t offset;
+	uint8_t size;
+};
+
+template <typename Frame>
+struct RecordingFrameFields;
+
+#define RECORDING_FIELD(Frame, name) { offsetof(Frame, name), sizeof(Frame::name) }
+
+template <>
+struct RecordingFrameFields<OnFootRecordingFrame>
+{
+	static constexpr RecordingFrameField Fields[] = {
+		RECORDING_FIELD(OnFootRecordingFrame, leftRight),
+		RECORDING_FIELD(OnFootRecordingFrame, upDown),
+		RECORDING_FIELD(OnFootRecordingFrame, keys),
+		RECORDING_FIELD(OnFootRecordingFrame, position),
+		RECORDING_FIELD(OnFootRecordingFrame, rotation),
+		RECORDING_FIELD(OnFootRecordingFrame, health),
+		RECORDING_FIELD(OnFootRecordingFrame, armour),
+		RECORDING_FIELD(OnFootRecordingFrame, weaponAdditionalKey),
+		RECORDING_FIELD(OnFootRecordingFrame, specialAction),
+		RECORDING_FIELD(OnFootRecordingFrame, velocity),
+		RECORDING_FIELD(OnFootRecordingFrame, surfingOffset),
+		RECORDING_FIELD(OnFootRecordingFrame, surfingID),
+		RECORDING_FIELD(OnFootRecordingFrame, animationID),
+		RECORDING_FIELD(OnFootRecordingFrame, animationFlags),
+	};
+};
+
+template <>
+struct RecordingFrameFields<DriverRecordingFrame>
+{
+	static constexpr RecordingFrameField Fields[] = {
+		RECORDING_FIELD(DriverRecordingFrame, vehicleID),
+		RECORDING_FIELD(DriverRecordingFrame, leftRight),
+		RECORDING_FIELD(DriverRecordingFrame, upDown),
+		RECORDING_FIELD(DriverRecordingFrame, keys),
+		RECORDING_FIELD(DriverRecordingFrame, rotation),
+		RECORDING_FIELD(DriverRecordingFrame, position),
+		RECORDING_FIELD(DriverRecordingFrame, velocity),
+		RECORDING_FIELD(DriverRecordingFrame, health),
+		RECORDING_FIELD(DriverRecordingFrame, playerHealth),
+		RECORDING_FIELD(DriverRecordingFrame, playerArmour),
+		RECORDING_FIELD(DriverRecordingFrame, additionalKeyWeapon),
+		RECORDING_FIELD(DriverRecordingFrame, siren),
+		RECORDING_FIELD(DriverRecordingFrame, landingGear),
+		RECORDING_FIELD(DriverRecordingFrame, trailerID),
+		RECORDING_FIELD(DriverRecordingFrame, hydraThrustAngle),
+	};
+};
+
+#undef RECORDING_FIELD
+
+/// Appends and reads the compact format's frames, keeping the previous frame to compare with
+template <typename Frame>
+class CompactRecordingCodec
+{
+public:
+	CompactRecordingCodec()
+	{
+		reset();
+	}
+
+	void reset()
+	{
+		memset(&previous_, 0, sizeof(previous_));
+	}
+
+	/// Append a frame, at most a few bytes more than the legacy layout when everything changed
+	void encode(const Frame& frame, DynamicArray<char>& out)
+	{
+		const char* current = reinterpret_cast<const char*>(&frame);
+		const char* previous = reinterpret_cast<const char*>(&previous_);
+		uint32_t mask = 0;
+		for (size_t i = 0; i != FieldCount; ++i)
+		{
+			const RecordingFrameField& field = RecordingFrameFields<Frame>::Fields[i];
+			if (memcmp(current + field.offset, previous + field.offset, field.size) != 0)
+			{
+				mask |= 1u << i;
+			}
+		}
+
+		writeVarint(out, frame.time - previous_.time);
+		writeVarint(out, mask);
+		for (size_t i = 0; i != FieldCount; ++i)
+		{
+			if (mask & (1u << i))
+			{
+				const RecordingFrameField& field = RecordingFrameFields<Frame>::Fields[i];
+				out.insert(out.end(), current + field.offset, current + field.offset + field.size);
+			}
+		}
+		previous_ = frame;
+	}
+
+	/// Read the next frame
+	/// @return false if the data ends before the frame does
+	bool decode(const char*& pos, const char* end, Frame& frame)
+	{
+		uint32_t delta;
+		uint32_t mask;
+		if (!readVarint(pos, end, delta) || !readVarint(pos, end, mask))
+		{
+			return false;
+		}
+
+		frame = previous_;
+		frame.time += delta;
+		char* current = reinterpret_cast<char*>(&frame);
+		for (size_t i = 0; i != FieldCount; ++i)
+		{
+			if (mask & (1u << i))
+			{
+				const RecordingFrameField& field = RecordingFrameFields<Frame>::Fields[i];
+				if (size_t(end - pos) < field.size)
+				{
+					return false;
+				}
+				memcpy(current + field.offset, pos, field.size);
+				pos += field.size;
+			}
+		}
+		previous_ = frame;
+		return true;
+	}
+
+private:
+	static constexpr size_t FieldCount = sizeof(RecordingFrameFields<Frame>::Fields) / sizeof(RecordingFrameField);
+	static_assert(FieldCount <= 32, "Too many fields for the change mask");
+
+	static void writeVarint(DynamicArray<char>& out, uint32_t value)
+	{
+		while (value >= 0x80)
+		{
+			out.push_back(char(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(char(value));
+	}
+
+	static bool readVarint(const char*& pos, const char* end, uint32_t& value)
+	{
+		value = 0;
+		for (int shift = 0; shift < 35 && pos != end; shift += 7)
+		{
+			const uint8_t byte = *pos++;
+			value |= uint32_t(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	Frame previous_;
+};
@@ -6,25 +6,196 @@
  *  The original code is copyright (c) 2022, open.mp team and contributors.
  */
 
-#include <Server/Components/Recordings/recordings.hpp>
+#include "recording_format.hpp"
 #include <sdk.hpp>
 #include <netcode.hpp>
 #include <ghc/filesystem.hpp>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+/// Writes recording buffers to their files on a thread, so the sync handlers never wait on the disk
+/// Buffers are written in the order they're queued, so a recording's chunks and its close stay in order
+class RecordingWriter final : public NoCopy
+{
+public:
+	/// The size a recording's buffer is handed to the writer at
+	static constexpr size_t BufferSize = 64 * 1024;
+
+	~RecordingWriter()
+	{
+		stop();
+	}
+
+	/// Queue a buffer to be appended to a file, replacing it with an empty one
+	/// @param close Whether to close the file once it's written, the file can't be used after queueing this
+	void write(FILE* file, DynamicArray<char>& data, bool close)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (!running_)
+			{
+				running_ = true;
+				thread_ = std::thread(&RecordingWriter::threadProc, this);
+			}
+
+			jobs_.push_back({ file, std::move(data), close });
+			if (spare_.empty())
+			{
+				data = DynamicArray<char>();
+			}
+			else
+			{
+				data = std::move(spare_.back());
+				spare_.pop_back();
+			}
+		}
+		wake_.notify_one();
+	}
+
+	/// Write everything queued and stop the thread
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (!running_)
+			{
+				return;
+			}
+			stopping_ = true;
+		}
+		wake_.notify_one();
+		thread_.join();
+		running_ = false;
+		stopping_ = false;
+	}
+
+private:
+	/// Buffers kept to be reused instead of growing new ones, enough for the recordings filling up at once
+	static constexpr size_t MaxSpareBuffers = 16;
+
+	struct Job
+	{
+		FILE* file;
+		DynamicArray<char> data;
+		bool close;
+	};
+
+	void threadProc()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		for (;;)
+		{
+			wake_.wait(lock, [this]()
+				{
+					return stopping_ || !jobs_.empty();
+				});
+			if (jobs_.empty())
+			{
+				break;
+			}
+
+			Job job = std::move(jobs_.front());
+			jobs_.pop_front();
+			lock.unlock();
+
+			if (!job.data.empty())
+			{
+				fwrite(job.data.data(), 1, job.data.size(), job.file);
+			}
+			if (job.close)
+			{
+				fclose(job.file);
+			}
+			else
+			{
+				// Recordings are read while they're still being written, keep the file up to date with the last chunk.
+				fflush(job.file);
+			}
+
+			lock.lock();
+			if (spare_.size() < MaxSpareBuffers)
+			{
+				job.data.clear();
+				spare_.emplace_back(std::move(job.data));
+			}
+		}
+	}
+
+	std::thread thread_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::deque<Job> jobs_;
+	DynamicArray<DynamicArray<char>> spare_;
+	bool running_ = false;
+	bool stopping_ = false;
+};
 
 class PlayerRecordingData final : public IPlayerRecordingData
 {
 private:
+	RecordingWriter& writer_;
+	const bool compact_;
 	PlayerRecordingType type_ = PlayerRecordingType_None;
 	TimePoint start_ = TimePoint();
-	std::ofstream file_;
+	FILE* file_ = nullptr;
+	DynamicArray<char> buffer_;
+	CompactRecordingCodec<OnFootRecordingFrame> onFootCodec_;
+	CompactRecordingCodec<DriverRecordingFrame> driverCodec_;
 
 	friend class RecordingsComponent;
 
+	template <typename Frame>
+	void append(const Frame& frame, CompactRecordingCodec<Frame>& codec)
+	{
+		if (compact_)
+		{
+			codec.encode(frame, buffer_);
+		}
+		else
+		{
+			const char* data = reinterpret_cast<const char*>(&frame);
+			buffer_.insert(buffer_.end(), data, data + sizeof(Frame));
+		}
+
+		if (buffer_.size() >= RecordingWriter::BufferSize)
+		{
+			flush();
+		}
+	}
+
+	/// Hand what's been recorded so far to the writer
+	void flush()
+	{
+		if (file_ && !buffer_.empty())
+		{
+			writer_.write(file_, buffer_, false);
+			buffer_.reserve(RecordingWriter::BufferSize);
+		}
+	}
+
 public:
+	PlayerRecordingData(RecordingWriter& writer, bool compact)
+		: writer_(writer)
+		, compact_(compact)
+	{
+	}
+
+	~PlayerRecordingData()
+	{
+		stop();
+	}
+
 	void start(PlayerRecordingType type, StringView file) override
 	{
+		stop();
+
 		type_ = type;
 		start_ = Time::now();
+		onFootCodec_.reset();
+		driverCodec_.reset();
 
 		ghc::filesystem::path scriptfilesPath = ghc::filesystem::absolute("scriptfiles");
 		if (!ghc::filesystem::exists(scriptfilesPath) || !ghc::filesystem::is_directory(scriptfilesPath))
@@ -32,17 +203,19 @@ public:
 			ghc::filesystem::create_directory(scriptfilesPath);
 		}
 		auto filePath = scriptfilesPath / ghc::filesystem::path(std::string(file) + ".rec");
-		file_.open(filePath.string(), std::ios_base::out | std::ios_base::binary);
+		file_ = ::fopen(filePath.string().c_str(), "wb");
 
 		// Write recording header
-		if (file_.good())
+		if (file_)
 		{
-			uint32_t version = 1000;
-			file_.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
-			file_.write(reinterpret_cast<const char*>(&type_), sizeof(uint32_t));
+			const RecordingHeader header = { compact_ ? RecordingVersionCompact : RecordingVersionLegacy, uint32_t(type_) };
+			buffer_.reserve(RecordingWriter::BufferSize);
+			const char* data = reinterpret_cast<const char*>(&header);
+			buffer_.insert(buffer_.end(), data, data + sizeof(header));
 		}
 
 		// To view/edit the recorded data as a CSV, see https://github.com/WoutProvost/samp-rec-to-csv
+		// That and NPCs only read version 1000 recordings, see `recording.compact_format`
 
 		// SA-MP server:
 		// - file already exists ==> overwrite
@@ -56,7 +229,12 @@ public:
 	{
 		type_ = PlayerRecordingType_None;
 		start_ = TimePoint();
-		file_.close();
+		if (file_)
+		{
+			writer_.write(file_, buffer_, true);
+			file_ = nullptr;
+		}
+		buffer_.clear();
 	}
 
 	void freeExtension() override
@@ -70,10 +248,16 @@ public:
 	}
 };
 
-class RecordingsComponent final : public IRecordingsComponent, public PlayerConnectEventHandler
+class RecordingsComponent final : public IRecordingsComponent, public PlayerConnectEventHandler, public CoreEventHandler
 {
 private:
 	ICore* core = nullptr;
+	RecordingWriter writer;
+	bool compactFormat = false;
+	TimePoint lastFlush;
+
+	/// How long recorded frames can wait in a player's buffer before they're written
+	static constexpr Seconds FlushInterval = Seconds(1);
 
 	struct OnFootRecordingHandler : public SingleNetworkInEventHandler
 	{
@@ -98,27 +282,25 @@ private:
 			}
 
 			// Write on foot recording data
-			if (data->type_ == PlayerRecordingType_OnFoot && data->file_.good())
-			{
-				const uint32_t timeSinceRecordStart = duration_cast<Milliseconds>(Time::now() - data->start_).count();
-				data->file_.write(reinterpret_cast<const char*>(&timeSinceRecordStart), sizeof(uint32_t));
-
-				uint8_t health = static_cast<uint8_t>(footSync.HealthArmour.x);
-				uint8_t armour = static_cast<uint8_t>(footSync.HealthArmour.y);
-				data->file_.write(reinterpret_cast<const char*>(&footSync.LeftRight), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.UpDown), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.Keys), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.Position), sizeof(float) * 3);
-				data->file_.write(reinterpret_cast<const char*>(&footSync.Rotation), sizeof(float) * 4);
-				data->file_.write(reinterpret_cast<const char*>(&health), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&armour), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.WeaponAdditionalKey), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.SpecialAction), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.Velocity), sizeof(float) * 3);
-				data->file_.write(reinterpret_cast<const char*>(&footSync.SurfingData.offset), sizeof(float) * 3);
-				data->file_.write(reinterpret_cast<const char*>(&footSync.SurfingData.ID), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.AnimationID), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.AnimationFlags), sizeof(uint16_t));
+			if (data->type_ == PlayerRecordingType_OnFoot && data->file_)
+			{
+				OnFootRecordingFrame frame;
+				frame.time = duration_cast<Milliseconds>(Time::now() - data->start_).count();
+				frame.leftRight = footSync.LeftRight;
+				frame.upDown = footSync.UpDown;
+				frame.keys = footSync.Keys;
+				memcpy(frame.position, &footSync.Position, sizeof(frame.position));
+				memcpy(frame.rotation, &footSync.Rotation, sizeof(frame.rotation));
+				frame.health = static_cast<uint8_t>(footSync.HealthArmour.x);
+				frame.armour = static_cast<uint8_t>(footSync.HealthArmour.y);
+				frame.weaponAdditionalKey = footSync.WeaponAdditionalKey;
+				frame.specialAction = footSync.SpecialAction;
+				memcpy(frame.velocity, &footSync.Velocity, sizeof(frame.velocity));
+				memcpy(frame.surfingOffset, &footSync.SurfingData.offset, sizeof(frame.surfingOffset));
+				frame.surfingID = static_cast<uint16_t>(footSync.SurfingData.ID);
+				frame.animationID = footSync.AnimationID;
+				frame.animationFlags = footSync.AnimationFlags;
+				data->append(frame, data->onFootCodec_);
 			}
 
 			return true;
@@ -148,28 +330,26 @@ private:
 			}
 
 			// Write driver recording data
-			if (data->type_ == PlayerRecordingType_Driver && data->file_.good())
-			{
-				const uint32_t timeSinceRecordStart = duration_cast<Milliseconds>(Time::now() - data->start_).count();
-				data->file_.write(reinterpret_cast<const char*>(&timeSinceRecordStart), sizeof(uint32_t));
-
-				uint8_t playerHealth = static_cast<uint8_t>(vehicleSync.PlayerHealthArmour.x);
-				uint8_t playerArmour = static_cast<uint8_t>(vehicleSync.PlayerHealthArmour.y);
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.VehicleID), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.LeftRight), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.UpDown), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.Keys), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.Rotation), sizeof(float) * 4);
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.Position), sizeof(float) * 3);
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.Velocity), sizeof(float) * 3);
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.Health), sizeof(float));
-				data->file_.write(reinterpret_cast<const char*>(&playerHealth), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&playerArmour), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.AdditionalKeyWeapon), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.Siren), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.LandingGear), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.TrailerID), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.HydraThrustAngle), sizeof(uint32_t));
+			if (data->type_ == PlayerRecordingType_Driver && data->file_)
+			{
+				DriverRecordingFrame frame;
+				frame.time = duration_cast<Milliseconds>(Time::now() - data->start_).count();
+				frame.vehicleID = vehicleSync.VehicleID;
+				frame.leftRight = vehicleSync.LeftRight;
+				frame.upDown = vehicleSync.UpDown;
+				frame.keys = vehicleSync.Keys;
+				memcpy(frame.rotation, &vehicleSync.Rotation, sizeof(frame.rotation));
+				memcpy(frame.position, &vehicleSync.Position, sizeof(frame.position));
+				memcpy(frame.velocity, &vehicleSync.Velocity, sizeof(frame.velocity));
+				frame.health = vehicleSync.Health;
+				frame.playerHealth = static_cast<uint8_t>(vehicleSync.PlayerHealthArmour.x);
+				frame.playerArmour = static_cast<uint8_t>(vehicleSync.PlayerHealthArmour.y);
+				frame.additionalKeyWeapon = vehicleSync.AdditionalKeyWeapon;
+				frame.siren = vehicleSync.Siren;
+				frame.landingGear = vehicleSync.LandingGear;
+				frame.trailerID = vehicleSync.TrailerID;
+				frame.hydraThrustAngle = vehicleSync.HydraThrustAngle;
+				data->append(frame, data->driverCodec_);
 			}
 
 			return true;
@@ -179,7 +359,25 @@ private:
 public:
 	void onPlayerConnect(IPlayer& player) override
 	{
-		player.addExtension(new PlayerRecordingData(), true);
+		player.addExtension(new PlayerRecordingData(writer, compactFormat), true);
+	}
+
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		if (now - lastFlush < FlushInterval)
+		{
+			return;
+		}
+		lastFlush = now;
+
+		for (IPlayer* player : core->getPlayers().entries())
+		{
+			PlayerRecordingData* data = queryExtension<PlayerRecordingData>(player);
+			if (data)
+			{
+				data->flush();
+			}
+		}
 	}
 
 	StringView componentName() const override
@@ -198,10 +396,24 @@ public:
 	{
 	}
 
+	void provideConfiguration(ILogger& logger, IEarlyConfig& config, bool defaults) override
+	{
+		if (defaults)
+		{
+			config.setBool("recording.compact_format", compactFormat);
+		}
+		else if (config.getType("recording.compact_format") == ConfigOptionType_None)
+		{
+			config.setBool("recording.compact_format", compactFormat);
+		}
+	}
+
 	void onLoad(ICore* c) override
 	{
 		core = c;
+		compactFormat = *core->getConfig().getBool("recording.compact_format");
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		core->getEventDispatcher().addEventHandler(this);
 		NetCode::Packet::PlayerFootSync::addEventHandler(*core, &onFootRecordingHandler);
 		NetCode::Packet::PlayerVehicleSync::addEventHandler(*core, &driverRecordingHandler);
 	}
@@ -230,7 +442,10 @@ public:
 	{
 		if (core)
 		{
+			// Close the files of recordings still going before the writer is stopped.
+			reset();
 			core->getPlayers().getPlayerConnectDispatcher().removeEventHandler(this);
+			core->getEventDispatcher().removeEventHandler(this);
 			NetCode::Packet::PlayerFootSync::removeEventHandler(*core, &onFootRecordingHandler);
 			NetCode::Packet::PlayerVehicleSync::removeEventHandler(*core, &driverRecordingHandler);
 		}
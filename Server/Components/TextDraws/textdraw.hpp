@@ -13,6 +13,45 @@
 
 using namespace Impl;
 
+/// A text draw with text changes to send at the end of the tick
+struct PendingTextUpdate
+{
+	virtual void sendTextUpdates() = 0;
+};
+
+/// The text draws with text changes waiting to be sent, so only the last change in a tick reaches the clients
+class TextUpdateQueue : public NoCopy
+{
+public:
+	void add(PendingTextUpdate& textdraw)
+	{
+		pending_.insert(&textdraw);
+	}
+
+	void remove(PendingTextUpdate& textdraw)
+	{
+		pending_.erase(&textdraw);
+	}
+
+	void flush()
+	{
+		if (pending_.empty())
+		{
+			return;
+		}
+		std::swap(pending_, flushing_);
+		for (PendingTextUpdate* textdraw : flushing_)
+		{
+			textdraw->sendTextUpdates();
+		}
+		flushing_.clear();
+	}
+
+private:
+	FlatPtrHashSet<PendingTextUpdate> pending_;
+	FlatPtrHashSet<PendingTextUpdate> flushing_;
+};
+
 template <class T>
 class TextDrawBase : public T, public PoolIDProvider, public NoCopy
 {
@@ -35,6 +74,14 @@ private:
 	Vector3 previewRotation = Vector3(0.f);
 	Pair<int, int> previewVehicleColours = std::make_pair(-1, -1);
 	float previewZoom = 1.f;
+	/// The show RPC as last written, reused until a property changes
+	DynamicArray<uint8_t> showPayload;
+	size_t showPayloadBits = 0;
+
+	void invalidateShow()
+	{
+		showPayloadBits = 0;
+	}
 
 public:
 	TextDrawBase(Vector2 pos, StringView text, TextDrawStyle style = TextDrawStyle_FontAharoniBold, int previewModel = 0)
@@ -59,6 +106,7 @@ public:
 	T& setPosition(Vector2 position) override
 	{
 		pos = position;
+		invalidateShow();
 		return *this;
 	}
 
@@ -66,6 +114,7 @@ public:
 	{
 		text = txt;
 		trimText();
+		invalidateShow();
 	}
 
 	StringView getText() const override
@@ -76,6 +125,7 @@ public:
 	T& setColour(Colour col) override
 	{
 		letterColour = col;
+		invalidateShow();
 		return *this;
 	}
 
@@ -87,6 +137,7 @@ public:
 	T& setLetterSize(Vector2 size) override
 	{
 		letterSize = size;
+		invalidateShow();
 		return *this;
 	}
 
@@ -98,6 +149,7 @@ public:
 	T& setTextSize(Vector2 size) override
 	{
 		textSize = size;
+		invalidateShow();
 		return *this;
 	}
 
@@ -109,6 +161,7 @@ public:
 	T& setAlignment(TextDrawAlignmentTypes align) override
 	{
 		alignment = align;
+		invalidateShow();
 		return *this;
 	}
 
@@ -120,6 +173,7 @@ public:
 	T& useBox(bool use) override
 	{
 		box = use;
+		invalidateShow();
 		return *this;
 	}
 
@@ -131,6 +185,7 @@ public:
 	T& setBoxColour(Colour colour) override
 	{
 		boxColour = colour;
+		invalidateShow();
 		return *this;
 	}
 
@@ -142,6 +197,7 @@ public:
 	T& setShadow(int shadow) override
 	{
 		shadowSize = shadow;
+		invalidateShow();
 		return *this;
 	}
 
@@ -153,6 +209,7 @@ public:
 	T& setOutline(int outline) override
 	{
 		outlineSize = outline;
+		invalidateShow();
 		return *this;
 	}
 
@@ -164,6 +221,7 @@ public:
 	T& setBackgroundColour(Colour colour) override
 	{
 		backgroundColour = colour;
+		invalidateShow();
 		return *this;
 	}
 
@@ -177,9 +235,11 @@ public:
 		if (static_cast<int>(s) >= 16 || static_cast<int>(s) < 0)
 		{
 			style = TextDrawStyle_FontBeckettRegular;
+			invalidateShow();
 			return *this;
 		}
 		style = s;
+		invalidateShow();
 		return *this;
 	}
 
@@ -191,6 +251,7 @@ public:
 	T& setProportional(bool p) override
 	{
 		proportional = p;
+		invalidateShow();
 		return *this;
 	}
 
@@ -202,6 +263,7 @@ public:
 	T& setSelectable(bool select) override
 	{
 		selectable = select;
+		invalidateShow();
 		return *this;
 	}
 
@@ -213,6 +275,7 @@ public:
 	T& setPreviewModel(int model) override
 	{
 		previewModel = model;
+		invalidateShow();
 		return *this;
 	}
 
@@ -224,6 +287,7 @@ public:
 	T& setPreviewRotation(Vector3 rotation) override
 	{
 		previewRotation = rotation;
+		invalidateShow();
 		return *this;
 	}
 
@@ -236,6 +300,7 @@ public:
 	{
 		previewVehicleColours.first = colour1;
 		previewVehicleColours.second = colour2;
+		invalidateShow();
 		return *this;
 	}
 
@@ -247,6 +312,7 @@ public:
 	T& setPreviewZoom(float zoom) override
 	{
 		previewZoom = zoom;
+		invalidateShow();
 		return *this;
 	}
 
@@ -257,6 +323,16 @@ public:
 
 protected:
 	void showForClient(IPlayer& player, bool isPlayerTextDraw)
+	{
+		if (showPayloadBits == 0)
+		{
+			writeShow(isPlayerTextDraw);
+		}
+		player.sendRPC(NetCode::RPC::PlayerShowTextDraw::PacketID, Span<uint8_t>(showPayload.data(), showPayloadBits), NetCode::RPC::PlayerShowTextDraw::PacketChannel);
+	}
+
+	/// Write the show RPC in to showPayload
+	void writeShow(bool isPlayerTextDraw)
 	{
 		NetCode::RPC::PlayerShowTextDraw playerShowTextDrawRPC;
 		playerShowTextDrawRPC.PlayerTextDraw = isPlayerTextDraw;
@@ -294,7 +370,11 @@ protected:
 		playerShowTextDrawRPC.Color1 = previewVehicleColours.first;
 		playerShowTextDrawRPC.Color2 = previewVehicleColours.second;
 		playerShowTextDrawRPC.Text = StringView(text);
-		PacketHelper::send(playerShowTextDrawRPC, player);
+
+		NetworkBitStream bs;
+		playerShowTextDrawRPC.write(bs);
+		showPayload.assign(bs.GetData(), bs.GetData() + bs.GetNumberOfBytesUsed());
+		showPayloadBits = bs.GetNumberOfBitsUsed();
 	}
 
 	void hideForClient(IPlayer& player, bool isPlayerTextDraw)
@@ -314,6 +394,28 @@ protected:
 		PacketHelper::send(playerTextDrawSetStringRPC, player);
 	}
 
+	/// Send a text to several players, writing the RPC once
+	/// @param filter Called with each player, returns whether to send to them
+	template <typename Filter>
+	void setTextForClients(const FlatPtrHashSet<IPlayer>& players, StringView txt, bool isPlayerTextDraw, Filter filter)
+	{
+		NetCode::RPC::PlayerTextDrawSetString playerTextDrawSetStringRPC;
+		playerTextDrawSetStringRPC.PlayerTextDraw = isPlayerTextDraw;
+		playerTextDrawSetStringRPC.TextDrawID = poolID;
+		playerTextDrawSetStringRPC.Text = txt;
+
+		NetworkBitStream bs;
+		playerTextDrawSetStringRPC.write(bs);
+		const Span<uint8_t> data(bs.GetData(), bs.GetNumberOfBitsUsed());
+		for (IPlayer* player : players)
+		{
+			if (filter(*player))
+			{
+				player->sendRPC(NetCode::RPC::PlayerTextDrawSetString::PacketID, data, NetCode::RPC::PlayerTextDrawSetString::PacketChannel);
+			}
+		}
+	}
+
 	// Remove ending spaces. Set text length to client limit.
 	void trimText()
 	{
@@ -333,24 +435,50 @@ protected:
 	}
 };
 
-class TextDraw final : public TextDrawBase<ITextDraw>
+class TextDraw final : public TextDrawBase<ITextDraw>, public PendingTextUpdate
 {
 private:
 	UniqueIDArray<IPlayer, PLAYER_POOL_SIZE> shownFor_;
+	TextUpdateQueue& updates_;
+	/// The text last sent to everyone it's shown for
+	HybridString<64> clientText_;
+	/// Whether setText was called since the last update
+	bool textChanged_ = false;
+	/// The players whose text was set with setTextForPlayer and differs from clientText_
+	FlatHashMap<int, HybridString<64>> playerText_;
+	/// Texts from setTextForPlayer waiting to be sent
+	FlatHashMap<int, Pair<IPlayer*, HybridString<64>>> pendingPlayerText_;
 
-	using TextDrawBase<ITextDraw>::TextDrawBase;
+	/// Forget a player's own text when they're sent the text draw again
+	void resetPlayerText(int pid)
+	{
+		playerText_.erase(pid);
+		pendingPlayerText_.erase(pid);
+	}
 
 public:
+	TextDraw(TextUpdateQueue& updates, Vector2 pos, StringView text, TextDrawStyle style = TextDrawStyle_FontAharoniBold, int previewModel = 0)
+		: TextDrawBase(pos, text, style, previewModel)
+		, updates_(updates)
+		, clientText_(getText())
+	{
+	}
+
 	void removeFor(int pid, IPlayer& player)
 	{
 		if (shownFor_.valid(pid))
 		{
 			shownFor_.remove(pid, player);
 		}
+		resetPlayerText(pid);
 	}
 
 	void restream() override
 	{
+		clientText_ = getText();
+		textChanged_ = false;
+		playerText_.clear();
+		pendingPlayerText_.clear();
 		for (IPlayer* player : shownFor_.entries())
 		{
 			showForClient(*player, false);
@@ -365,31 +493,83 @@ public:
 	void showForPlayer(IPlayer& player) override
 	{
 		shownFor_.add(player.getID(), player);
+		resetPlayerText(player.getID());
 		showForClient(player, false);
 	}
 
 	void hideForPlayer(IPlayer& player) override
 	{
 		shownFor_.remove(player.getID(), player);
+		resetPlayerText(player.getID());
 		hideForClient(player, false);
 	}
 
 	void setText(StringView txt) override
 	{
 		TextDrawBase<ITextDraw>::setText(txt);
-		for (IPlayer* player : shownFor_.entries())
-		{
-			setTextForClient(*player, txt, false);
-		}
+		// Replaces the per player texts set earlier in the tick.
+		pendingPlayerText_.clear();
+		textChanged_ = true;
+		updates_.add(*this);
 	}
 
 	void setTextForPlayer(IPlayer& player, StringView txt) override
 	{
-		setTextForClient(player, txt, false);
+		auto& pending = pendingPlayerText_[player.getID()];
+		pending.first = &player;
+		pending.second = txt;
+		updates_.add(*this);
+	}
+
+	void sendTextUpdates() override
+	{
+		if (textChanged_)
+		{
+			textChanged_ = false;
+			const bool changed = StringView(clientText_) != getText();
+			if (changed || !playerText_.empty())
+			{
+				clientText_ = getText();
+				setTextForClients(shownFor_.entries(), clientText_, false, [this, changed](IPlayer& player)
+					{
+						return changed || playerText_.find(player.getID()) != playerText_.end();
+					});
+				playerText_.clear();
+			}
+		}
+
+		for (auto& it : pendingPlayerText_)
+		{
+			const int pid = it.first;
+			IPlayer& player = *it.second.first;
+			const StringView txt = it.second.second;
+			if (!shownFor_.valid(pid))
+			{
+				continue;
+			}
+
+			auto own = playerText_.find(pid);
+			if (txt == (own == playerText_.end() ? StringView(clientText_) : StringView(own->second)))
+			{
+				continue;
+			}
+
+			setTextForClient(player, txt, false);
+			if (txt == StringView(clientText_))
+			{
+				playerText_.erase(pid);
+			}
+			else
+			{
+				playerText_[pid] = txt;
+			}
+		}
+		pendingPlayerText_.clear();
 	}
 
 	~TextDraw()
 	{
+		updates_.remove(*this);
 	}
 
 	void destream()
@@ -401,22 +581,27 @@ public:
 	}
 };
 
-class PlayerTextDraw final : public TextDrawBase<IPlayerTextDraw>
+class PlayerTextDraw final : public TextDrawBase<IPlayerTextDraw>, public PendingTextUpdate
 {
 private:
 	IPlayer& player;
+	TextUpdateQueue& updates_;
 	bool shown = false;
+	/// The text the player's client has
+	HybridString<64> clientText_;
 
 public:
-	PlayerTextDraw(IPlayer& player, Vector2 pos, StringView text, TextDrawStyle style = TextDrawStyle_FontAharoniBold, int previewModel = 0)
+	PlayerTextDraw(TextUpdateQueue& updates, IPlayer& player, Vector2 pos, StringView text, TextDrawStyle style = TextDrawStyle_FontAharoniBold, int previewModel = 0)
 		: TextDrawBase(pos, text, style, previewModel)
 		, player(player)
+		, updates_(updates)
 	{
 	}
 
 	void show() override
 	{
 		showForClient(player, true);
+		clientText_ = getText();
 		shown = true;
 	}
 
@@ -436,6 +621,7 @@ public:
 		if (shown)
 		{
 			showForClient(player, true);
+			clientText_ = getText();
 		}
 	}
 
@@ -444,12 +630,22 @@ public:
 		TextDrawBase<IPlayerTextDraw>::setText(txt);
 		if (shown)
 		{
-			setTextForClient(player, txt, true);
+			updates_.add(*this);
+		}
+	}
+
+	void sendTextUpdates() override
+	{
+		if (shown && StringView(clientText_) != getText())
+		{
+			clientText_ = getText();
+			setTextForClient(player, clientText_, true);
 		}
 	}
 
 	~PlayerTextDraw()
 	{
+		updates_.remove(*this);
 	}
 
 	void destream()
@@ -16,6 +16,7 @@ class PlayerTextDrawData final : public IPlayerTextDrawData
 {
 private:
 	IPlayer& player;
+	TextUpdateQueue& updates;
 	MarkedPoolStorage<PlayerTextDraw, IPlayerTextDraw, 0, PLAYER_TEXTDRAW_POOL_SIZE> storage;
 	bool selecting;
 
@@ -25,8 +26,9 @@ public:
 		selecting = false;
 	}
 
-	PlayerTextDrawData(IPlayer& player)
+	PlayerTextDrawData(IPlayer& player, TextUpdateQueue& updates)
 		: player(player)
+		, updates(updates)
 		, selecting(false)
 	{
 	}
@@ -56,12 +58,12 @@ public:
 
 	IPlayerTextDraw* create(Vector2 position, StringView text) override
 	{
-		return storage.emplace(player, position, text);
+		return storage.emplace(updates, player, position, text);
 	}
 
 	IPlayerTextDraw* create(Vector2 position, int model) override
 	{
-		return storage.emplace(player, position, "_", TextDrawStyle_Preview, model);
+		return storage.emplace(updates, player, position, "_", TextDrawStyle_Preview, model);
 	}
 
 	void freeExtension() override
@@ -117,10 +119,12 @@ public:
 	}
 };
 
-class TextDrawsComponent final : public ITextDrawsComponent, public PlayerConnectEventHandler, public PoolEventHandler<IPlayer>
+class TextDrawsComponent final : public ITextDrawsComponent, public PlayerConnectEventHandler, public PoolEventHandler<IPlayer>, public CoreEventHandler
 {
 private:
 	ICore* core = nullptr;
+	/// Declared before the text draws as they remove themselves from it when destroyed
+	TextUpdateQueue updates;
 	MarkedPoolStorage<TextDraw, ITextDraw, 0, GLOBAL_TEXTDRAW_POOL_SIZE> storage;
 	DefaultEventDispatcher<TextDrawEventHandler> dispatcher;
 
@@ -198,9 +202,18 @@ public:
 		core = c;
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
 		core->getPlayers().getPoolEventDispatcher().addEventHandler(this);
+		dispatcher.setProfiler(&core->getTickProfiler(), "TextDrawEventHandler");
+		storage.getEventDispatcher().setProfiler(&core->getTickProfiler(), "TextDrawPoolEventHandler");
+		// Last, so text set by anything else this tick goes out with this tick's updates.
+		core->getEventDispatcher().addEventHandler(this, EventPriority_Lowest);
 		NetCode::RPC::OnPlayerSelectTextDraw::addEventHandler(*core, &playerSelectTextDrawEventHandler);
 	}
 
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		updates.flush();
+	}
+
 	void reset() override
 	{
 		// Destroy all stored entity instances.
@@ -213,13 +226,14 @@ public:
 		{
 			core->getPlayers().getPlayerConnectDispatcher().removeEventHandler(this);
 			core->getPlayers().getPoolEventDispatcher().removeEventHandler(this);
+			core->getEventDispatcher().removeEventHandler(this);
 			NetCode::RPC::OnPlayerSelectTextDraw::removeEventHandler(*core, &playerSelectTextDrawEventHandler);
 		}
 	}
 
 	void onPlayerConnect(IPlayer& player) override
 	{
-		player.addExtension(new PlayerTextDrawData(player), true);
+		player.addExtension(new PlayerTextDrawData(player, updates), true);
 	}
 
 	void onPoolEntryDestroyed(IPlayer& player) override
@@ -240,12 +254,12 @@ public:
 
 	ITextDraw* create(Vector2 position, StringView text) override
 	{
-		return storage.emplace(position, text);
+		return storage.emplace(updates, position, text);
 	}
 
 	ITextDraw* create(Vector2 position, int model) override
 	{
-		return storage.emplace(position, "_", TextDrawStyle_Preview, model);
+		return storage.emplace(updates, position, "_", TextDrawStyle_Preview, model);
 	}
 
 	void free() override
@@ -0,0 +1,181 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include <Impl/text_filter_impl.hpp>
+#include <random>
+#include <regex>
+#include <sdk.hpp>
+
+using namespace Impl;
+
+/// Messages filtered by each benchmark
+constexpr int messageCount = 200000;
+
+/// The two regex passes chat was filtered with before TextFilter
+static String regexFilter(StringView message)
+{
+	std::regex filter = std::regex("~(k|K)|%");
+	std::regex filterColourNodes = std::regex("\\{[0-9a-fA-F]{6}\\}");
+	String filteredMessage = std::regex_replace(String(message), filter, "#");
+	return std::regex_replace(filteredMessage, filterColourNodes, " ");
+}
+
+/// Checks TextFilter gives the same output as the regex filter and compares how many messages per second each handles
+struct TextFilterTestComponent final : public IComponent, public NoCopy
+{
+	/// Core
+	ICore* core = nullptr;
+
+	/// Gets the component UID
+	/// @returns Component UID
+	UID getUID() override
+	{
+		return 0x7E3B5A0C1D92F846;
+	}
+
+	/// Gets the component name
+	/// @returns Component name
+	StringView componentName() const override
+	{
+		return "Text filter test";
+	}
+
+	/// Gets the component type
+	/// @returns Component type
+	ComponentType componentType() const override
+	{
+		return ComponentType::Other;
+	}
+
+	/// Gets the component version
+	/// @returns Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(1, 0, 0, 0);
+	}
+
+	/// Called for every component after components have been loaded
+	/// @param c Core
+	void onLoad(ICore* c) override
+	{
+		core = c;
+	}
+
+	/// Check listed words are replaced in chat only, and that text without them is left as it is
+	void checkWords(TextFilter& textFilter)
+	{
+		struct Case
+		{
+			StringView text;
+			bool formatting;
+			bool censor;
+			StringView expected;
+		};
+		static const Case cases[] = {
+			{ "I said BadWord, lol", true, true, "I said *******, ***" },
+			{ "badwordbadword", true, true, "**************" },
+			{ "{FF00AA}visit us~k", true, true, " ***** us#" },
+			{ "/visit badword", true, false, "/visit badword" },
+			{ "/lol %s", true, false, "/lol #s" },
+			{ "/lol ~k {FF00AA}", false, false, "/lol ~k {FF00AA}" },
+			{ "nothing to see", true, true, "nothing to see" },
+		};
+
+		int failures = 0;
+		for (const Case& test : cases)
+		{
+			const StringView filtered = textFilter.filter(test.text, test.formatting, test.censor);
+			if (filtered != test.expected)
+			{
+				core->printLn("[ERROR] Text filter gave \"%.*s\" for \"%.*s\", expected \"%.*s\"", PRINT_VIEW(filtered), PRINT_VIEW(test.text), PRINT_VIEW(test.expected));
+				++failures;
+			}
+		}
+		if (failures == 0)
+		{
+			core->printLn("Text filter: %d word list checks passed", int(sizeof(cases) / sizeof(cases[0])));
+		}
+	}
+
+	/// Called when all components have been initialised
+	/// @param components Component list to query
+	void onInit(IComponentList* components) override
+	{
+		// Chat-like text with formatting codes, broken colour embeds and listed words mixed in.
+		static const StringView parts[] = { "hello ", "~k", "~K", "%", "{FF00AA}", "{12345}", "{GG0000}", "~r~", "visit ", "badword", "BadWord ", "gg ", "lol", "}", "{" };
+		std::mt19937 random(0);
+		DynamicArray<String> messages(1024);
+		for (String& message : messages)
+		{
+			const int length = random() % 16;
+			for (int i = 0; i != length; ++i)
+			{
+				message += parts[random() % (sizeof(parts) / sizeof(parts[0]))];
+			}
+		}
+
+		TextFilter textFilter;
+		int mismatches = 0;
+		for (const String& message : messages)
+		{
+			if (textFilter.filter(message, true, true) != StringView(regexFilter(message)))
+			{
+				++mismatches;
+			}
+		}
+		if (mismatches)
+		{
+			core->printLn("[ERROR] %d of %d messages filtered differently to the regex filter", mismatches, int(messages.size()));
+		}
+
+		size_t checksum = 0;
+		TimePoint start = Time::now();
+		for (int i = 0; i != messageCount; ++i)
+		{
+			checksum += regexFilter(messages[i % messages.size()]).size();
+		}
+		const float regexSeconds = std::chrono::duration_cast<Microseconds>(Time::now() - start).count() / 1000000.f;
+
+		start = Time::now();
+		for (int i = 0; i != messageCount; ++i)
+		{
+			checksum += textFilter.filter(messages[i % messages.size()], true, true).size();
+		}
+		const float filterSeconds = std::chrono::duration_cast<Microseconds>(Time::now() - start).count() / 1000000.f;
+
+		const StringView words[] = { "badword", "visit", "lol" };
+		textFilter.setWords(Span<const StringView>(words, sizeof(words) / sizeof(words[0])));
+		checkWords(textFilter);
+		start = Time::now();
+		for (int i = 0; i != messageCount; ++i)
+		{
+			checksum += textFilter.filter(messages[i % messages.size()], true, true).size();
+		}
+		const float wordsSeconds = std::chrono::duration_cast<Microseconds>(Time::now() - start).count() / 1000000.f;
+
+		core->printLn("Text filter: regex %.0f messages/s, single pass %.0f messages/s, single pass with %d words %.0f messages/s (%zu)",
+			messageCount / std::max(regexSeconds, 0.000001f),
+			messageCount / std::max(filterSeconds, 0.000001f),
+			int(sizeof(words) / sizeof(words[0])),
+			messageCount / std::max(wordsSeconds, 0.000001f),
+			checksum);
+	}
+
+	void reset() override
+	{
+	}
+
+	void free() override
+	{
+	}
+} textFilterTestComponent;
+
+COMPONENT_ENTRY_POINT()
+{
+	return &textFilterTestComponent;
+}
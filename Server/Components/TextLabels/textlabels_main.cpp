@@ -139,6 +139,7 @@ public:
 		players->getPlayerUpdateDispatcher().addEventHandler(this);
 		players->getPlayerConnectDispatcher().addEventHandler(this);
 		players->getPoolEventDispatcher().addEventHandler(this);
+		storage.getEventDispatcher().setProfiler(&core->getTickProfiler(), "TextLabelPoolEventHandler");
 		streamConfigHelper = StreamConfigHelper(core->getConfig());
 	}
 
@@ -9,12 +9,29 @@
 #include "timer.hpp"
 #include <sdk.hpp>
 #include <list>
+#include <new>
 
 class TimersComponent final : public ITimersComponent, public CoreEventHandler
 {
 private:
 	ICore* core = nullptr;
 	std::list<Timer*> timers;
+	/// Destroyed timers' list nodes and memory, reused so creating a timer doesn't allocate
+	std::list<Timer*> freeTimers;
+
+	Timer* newTimer(TimerTimeOutHandler* handler, Milliseconds initial, Milliseconds interval, unsigned int count)
+	{
+		if (freeTimers.empty())
+		{
+			timers.push_back(new Timer(handler, initial, interval, count));
+		}
+		else
+		{
+			timers.splice(timers.end(), freeTimers, freeTimers.begin());
+			new (timers.back()) Timer(handler, initial, interval, count);
+		}
+		return timers.back();
+	}
 
 public:
 	StringView componentName() const override
@@ -45,20 +62,22 @@ public:
 			delete timer;
 		}
 		timers.clear();
+
+		for (auto timer : freeTimers)
+		{
+			::operator delete(timer);
+		}
+		freeTimers.clear();
 	}
 
 	ITimer* create(TimerTimeOutHandler* handler, Milliseconds interval, bool repeating) override
 	{
-		Timer* timer = new Timer(handler, interval, interval, repeating ? 0 : 1);
-		timers.push_back(timer);
-		return timer;
+		return newTimer(handler, interval, interval, repeating ? 0 : 1);
 	}
 
 	ITimer* create(TimerTimeOutHandler* handler, Milliseconds initial, Milliseconds interval, unsigned int count) override
 	{
-		Timer* timer = new Timer(handler, initial, interval, count);
-		timers.push_back(timer);
-		return timer;
+		return newTimer(handler, initial, interval, count);
 	}
 
 	void onTick(Microseconds elapsed, TimePoint now) override
@@ -90,8 +109,8 @@ public:
 			}
 			if (deleteTimer)
 			{
-				delete timer;
-				it = timers.erase(it);
+				timer->~Timer();
+				freeTimers.splice(freeTimers.end(), timers, it++);
 			}
 			else
 			{
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "vehicle.hpp"
+#include <Impl/streaming_impl.hpp>
 #include <Server/Components/Vehicles/vehicle_components.hpp>
 #include <Server/Components/Vehicles/vehicle_models.hpp>
 #include <Server/Components/Vehicles/vehicles.hpp>
@@ -20,12 +21,99 @@ class VehiclesComponent final : public IVehiclesComponent, public CoreEventHandl
 {
 private:
 	ICore* core = nullptr;
+	ILogger* logger = nullptr;
 	MarkedPoolStorage<Vehicle, IVehicle, 1, VEHICLE_POOL_SIZE> storage;
 	DefaultEventDispatcher<VehicleEventHandler> eventDispatcher;
 	StaticArray<uint8_t, MAX_VEHICLE_MODELS> preloadModels;
 	StreamConfigHelper streamConfigHelper;
 	int* deathRespawnDelay = nullptr;
 
+	struct VehicleStreamSnapshot
+	{
+		int id;
+		Vehicle* vehicle;
+		Vector3 position;
+		int virtualWorld;
+	};
+
+	struct VehicleViewerSnapshot
+	{
+		IPlayer* player;
+		IVehicle* vehicle;
+		Vector3 position;
+		int virtualWorld;
+		bool hasState;
+	};
+
+	struct VehicleStreamer final : public ParallelStreamer<VehicleStreamSnapshot, VehicleViewerSnapshot>
+	{
+		VehiclesComponent& self;
+		float maxDist = 0.f;
+
+		VehicleStreamer(VehiclesComponent& self)
+			: self(self)
+		{
+		}
+
+		void snapshotEntities(DynamicArray<VehicleStreamSnapshot>& entities) override
+		{
+			maxDist = self.streamConfigHelper.getDistanceSqr();
+			for (IVehicle* v : self.storage)
+			{
+				Vehicle* vehicle = static_cast<Vehicle*>(v);
+
+				// Trains carriages are created/destroyed by client.
+				const int model = vehicle->getModel();
+				if (model == 569 || model == 570)
+				{
+					continue;
+				}
+
+				entities.push_back({ vehicle->poolID, vehicle, vehicle->getPosition(), vehicle->getVirtualWorld() });
+			}
+		}
+
+		bool snapshotViewer(IPlayer& player, VehicleViewerSnapshot& viewer) override
+		{
+			PlayerVehicleData* playerVehicleData = queryExtension<PlayerVehicleData>(player);
+			viewer.player = &player;
+			viewer.vehicle = playerVehicleData ? playerVehicleData->getVehicle() : nullptr;
+			viewer.position = player.getPosition();
+			viewer.virtualWorld = player.getVirtualWorld();
+			viewer.hasState = player.getState() != PlayerState_None;
+			return true;
+		}
+
+		bool shouldStreamIn(const VehicleViewerSnapshot& viewer, const VehicleStreamSnapshot& entity) const override
+		{
+			const Vector2 dist2D = entity.position - viewer.position;
+			return viewer.hasState && viewer.virtualWorld == entity.virtualWorld && (viewer.vehicle == entity.vehicle || glm::dot(dist2D, dist2D) < maxDist);
+		}
+
+		bool streamedIn(const VehicleViewerSnapshot& viewer, const VehicleStreamSnapshot& entity) const override
+		{
+			return entity.vehicle->isStreamedInForPlayer(*viewer.player);
+		}
+
+		void streamIn(IPlayer& player, const VehicleStreamSnapshot& entity) override
+		{
+			Vehicle* vehicle = self.storage.get(entity.id);
+			if (vehicle && vehicle == entity.vehicle)
+			{
+				vehicle->streamInForPlayer(player);
+			}
+		}
+
+		void streamOut(IPlayer& player, const VehicleStreamSnapshot& entity) override
+		{
+			Vehicle* vehicle = self.storage.get(entity.id);
+			if (vehicle && vehicle == entity.vehicle)
+			{
+				vehicle->streamOutForPlayer(player);
+			}
+		}
+	} vehicleStreamer;
+
 	struct PlayerEnterVehicleHandler : public SingleNetworkInEventHandler
 	{
 		VehiclesComponent& self;
@@ -318,7 +406,8 @@ public:
 	}
 
 	VehiclesComponent()
-		: playerEnterVehicleHandler(*this)
+		: vehicleStreamer(*this)
+		, playerEnterVehicleHandler(*this)
 		, playerExitVehicleHandler(*this)
 		, vehicleDamageStatusHandler(*this)
 		, playerSCMEventHandler(*this)
@@ -346,11 +435,14 @@ public:
 	void onLoad(ICore* core) override
 	{
 		this->core = core;
+		logger = &core->getStructuredLogger().getLogger(getUID());
 		core->getEventDispatcher().addEventHandler(this);
 		core->getPlayers().getPlayerUpdateDispatcher().addEventHandler(this);
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
 		core->getPlayers().getPlayerChangeDispatcher().addEventHandler(this);
 		core->getPlayers().getPoolEventDispatcher().addEventHandler(this);
+		eventDispatcher.setProfiler(&core->getTickProfiler(), "VehicleEventHandler");
+		storage.getEventDispatcher().setProfiler(&core->getTickProfiler(), "VehiclePoolEventHandler");
 		NetCode::RPC::OnPlayerEnterVehicle::addEventHandler(*core, &playerEnterVehicleHandler);
 		NetCode::RPC::OnPlayerExitVehicle::addEventHandler(*core, &playerExitVehicleHandler);
 		NetCode::RPC::SetVehicleDamageStatus::addEventHandler(*core, &vehicleDamageStatusHandler);
@@ -412,7 +504,7 @@ public:
 			static bool delay_warn = false;
 			if (!delay_warn && data.respawnDelay == Seconds(0))
 			{
-				core->logLn(LogLevel::Warning, "Vehicle created with respawn delay 0 which is undefined behaviour that might change in the future.");
+				logger->logLn(LogLevel::Warning, "Vehicle created with respawn delay 0 which is undefined behaviour that might change in the future.");
 				delay_warn = true;
 			}
 		}
@@ -454,12 +546,14 @@ public:
 					Vehicle* carriage = static_cast<Vehicle*>(c);
 					--preloadModels[carriage->getModel() - 400];
 					carriage->destream();
+					vehicleStreamer.remove(carriage->poolID);
 					storage.release(carriage->poolID, false);
 				}
 			}
 
 			--preloadModels[veh_model - 400];
 			vehiclePtr->destream();
+			vehicleStreamer.remove(index);
 			storage.release(index, false);
 		}
 	}
@@ -487,6 +581,8 @@ public:
 
 	void onTick(Microseconds elapsed, TimePoint now) override
 	{
+		vehicleStreamer.update(*core);
+
 		for (IVehicle* v : storage)
 		{
 			Vehicle* vehicle = static_cast<Vehicle*>(v);
@@ -577,33 +673,9 @@ public:
 			playerVehicle = nullptr;
 		}
 
-		const float maxDist = streamConfigHelper.getDistanceSqr();
 		if (streamConfigHelper.shouldStream(player.getID(), now))
 		{
-			for (IVehicle* v : storage)
-			{
-				Vehicle* vehicle = static_cast<Vehicle*>(v);
-
-				// Trains carriages are created/destroyed by client.
-				const int model = vehicle->getModel();
-				if (model == 569 || model == 570)
-				{
-					continue;
-				}
-
-				const Vector2 dist2D = vehicle->getPosition() - player.getPosition();
-				const bool shouldBeStreamedIn = state != PlayerState_None && player.getVirtualWorld() == vehicle->getVirtualWorld() && (playerVehicle == vehicle || glm::dot(dist2D, dist2D) < maxDist);
-
-				const bool isStreamedIn = vehicle->isStreamedInForPlayer(player);
-				if (!isStreamedIn && shouldBeStreamedIn)
-				{
-					vehicle->streamInForPlayer(player);
-				}
-				else if (isStreamedIn && !shouldBeStreamedIn)
-				{
-					vehicle->streamOutForPlayer(player);
-				}
-			}
+			vehicleStreamer.queue(player);
 		}
 		return true;
 	}
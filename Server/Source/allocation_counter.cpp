@@ -0,0 +1,57 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include "allocation_counter.hpp"
+
+#ifdef OMP_COUNT_ALLOCATIONS
+
+#include <Impl/thread_counter_impl.hpp>
+#include <cstdlib>
+#include <new>
+
+using namespace Impl;
+
+static ThreadCounter& allocationCounter()
+{
+	// Constructed on first use as allocations happen before other statics are initialised.
+	static ThreadCounter counter;
+	return counter;
+}
+
+// The array and nothrow forms call this one, and the default operator delete frees what malloc returns.
+void* operator new(std::size_t size)
+{
+	allocationCounter().add();
+	for (;;)
+	{
+		if (void* ptr = std::malloc(size ? size : 1))
+		{
+			return ptr;
+		}
+		std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		handler();
+	}
+}
+
+uint64_t getAllocationCount()
+{
+	return allocationCounter().get();
+}
+
+#else
+
+uint64_t getAllocationCount()
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,15 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/// Get the number of calls to operator new since the server started
+/// @return 0 unless built with BUILD_ALLOCATION_COUNTER
+uint64_t getAllocationCount();
@@ -8,8 +8,13 @@
 
 #pragma once
 
+#include "allocation_counter.hpp"
+#include "http_client.hpp"
 #include "player_pool.hpp"
 #include "util.hpp"
+#include "structured_log.hpp"
+#include "tick_profiler.hpp"
+#include "worker_pool.hpp"
 #include <Impl/network_impl.hpp>
 #include <Server/Components/Classes/classes.hpp>
 #include <Server/Components/Console/console.hpp>
@@ -37,12 +42,6 @@
 
 using namespace Impl;
 
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wlogical-op-parentheses"
-#define CPPHTTPLIB_OPENSSL_SUPPORT
-#include <httplib.h>
-#pragma clang diagnostic pop
-
 #include <openssl/sha.h>
 
 typedef std::variant<int, String, float, DynamicArray<String>, bool> ConfigStorage;
@@ -50,7 +49,9 @@ typedef std::variant<int, String, float, DynamicArray<String>, bool> ConfigStora
 static const std::map<String, ConfigStorage> Defaults {
 	{ "announce", true },
 	{ "chat_input_filter", true },
+	{ "chat_input_filter_words", DynamicArray<String> {} },
 	{ "enable_query", true },
+	{ "enable_tick_profiler", true },
 	{ "language", String("") },
 	{ "max_bots", 0 },
 	{ "max_players", 50 },
@@ -59,6 +60,7 @@ static const std::map<String, ConfigStorage> Defaults {
 	{ "sleep", 5.0f },
 	{ "use_dyn_ticks", true },
 	{ "website", String("open.mp") },
+	{ "worker_threads", -1 },
 	// game
 	{ "game.allow_interior_weapons", true },
 	{ "game.chat_radius", 200.0f },
@@ -88,8 +90,11 @@ static const std::map<String, ConfigStorage> Defaults {
 	{ "game.lag_compensation_mode", LagCompMode_Enabled },
 	{ "game.group_player_objects", false },
 	// logging
+	{ "logging.async", true },
 	{ "logging.enable", true },
 	{ "logging.file", String("log.txt") },
+	{ "logging.flush_interval", 50 },
+	{ "logging.levels", DynamicArray<String> {} },
 	{ "logging.log_chat", true },
 	{ "logging.log_connection_messages", true },
 	{ "logging.log_cookies", false },
@@ -97,6 +102,10 @@ static const std::map<String, ConfigStorage> Defaults {
 	{ "logging.log_queries", false },
 	{ "logging.log_sqlite", false },
 	{ "logging.log_sqlite_queries", false },
+	{ "logging.rotate_interval", 0 },
+	{ "logging.rotate_size", 0 },
+	{ "logging.structured_file", String("") },
+	{ "logging.structured_format", String("") },
 	{ "logging.timestamp_format", String("[%Y-%m-%dT%H:%M:%S%z]") },
 	{ "logging.use_timestamp", true },
 	{ "logging.use_prefix", true },
@@ -119,14 +128,20 @@ static const std::map<String, ConfigStorage> Defaults {
 	{ "network.player_timeout", 10000 },
 	{ "network.stream_radius", 200.f },
 	{ "network.stream_rate", 1000 },
+	{ "network.player_stream_in_budget", 20 }, // Players streamed in for each player per tick, 0 for no limit
 	{ "network.time_sync_rate", 30000 },
 	{ "network.use_lan_mode", false },
 	{ "network.allow_037_clients", true },
 	{ "network.grace_period", 5000 },
+	{ "network.http_client_threads", 4 },
+	{ "network.http_client_queue_size", 256 },
+	{ "network.http_client_timeout", 60000 },
+	{ "network.capture_file", String("") }, // Write incoming packets to this file in captures/ for netreplay, passwords sent in RCON logins and dialogs included
 	// rcon
 	{ "rcon.allow_teleport", false },
 	{ "rcon.enable", false },
 	{ "rcon.password", String("") }, // Set default to empty instead of changeme, so server starts with disabled rcon without config file
+	{ "rcon.tick_budget", 2 }, // Milliseconds each tick can spend running queued console commands
 	// banners
 	{ "banners.light", String("") },
 	{ "banners.dark", String("") },
@@ -218,6 +233,46 @@ struct VarlistEnumCallback : OptionEnumeratorCallback
 	}
 };
 
+struct ProfileEnumCallback : TickProfileEnumeratorCallback
+{
+	IConsoleComponent& console;
+	ITickProfiler& profiler;
+	const ConsoleCommandSenderData& sender;
+
+	ProfileEnumCallback(IConsoleComponent& console, ITickProfiler& profiler, const ConsoleCommandSenderData& sender)
+		: console(console)
+		, profiler(profiler)
+		, sender(sender)
+	{
+	}
+
+	bool proc(int section, StringView name) override
+	{
+		TickProfileStats stats[TickProfileWindow_End];
+		for (int window = 0; window != TickProfileWindow_End; ++window)
+		{
+			profiler.getStats(section, TickProfileWindow(window), stats[window]);
+		}
+
+		// Skip sections that haven't run for a while, e.g. handlers of unloaded scripts.
+		if (stats[TickProfileWindow_Minute].ticks == 0)
+		{
+			return true;
+		}
+
+		char buffer[64];
+		snprintf(buffer, sizeof(buffer), "%-40.*s", PRINT_VIEW(name));
+		String line = buffer;
+		for (int window = 0; window != TickProfileWindow_End; ++window)
+		{
+			snprintf(buffer, sizeof(buffer), "%s%lld/%lld/%lld", window ? " | " : " ", static_cast<long long>(stats[window].p50.count()), static_cast<long long>(stats[window].p99.count()), static_cast<long long>(stats[window].max.count()));
+			line += buffer;
+		}
+		console.sendMessage(sender, line);
+		return true;
+	}
+};
+
 class ComponentList : public IComponentList
 {
 public:
@@ -298,6 +353,28 @@ public:
 		return components.size();
 	}
 
+	/// Get every component's UID and name
+	void getNames(DynamicArray<Pair<UID, StringView>>& names) const
+	{
+		for (const robin_hood::pair<UID, IComponent*>& pair : components)
+		{
+			names.emplace_back(pair.first, pair.second->componentName());
+		}
+	}
+
+	/// Find the component an object is a part of, e.g. through an event handler it inherits
+	IComponent* findByObject(const void* object) const
+	{
+		for (const robin_hood::pair<UID, IComponent*>& pair : components)
+		{
+			if (dynamic_cast<const void*>(pair.second) == object)
+			{
+				return pair.second;
+			}
+		}
+		return nullptr;
+	}
+
 private:
 	FlatHashMap<UID, IComponent*> components;
 };
@@ -828,142 +905,11 @@ private:
 	FlatHashMap<String, Pair<bool, String>> aliases;
 };
 
-class HTTPAsyncIO
-{
-public:
-	HTTPAsyncIO(HTTPResponseHandler* handler, HTTPRequestType type, StringView url, StringView data, bool force_v4 = false, StringView bindAddr = "")
-		: handler(handler)
-		, type(type)
-		, url(url)
-		, data(data)
-		, force_v4(force_v4)
-		, bindAddr(bindAddr)
-		, finished(false)
-		, response(0)
-	{
-		thread = std::thread(&threadProc, this);
-	}
-
-	~HTTPAsyncIO()
-	{
-		if (thread.joinable())
-		{
-			thread.join();
-		}
-	}
-
-	bool tryExec()
-	{
-		if (finished)
-		{
-			handler->onHTTPResponse(response, body);
-			return true;
-		}
-		else
-		{
-			return false;
-		}
-	}
-
-private:
-	static void threadProc(HTTPAsyncIO* params)
-	{
-		constexpr StringView http = "http://";
-		constexpr StringView https = "https://";
-
-		HTTPRequestType type = params->type;
-		StringView url = params->url;
-		StringView data = params->data;
-
-		// Deconstruct because a certain someone decided it would be a good idea to have http:// be optional
-		StringView urlNoPrefix = url;
-		bool secure = false;
-		int idx;
-		if ((idx = url.find(http)) == 0)
-		{
-			urlNoPrefix = url.substr(http.size());
-			secure = false;
-		}
-		else if ((idx = url.find(https)) == 0)
-		{
-			urlNoPrefix = url.substr(https.size());
-			secure = true;
-		}
-
-		// Deconstruct further
-		StringView domain = urlNoPrefix;
-		StringView path = "/";
-		if ((idx = urlNoPrefix.find_first_of('/')) != StringView::npos)
-		{
-			domain = urlNoPrefix.substr(0, idx);
-			path = urlNoPrefix.substr(idx);
-		}
-
-		// Reconstruct
-		String domainStr = String(secure ? https : http) + String(domain);
-
-		// Set up request
-		httplib::Client request(domainStr.c_str());
-		request.set_default_headers({ { "User-Agent", "open.mp server" } });
-		request.enable_server_certificate_verification(true);
-		request.set_follow_location(true);
-		request.set_connection_timeout(Seconds(5));
-		request.set_read_timeout(Seconds(60));
-		request.set_write_timeout(Seconds(5));
-		request.set_keep_alive(true);
-
-		if (params->force_v4)
-			request.set_address_family(AF_INET);
-
-		if (!params->bindAddr.empty())
-			request.set_interface(params->bindAddr);
-
-		// Run request
-		httplib::Result res(nullptr, httplib::Error::Canceled);
-		switch (type)
-		{
-		case HTTPRequestType_Get:
-			res = request.Get(path.data());
-			break;
-		case HTTPRequestType_Post:
-			res = request.Post(path.data(), String(data), "application/x-www-form-urlencoded");
-			break;
-		case HTTPRequestType_Head:
-			res = request.Head(path.data());
-			break;
-		}
-
-		if (res)
-		{
-			params->body = res.value().body;
-			params->response = res.value().status;
-		}
-		else
-		{
-			params->response = int(res.error());
-		}
-
-		params->finished.store(true);
-	}
-
-	std::thread thread;
-	HTTPResponseHandler* handler;
-	HTTPRequestType type;
-	String url;
-	String data;
-
-	bool force_v4;
-	String bindAddr;
-
-	std::atomic_bool finished;
-	int response;
-	String body;
-};
-
-class Core final : public ICore, public PlayerConnectEventHandler, public ConsoleEventHandler
+class Core final : public ICore, public IStructuredLogger, public PlayerConnectEventHandler, public ConsoleEventHandler
 {
 private:
 	DefaultEventDispatcher<CoreEventHandler> eventDispatcher;
+	TickProfiler profiler;
 	PlayerPool players;
 	Microseconds sleepTimer;
 	Microseconds sleepDuration;
@@ -973,12 +919,18 @@ private:
 	Config config;
 	IConsoleComponent* console;
 	ICustomModelsComponent* models;
-	FILE* logFile;
+	LogSink logSink;
+	StructuredLog structuredLog;
 	std::atomic_bool run_;
 	unsigned ticksPerSecond;
 	unsigned ticksThisSecond;
 	TimePoint ticksPerSecondLastUpdate;
-	std::set<HTTPAsyncIO*> httpFutures;
+	HTTPClientPool httpClients;
+	bool httpQueueFull;
+	WorkerPool workers;
+	FlatHashMap<CoreEventHandler*, int> tickHandlerSections;
+	int tickSection;
+	int httpSection;
 
 	bool* EnableZoneNames;
 	bool* UsePlayerPedAnims;
@@ -1004,6 +956,7 @@ private:
 	int* Multiplier;
 	int* LagCompensation;
 	bool* EnableVehicleFriendlyFire;
+	bool* EnableTickProfiler;
 	bool reloading_ = false;
 
 	bool EnableLogTimestamp;
@@ -1370,17 +1323,82 @@ private:
 		return false;
 	}
 
-public:
-	bool reloadLogFile()
+	/// Logs every line as a record of one subsystem, from `getLogger`
+	class SubsystemLogger final : public ILogger
 	{
-		if (!logFile)
+	private:
+		Core& core;
+		UID subsystem;
+
+	public:
+		SubsystemLogger(Core& core, UID subsystem)
+			: core(core)
+			, subsystem(subsystem)
 		{
-			return false;
 		}
 
-		fclose(logFile);
-		logFile = ::fopen(LogFileName.c_str(), "a");
-		return true;
+		void printLn(const char* fmt, ...) override
+		{
+			va_list args;
+			va_start(args, fmt);
+			core.vlogLnInternal(subsystem, LogLevel::Message, false, fmt, args);
+			va_end(args);
+		}
+
+		void vprintLn(const char* fmt, va_list args) override
+		{
+			core.vlogLnInternal(subsystem, LogLevel::Message, false, fmt, args);
+		}
+
+		void logLn(LogLevel level, const char* fmt, ...) override
+		{
+			va_list args;
+			va_start(args, fmt);
+			core.vlogLnInternal(subsystem, level, false, fmt, args);
+			va_end(args);
+		}
+
+		void vlogLn(LogLevel level, const char* fmt, va_list args) override
+		{
+			core.vlogLnInternal(subsystem, level, false, fmt, args);
+		}
+
+		void printLnU8(const char* fmt, ...) override
+		{
+			va_list args;
+			va_start(args, fmt);
+			core.vlogLnInternal(subsystem, LogLevel::Message, true, fmt, args);
+			va_end(args);
+		}
+
+		void vprintLnU8(const char* fmt, va_list args) override
+		{
+			core.vlogLnInternal(subsystem, LogLevel::Message, true, fmt, args);
+		}
+
+		void logLnU8(LogLevel level, const char* fmt, ...) override
+		{
+			va_list args;
+			va_start(args, fmt);
+			core.vlogLnInternal(subsystem, level, true, fmt, args);
+			va_end(args);
+		}
+
+		void vlogLnU8(LogLevel level, const char* fmt, va_list args) override
+		{
+			core.vlogLnInternal(subsystem, level, true, fmt, args);
+		}
+	};
+
+	/// Loggers handed out by `getLogger`, one per subsystem
+	FlatHashMap<UID, std::unique_ptr<SubsystemLogger>> subsystemLoggers;
+
+public:
+	bool reloadLogFile()
+	{
+		const bool text = logSink.reopenFile();
+		const bool records = structuredLog.reopen();
+		return text || records;
 	}
 
 	void run()
@@ -1410,26 +1428,61 @@ public:
 			}
 			++ticksThisSecond;
 
-			eventDispatcher.dispatch(&CoreEventHandler::onTick, us, now);
+			profiler.setEnabled(*EnableTickProfiler);
+			const bool profile = profiler.isEnabled();
 
-			for (auto it = httpFutures.begin(); it != httpFutures.end();)
-			{
-				HTTPAsyncIO* httpIO = *it;
-				if (httpIO->tryExec())
-				{
-					delete httpIO;
-					it = httpFutures.erase(it);
-				}
-				else
+			eventDispatcher.all([this, us, now, profile](CoreEventHandler* handler)
 				{
-					++it;
-				}
+					ScopedTickProfile scope(&profiler, profile ? getTickHandlerSection(handler) : -1);
+					handler->onTick(us, now);
+				});
+
+			{
+				ScopedTickProfile scope(&profiler, httpSection);
+				httpClients.poll();
+			}
+
+			if (profile)
+			{
+				profiler.record(tickSection, Time::now() - now);
+				profiler.endTick(now);
 			}
 
 			std::this_thread::sleep_until(now + sleepDuration);
 		}
 	}
 
+	/// Get the profiler section of a tick handler, named after the component it's a part of
+	int getTickHandlerSection(CoreEventHandler* handler)
+	{
+		auto it = tickHandlerSections.find(handler);
+		if (it != tickHandlerSections.end())
+		{
+			return it->second;
+		}
+
+		String name;
+		const void* object = dynamic_cast<const void*>(handler);
+		if (object == dynamic_cast<const void*>(&players))
+		{
+			name = "Players";
+		}
+		else if (IComponent* component = components.findByObject(object))
+		{
+			name = String(component->componentName());
+		}
+		else
+		{
+			char address[32];
+			snprintf(address, sizeof(address), "%p", object);
+			name = address;
+		}
+
+		const int section = profiler.addSection("onTick: " + name);
+		tickHandlerSections.emplace(handler, section);
+		return section;
+	}
+
 	void setThreadSleep(Microseconds value) override
 	{
 		sleepTimer = value;
@@ -1485,7 +1538,6 @@ public:
 		, config(*this, false, &cmd)
 		, console(nullptr)
 		, models(nullptr)
-		, logFile(nullptr)
 		, run_(true)
 		, ticksPerSecond(0u)
 		, ticksThisSecond(0u)
@@ -1494,6 +1546,9 @@ public:
 		// Initialize start time
 		getTickCount();
 
+		httpQueueFull = false;
+		httpClients.configure(std::max(*config.getInt("network.http_client_threads"), 1), std::max(*config.getInt("network.http_client_queue_size"), 1), Milliseconds(std::max(*config.getInt("network.http_client_timeout"), 1)));
+
 		players.getPlayerConnectDispatcher().addEventHandler(this, EventPriority_FairlyLow);
 
 		// Read config params before loading config file
@@ -1516,7 +1571,7 @@ public:
 		// Decide whether to enable logging early on
 		if (*config.getBool("logging.enable"))
 		{
-			logFile = ::fopen(LogFileName.c_str(), "a");
+			logSink.openFile(LogFileName);
 		}
 
 		printLn("Starting open.mp server (%u.%u.%u.%u) from commit %.*s", getVersion().major, getVersion().minor, getVersion().patch, getVersion().prerel, PRINT_VIEW(getVersionHash()));
@@ -1549,9 +1604,9 @@ public:
 		config.setInt("max_players", std::clamp(*config.getInt("max_players"), 1, PLAYER_POOL_SIZE));
 
 		// If logging was enabled by config file, open the file
-		if (*config.getBool("logging.enable") && logFile == nullptr)
+		if (*config.getBool("logging.enable") && !logSink.isFileOpen())
 		{
-			logFile = ::fopen(LogFileName.c_str(), "a");
+			logSink.openFile(LogFileName);
 		}
 
 		// Overwrite config file data with config params
@@ -1626,10 +1681,16 @@ public:
 		Multiplier = config.getInt("network.multiplier");
 		LagCompensation = config.getInt("game.lag_compensation_mode");
 		EnableVehicleFriendlyFire = config.getBool("game.use_vehicle_friendly_fire");
+		EnableTickProfiler = config.getBool("enable_tick_profiler");
+		profiler.setEnabled(*EnableTickProfiler);
+		tickSection = profiler.addSection("Tick");
+		httpSection = profiler.addSection("HTTP");
+		eventDispatcher.setProfiler(&profiler, "CoreEventHandler");
 
 		EnableLogTimestamp = *config.getBool("logging.use_timestamp");
 		EnableLogPrefix = *config.getBool("logging.use_prefix");
 		LogTimestampFormat = String(config.getString("logging.timestamp_format"));
+		configureLogOutputs();
 
 		config.optimiseBans();
 		config.writeBans();
@@ -1645,11 +1706,23 @@ public:
 		}
 
 		models = components.queryComponent<ICustomModelsComponent>();
+
+		// -1 picks one thread per spare hardware thread, 0 runs parallel tasks on the main thread only.
+		int workerThreads = *config.getInt("worker_threads");
+		if (workerThreads < 0)
+		{
+			workerThreads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+		}
+		workers.start(workerThreads);
+
 		components.ready();
 	}
 
 	~Core()
 	{
+		workers.stop();
+		httpClients.stop();
+
 		if (console)
 		{
 			console->getEventDispatcher().removeEventHandler(this);
@@ -1662,10 +1735,9 @@ public:
 		networks.clear();
 		components.free();
 
-		if (logFile)
-		{
-			fclose(logFile);
-		}
+		// Write out what's still queued before the log files are closed.
+		logSink.stop();
+		structuredLog.stop();
 	}
 
 	IConfig& getConfig() override
@@ -1735,70 +1807,60 @@ public:
 		va_end(args);
 	}
 
-	void logToStream(FILE* stream, const char* iso8601, const char* prefix, const char* message)
+	/// Set up per-subsystem levels, rotation, the structured log and the writer threads from `logging.*`
+	void configureLogOutputs()
 	{
-		if (iso8601[0])
+		DynamicArray<Pair<UID, StringView>> subsystems;
+		components.getNames(subsystems);
+		structuredLog.setSubsystems(subsystems, config.getStrings("logging.levels"), *this);
+
+		const uint64_t rotateBytes = uint64_t(std::max(*config.getInt("logging.rotate_size"), 0)) * 1024 * 1024;
+		const Seconds rotateInterval = duration_cast<Seconds>(Minutes(std::max(*config.getInt("logging.rotate_interval"), 0)));
+		logSink.setRotation(rotateBytes, rotateInterval);
+
+		const StringView format = config.getString("logging.structured_format");
+		StructuredLog::Format structuredFormat = StructuredLog::Format::None;
+		if (format == "json")
 		{
-			fputs(iso8601, stream);
-			fputs(" ", stream);
+			structuredFormat = StructuredLog::Format::JSON;
 		}
-		if (prefix)
+		else if (format == "binary")
 		{
-			fputs(prefix, stream);
+			structuredFormat = StructuredLog::Format::Binary;
 		}
-		fputs(message, stream);
-		fputs("\n", stream);
-		fflush(stream);
-	}
-
-	virtual void vlogLn(LogLevel level, const char* fmt, va_list args) override
-	{
-		vlogLnInternal(level, false, fmt, args);
-	}
-
-	virtual void vlogLnU8(LogLevel level, const char* fmt, va_list args) override
-	{
-		vlogLnInternal(level, true, fmt, args);
-	}
-
-	virtual void vlogLnInternal(LogLevel level, bool utf8, const char* fmt, va_list args)
-	{
-#ifndef _DEBUG
-		if (level == LogLevel::Debug)
+		else if (!format.empty())
 		{
-			return;
+			logLn(LogLevel::Warning, "Unknown `logging.structured_format` \"%.*s\", expected `json` or `binary`", PRINT_VIEW(format));
 		}
-#endif
 
-#ifdef BUILD_WINDOWS
-		_lock_locales();
-		UINT oldCP = 0;
-		char oldLocale[64] = { 0 };
-		bool oldLocaleSaved = false;
-		if (utf8)
-		{
-			oldCP = GetConsoleOutputCP();
-			SetConsoleOutputCP(CP_UTF8);
-
-			/* Getting current locale */
-			const char* old_locale_ptr = std::setlocale(LC_CTYPE, nullptr);
-			if (old_locale_ptr != nullptr)
+		if (structuredFormat != StructuredLog::Format::None)
+		{
+			String path(config.getString("logging.structured_file"));
+			if (path.empty())
 			{
-				strcpy_s(oldLocale, old_locale_ptr);
-				oldLocaleSaved = true;
-
-				std::setlocale(LC_CTYPE, ".UTF-8");
+				path = structuredFormat == StructuredLog::Format::JSON ? "log.jsonl" : "log.bin";
+			}
+			if (!structuredLog.open(structuredFormat, path, rotateBytes, rotateInterval))
+			{
+				logLn(LogLevel::Error, "Couldn't open structured log file \"%s\"", path.c_str());
 			}
 		}
-#endif
 
+		if (*config.getBool("logging.async"))
+		{
+			const Milliseconds flushInterval(std::max(*config.getInt("logging.flush_interval"), 1));
+			logSink.start(flushInterval);
+			structuredLog.start(flushInterval);
+		}
+	}
+
+	/// Write a formatted line to the text log and a record to the structured log
+	void writeLog(UID subsystem, LogLevel level, bool utf8, StringView message, Span<const LogField> fields)
+	{
 #ifdef BUILD_WINDOWS
 		if (level == LogLevel::Debug)
 		{
-			char debugStr[4096] = { 0 };
-			const int written = vsnprintf(debugStr, sizeof(debugStr) - 1, fmt, args);
-			debugStr[written] = '\n';
-			OutputDebugString(debugStr);
+			OutputDebugString(String(message).append("\n").c_str());
 		}
 #endif
 		const char* prefix = nullptr;
@@ -1823,51 +1885,119 @@ public:
 		char iso8601[32] = { 0 };
 		if (EnableLogTimestamp && !LogTimestampFormat.empty())
 		{
-			std::time_t now = WorldTime::to_time_t(WorldTime::now());
-			std::strftime(iso8601, sizeof(iso8601), LogTimestampFormat.c_str(), std::localtime(&now));
+			formatLogTimestamp(iso8601);
+		}
+
+		logSink.write(level, utf8, iso8601, prefix, message);
+		structuredLog.write(subsystem, level, message, fields);
+	}
+
+	/// Format the current time for log lines, only calling strftime once a second on each thread
+	/// The cache is also keyed on the format, so changing logging.timestamp_format takes effect immediately
+	void formatLogTimestamp(char (&iso8601)[32])
+	{
+		thread_local std::time_t cachedTime = 0;
+		thread_local String cachedFormat;
+		thread_local char cachedTimestamp[32] = { 0 };
+
+		const std::time_t now = WorldTime::to_time_t(WorldTime::now());
+		if (now != cachedTime || cachedFormat != LogTimestampFormat)
+		{
+			std::tm local;
+#ifdef BUILD_WINDOWS
+			localtime_s(&local, &now);
+#else
+			localtime_r(&now, &local);
+#endif
+			if (std::strftime(cachedTimestamp, sizeof(cachedTimestamp), LogTimestampFormat.c_str(), &local) == 0)
+			{
+				cachedTimestamp[0] = 0;
+			}
+			cachedTime = now;
+			cachedFormat = LogTimestampFormat;
+		}
+		memcpy(iso8601, cachedTimestamp, sizeof(cachedTimestamp));
+	}
+
+	virtual void vlogLn(LogLevel level, const char* fmt, va_list args) override
+	{
+		vlogLnInternal(CoreLogSubsystem, level, false, fmt, args);
+	}
+
+	virtual void vlogLnU8(LogLevel level, const char* fmt, va_list args) override
+	{
+		vlogLnInternal(CoreLogSubsystem, level, true, fmt, args);
+	}
+
+	virtual void vlogLnInternal(UID subsystem, LogLevel level, bool utf8, const char* fmt, va_list args)
+	{
+		if (!structuredLog.isEnabled(subsystem, level))
+		{
+			return;
 		}
 
 		char main[4096];
 		std::unique_ptr<char[]> fallback; // In case the string is larger than 4096
 		Span<char> buf(main, sizeof(main));
 
+		// Format straight into the stack buffer, and only again if it didn't fit.
 		va_list args_copy;
 		va_copy(args_copy, args);
-		const int len = vsnprintf(nullptr, 0, fmt, args_copy);
+		int len = vsnprintf(main, sizeof(main), fmt, args_copy);
 		va_end(args_copy);
 
-		if (len > sizeof(main))
+		if (len < 0)
+		{
+			main[0] = 0;
+			len = 0;
+		}
+		else if (size_t(len) >= sizeof(main))
 		{
 			// Stack won't fit our string; allocate space for it
-			fallback.reset(new char[len]);
-			buf = Span<char>(fallback.get(), len);
+			fallback.reset(new char[len + 1]);
+			buf = Span<char>(fallback.get(), len + 1);
+			vsnprintf(buf.data(), buf.size(), fmt, args);
 		}
-		buf[0] = 0;
-		vsnprintf(buf.data(), buf.size(), fmt, args);
 
-		FILE* stream
-			= stdout;
-		if (level == LogLevel::Error)
+		writeLog(subsystem, level, utf8, StringView(buf.data(), len), Span<const LogField>());
+	}
+
+	bool isLogEnabled(UID subsystem, LogLevel level) const override
+	{
+		return structuredLog.isEnabled(subsystem, level);
+	}
+
+	void logRecord(UID subsystem, LogLevel level, StringView message, Span<const LogField> fields) override
+	{
+		if (structuredLog.isEnabled(subsystem, level))
 		{
-			stream = stderr;
+			writeLog(subsystem, level, false, message, fields);
 		}
-		logToStream(stream, iso8601, prefix, buf.data());
-		if (logFile)
+	}
+
+	bool setLogLevel(UID subsystem, LogLevel level) override
+	{
+		return structuredLog.setLevel(subsystem, level);
+	}
+
+	LogLevel getLogLevel(UID subsystem) const override
+	{
+		return structuredLog.getLevel(subsystem);
+	}
+
+	ILogger& getLogger(UID subsystem) override
+	{
+		if (subsystem == CoreLogSubsystem)
 		{
-			logToStream(logFile, iso8601, prefix, buf.data());
+			return *this;
 		}
 
-#ifdef BUILD_WINDOWS
-		if (utf8)
+		auto it = subsystemLoggers.find(subsystem);
+		if (it == subsystemLoggers.end())
 		{
-			if (oldLocaleSaved)
-			{
-				std::setlocale(LC_CTYPE, oldLocale);
-			}
-			SetConsoleOutputCP(oldCP);
+			it = subsystemLoggers.emplace(subsystem, std::make_unique<SubsystemLogger>(*this, subsystem)).first;
 		}
-		_unlock_locales();
-#endif
+		return *it->second;
 	}
 
 	IPlayerPool& getPlayers() override
@@ -2013,10 +2143,23 @@ public:
 		utils::RunProcess(*this, config.getString("bot_exe"), args, true);
 	}
 
+	void queueHTTP(HTTPResponseHandler* handler, HTTPRequestType type, StringView url, StringView data, bool forceV4, StringView bindAddr)
+	{
+		if (httpClients.request(handler, type, url, data, forceV4, bindAddr))
+		{
+			httpQueueFull = false;
+		}
+		else if (!httpQueueFull)
+		{
+			// Only warn once per burst, the handlers still get a status for every dropped request.
+			httpQueueFull = true;
+			logLn(LogLevel::Warning, "Too many HTTP requests are queued, dropping requests until some complete (see network.http_client_queue_size)");
+		}
+	}
+
 	void requestHTTP(HTTPResponseHandler* handler, HTTPRequestType type, StringView url, StringView data) override
 	{
-		HTTPAsyncIO* httpIO = new HTTPAsyncIO(handler, type, url, data);
-		httpFutures.emplace(httpIO);
+		queueHTTP(handler, type, url, data, false, "");
 	}
 
 	bool sha256(StringView password, StringView salt, StaticArray<char, 64 + 1>& output) const override
@@ -2052,8 +2195,10 @@ public:
 	{
 		commands.emplace("exit");
 		commands.emplace("reloadlog");
+		commands.emplace("loglevel");
 		commands.emplace("config");
 		commands.emplace("varlist");
+		commands.emplace("profile");
 	}
 
 	bool onConsoleText(StringView command, StringView parameters, const ConsoleCommandSenderData& sender) override
@@ -2071,6 +2216,21 @@ public:
 			}
 			return true;
 		}
+		else if (command == "loglevel")
+		{
+			// loglevel <subsystem> <debug|info|warning|error|none>
+			const size_t separator = parameters.find(' ');
+			const int level = separator == StringView::npos ? -1 : StructuredLog::parseLevel(parameters.substr(separator + 1));
+			if (level < 0)
+			{
+				console->sendMessage(sender, "Usage: loglevel <component name|uid|core|*> <debug|info|warning|error|none>");
+			}
+			else if (!structuredLog.setLevel(parameters.substr(0, separator), level))
+			{
+				console->sendMessage(sender, "Unknown log subsystem \"" + String(parameters.substr(0, separator)) + "\".");
+			}
+			return true;
+		}
 		else if (command == "config")
 		{
 			if (parameters.length() < 2 || *(parameters.data()) != '"' || *(parameters.data() + parameters.length() - 1) != '"')
@@ -2092,6 +2252,25 @@ public:
 			config.enumOptions(cb);
 			return true;
 		}
+		else if (command == "profile")
+		{
+			if (parameters == "reset")
+			{
+				profiler.reset();
+				console->sendMessage(sender, "Reset the tick profiler.");
+			}
+			else if (!profiler.isEnabled())
+			{
+				console->sendMessage(sender, "The tick profiler is disabled, set enable_tick_profiler to 1 to enable it.");
+			}
+			else
+			{
+				console->sendMessage(sender, "Per-tick time in microseconds (p50/p99/max) over 1s | 10s | 60s:");
+				ProfileEnumCallback cb(*console, profiler, sender);
+				profiler.enumSections(cb);
+			}
+			return true;
+		}
 		else // Process potential variable set
 		{
 			const auto alias = config.getNameFromAlias(command);
@@ -2116,7 +2295,26 @@ public:
 
 	void requestHTTP4(HTTPResponseHandler* handler, HTTPRequestType type, StringView url, StringView data) override
 	{
-		HTTPAsyncIO* httpIO = new HTTPAsyncIO(handler, type, url, data, true, config.getString("network.bind"));
-		httpFutures.emplace(httpIO);
+		queueHTTP(handler, type, url, data, true, config.getString("network.bind"));
+	}
+
+	void runParallel(IParallelTask& task, size_t count) override
+	{
+		workers.run(task, count);
+	}
+
+	ITickProfiler& getTickProfiler() override
+	{
+		return profiler;
+	}
+
+	IStructuredLogger& getStructuredLogger() override
+	{
+		return *this;
+	}
+
+	CoreStats getStats() override
+	{
+		return { httpClients.size(), getAllocationCount() };
 	}
 };
\ No newline at end of file
@@ -0,0 +1,308 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <core.hpp>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wlogical-op-parentheses"
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#include <httplib.h>
+#pragma clang diagnostic pop
+
+using namespace Impl;
+
+/// Runs HTTP requests on a fixed number of threads and hands the responses to the main thread in poll()
+/// Each thread keeps its connections to the hosts it talked to open, so repeated requests skip the TCP and TLS handshakes
+class HTTPClientPool final : public NoCopy
+{
+public:
+	/// The status a request's handler gets when it was dropped because too many requests were queued
+	static constexpr int QueueFullStatus = int(httplib::Error::Canceled);
+
+	~HTTPClientPool()
+	{
+		stop();
+	}
+
+	/// Set how many threads to start with the first request, how many requests can wait or run at once and how long a
+	/// response can take to arrive
+	void configure(unsigned threads, size_t maxRequests, Milliseconds readTimeout)
+	{
+		threadCount_ = std::max(1u, threads);
+		maxRequests_ = std::max<size_t>(1, maxRequests);
+		readTimeout_ = readTimeout;
+	}
+
+	/// Queue a request, its handler is called from poll() once it's done
+	/// @return false if too many requests are queued or running, the handler is then called with QueueFullStatus
+	bool request(HTTPResponseHandler* handler, HTTPRequestType type, StringView url, StringView data, bool forceV4, StringView bindAddr)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (pending_.size() + running_ >= maxRequests_)
+		{
+			completed_.push_back({ handler, QueueFullStatus, String() });
+			return false;
+		}
+
+		if (threads_.empty())
+		{
+			stopping_ = false;
+			active_.assign(threadCount_, nullptr);
+			for (unsigned i = 0; i != threadCount_; ++i)
+			{
+				threads_.emplace_back(&HTTPClientPool::threadProc, this, i);
+			}
+		}
+
+		pending_.push_back({ handler, type, String(url), String(data), forceV4, String(bindAddr) });
+		wake_.notify_one();
+		return true;
+	}
+
+	/// Get the number of requests waiting for or running on a thread
+	size_t size()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return pending_.size() + running_;
+	}
+
+	/// Call the handlers of the finished requests
+	void poll()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (completed_.empty())
+			{
+				return;
+			}
+			std::swap(completed_, polled_);
+		}
+
+		for (Response& response : polled_)
+		{
+			response.handler->onHTTPResponse(response.status, response.body);
+		}
+		polled_.clear();
+	}
+
+	/// Cancel the running requests and stop the threads, the handlers of unfinished requests aren't called
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (threads_.empty())
+			{
+				return;
+			}
+			stopping_ = true;
+			pending_.clear();
+			for (httplib::Client* client : active_)
+			{
+				if (client)
+				{
+					client->stop();
+				}
+			}
+		}
+		wake_.notify_all();
+		for (std::thread& thread : threads_)
+		{
+			thread.join();
+		}
+		threads_.clear();
+	}
+
+private:
+	/// Connections kept open by each thread, the least recently used one is closed to open another
+	static constexpr size_t MaxConnectionsPerThread = 8;
+
+	struct Request
+	{
+		HTTPResponseHandler* handler;
+		HTTPRequestType type;
+		String url;
+		String data;
+		bool forceV4;
+		String bindAddr;
+	};
+
+	struct Response
+	{
+		HTTPResponseHandler* handler;
+		int status;
+		String body;
+	};
+
+	struct Connection
+	{
+		String key;
+		std::unique_ptr<httplib::Client> client;
+		TimePoint lastUsed;
+	};
+
+	/// Split a URL into its scheme and host, and its path
+	/// The scheme is optional and defaults to http://
+	static void splitUrl(StringView url, String& host, String& path)
+	{
+		constexpr StringView http = "http://";
+		constexpr StringView https = "https://";
+
+		StringView urlNoPrefix = url;
+		bool secure = false;
+		if (url.find(http) == 0)
+		{
+			urlNoPrefix = url.substr(http.size());
+		}
+		else if (url.find(https) == 0)
+		{
+			urlNoPrefix = url.substr(https.size());
+			secure = true;
+		}
+
+		StringView domain = urlNoPrefix;
+		path = "/";
+		const size_t idx = urlNoPrefix.find_first_of('/');
+		if (idx != StringView::npos)
+		{
+			domain = urlNoPrefix.substr(0, idx);
+			path = String(urlNoPrefix.substr(idx));
+		}
+		host = String(secure ? https : http) + String(domain);
+	}
+
+	httplib::Client& getClient(DynamicArray<Connection>& connections, const String& host, const Request& request)
+	{
+		String key = host;
+		key += request.forceV4 ? "|4|" : "||";
+		key += request.bindAddr;
+
+		const TimePoint now = Time::now();
+		for (Connection& connection : connections)
+		{
+			if (connection.key == key)
+			{
+				connection.lastUsed = now;
+				return *connection.client;
+			}
+		}
+
+		if (connections.size() >= MaxConnectionsPerThread)
+		{
+			auto oldest = std::min_element(connections.begin(), connections.end(), [](const Connection& a, const Connection& b)
+				{
+					return a.lastUsed < b.lastUsed;
+				});
+			connections.erase(oldest);
+		}
+
+		std::unique_ptr<httplib::Client> client(new httplib::Client(host.c_str()));
+		client->set_default_headers({ { "User-Agent", "open.mp server" } });
+		client->enable_server_certificate_verification(true);
+		client->set_follow_location(true);
+		client->set_connection_timeout(Seconds(5));
+		client->set_read_timeout(readTimeout_);
+		client->set_write_timeout(Seconds(5));
+		client->set_keep_alive(true);
+
+		if (request.forceV4)
+		{
+			client->set_address_family(AF_INET);
+		}
+
+		if (!request.bindAddr.empty())
+		{
+			client->set_interface(request.bindAddr);
+		}
+
+		connections.push_back({ std::move(key), std::move(client), now });
+		return *connections.back().client;
+	}
+
+	void threadProc(unsigned index)
+	{
+		DynamicArray<Connection> connections;
+		std::unique_lock<std::mutex> lock(mutex_);
+		for (;;)
+		{
+			wake_.wait(lock, [this]()
+				{
+					return stopping_ || !pending_.empty();
+				});
+			if (stopping_)
+			{
+				break;
+			}
+
+			Request request = std::move(pending_.front());
+			pending_.pop_front();
+			++running_;
+
+			String host;
+			String path;
+			splitUrl(request.url, host, path);
+			httplib::Client& client = getClient(connections, host, request);
+			active_[index] = &client;
+			lock.unlock();
+
+			httplib::Result res(nullptr, httplib::Error::Canceled);
+			switch (request.type)
+			{
+			case HTTPRequestType_Get:
+				res = client.Get(path.c_str());
+				break;
+			case HTTPRequestType_Post:
+				res = client.Post(path.c_str(), request.data, "application/x-www-form-urlencoded");
+				break;
+			case HTTPRequestType_Head:
+				res = client.Head(path.c_str());
+				break;
+			}
+
+			Response response { request.handler, 0, String() };
+			if (res)
+			{
+				response.body = std::move(res.value().body);
+				response.status = res.value().status;
+			}
+			else
+			{
+				response.status = int(res.error());
+			}
+
+			lock.lock();
+			active_[index] = nullptr;
+			--running_;
+			if (!stopping_)
+			{
+				completed_.push_back(std::move(response));
+			}
+		}
+	}
+
+	unsigned threadCount_ = 4;
+	size_t maxRequests_ = 256;
+	Milliseconds readTimeout_ = Seconds(60);
+
+	DynamicArray<std::thread> threads_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	bool stopping_ = false;
+	std::deque<Request> pending_;
+	size_t running_ = 0;
+	/// The client each thread is running a request on, to cancel it when stopping
+	DynamicArray<httplib::Client*> active_;
+	DynamicArray<Response> completed_;
+	DynamicArray<Response> polled_;
+};
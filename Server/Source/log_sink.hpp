@@ -0,0 +1,468 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include "util.hpp"
+#include <atomic>
+#include <clocale>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace Impl;
+
+/// Writes formatted log lines to the console and the log file
+/// Once started, lines are queued by any thread without locking and written in batches by a writer thread,
+/// which flushes the streams once per batch instead of once per line
+class LogSink final : public NoCopy
+{
+public:
+	/// Number of lines that can wait to be written, lines logged while it's full are dropped
+	static constexpr size_t QueueSize = 8192;
+
+	/// Builds the line reporting how many lines were dropped, in the sink's format
+	typedef void (*DroppedNoticeBuilder)(String& line, uint64_t dropped);
+
+	/// @param console Whether lines are also written to stdout, or stderr for errors
+	explicit LogSink(bool console = true)
+		: console_(console)
+	{
+	}
+
+	~LogSink()
+	{
+		stop();
+		closeFile();
+	}
+
+	/// Open the log file for appending, only called before the writer thread is started
+	bool openFile(const String& path)
+	{
+		path_ = path;
+		open();
+		return file_ != nullptr;
+	}
+
+	/// Move the log file aside and start a new one once it reaches a size or age, checked after every batch
+	/// Only called before the writer thread is started
+	/// @param maxBytes The size to rotate at, or 0 to not rotate by size
+	/// @param interval The age to rotate at, or 0 to not rotate by age
+	void setRotation(uint64_t maxBytes, Seconds interval)
+	{
+		rotateSize_ = maxBytes;
+		rotateInterval_ = interval;
+	}
+
+	/// Replace the plain text line reporting dropped lines, only called before the writer thread is started
+	void setDroppedNotice(DroppedNoticeBuilder builder)
+	{
+		droppedNotice_ = builder;
+	}
+
+	bool isFileOpen() const
+	{
+		return file_ != nullptr;
+	}
+
+	/// Close and reopen the log file, e.g. after it's been rotated
+	/// Only sets a flag while the writer thread is running so it's also safe from a signal handler,
+	/// the writer picks it up when its timed wait next ends, at most one flush interval later
+	bool reopenFile()
+	{
+		if (file_ == nullptr)
+		{
+			return false;
+		}
+
+		if (running_)
+		{
+			// Notifying the condition variable isn't async-signal-safe, so don't wake the writer.
+			reopen_ = true;
+		}
+		else
+		{
+			reopen();
+		}
+		return true;
+	}
+
+	/// Start writing queued lines on a thread, flushing at least every interval
+	void start(Milliseconds flushInterval)
+	{
+		if (running_)
+		{
+			return;
+		}
+
+		if (!entries_)
+		{
+			entries_.reset(new Entry[QueueSize]);
+		}
+		for (size_t i = 0; i != QueueSize; ++i)
+		{
+			entries_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		head_ = 0;
+		tail_.store(0, std::memory_order_relaxed);
+		flushInterval_ = flushInterval;
+		stopping_ = false;
+		running_ = true;
+		thread_ = std::thread(&LogSink::threadProc, this);
+	}
+
+	/// Write the lines still queued and go back to writing on the calling thread
+	void stop()
+	{
+		if (!running_)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopping_ = true;
+		}
+		wake_.notify_one();
+		thread_.join();
+		running_ = false;
+
+		// Catch lines queued by other threads while the writer was exiting.
+		// The queue itself is kept until destruction in case one of them is still filling its entry.
+		drain();
+	}
+
+	/// Write a text line, or queue it if the writer thread is running
+	/// @param timestamp The formatted timestamp, or an empty string
+	/// @param prefix The level prefix, or nullptr
+	void write(LogLevel level, bool utf8, const char* timestamp, const char* prefix, StringView message)
+	{
+		write(level, utf8, [timestamp, prefix, message](String& line)
+			{
+				buildLine(line, timestamp, prefix, message);
+			});
+	}
+
+	/// Write a line built by a function, or queue it if the writer thread is running
+	/// @param build Called with the string to build the complete line in, including its terminator
+	template <typename Builder>
+	void write(LogLevel level, bool utf8, Builder&& build)
+	{
+		if (!running_)
+		{
+			String line;
+			build(line);
+			writeLine(level, utf8, line);
+			finishBatch();
+			return;
+		}
+
+		size_t pos = tail_.load(std::memory_order_relaxed);
+		Entry* entry;
+		for (;;)
+		{
+			entry = &entries_[pos & (QueueSize - 1)];
+			const size_t sequence = entry->sequence.load(std::memory_order_acquire);
+			const intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+			if (diff == 0)
+			{
+				if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				// The writer is behind by a whole queue, drop the line rather than stall the caller.
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			else
+			{
+				pos = tail_.load(std::memory_order_relaxed);
+			}
+		}
+
+		entry->level = level;
+		entry->utf8 = utf8;
+		entry->line.clear();
+		build(entry->line);
+		entry->sequence.store(pos + 1, std::memory_order_release);
+
+		// Don't keep warnings and errors waiting for the next timed flush.
+		if (level >= LogLevel::Warning)
+		{
+			wakeRequested_ = true;
+			wake_.notify_one();
+		}
+	}
+
+	/// Get the total number of lines dropped because the queue was full
+	uint64_t getDroppedCount() const
+	{
+		return dropped_.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct Entry
+	{
+		std::atomic<size_t> sequence;
+		LogLevel level;
+		bool utf8;
+		String line;
+	};
+
+	static void buildLine(String& line, const char* timestamp, const char* prefix, StringView message)
+	{
+		if (timestamp[0])
+		{
+			line += timestamp;
+			line += ' ';
+		}
+		if (prefix)
+		{
+			line += prefix;
+		}
+		line.append(message.data(), message.size());
+		line += '\n';
+	}
+
+	static void buildDroppedNotice(String& line, uint64_t dropped)
+	{
+		char notice[128];
+		snprintf(notice, sizeof(notice), "[Warning] Dropped %llu log lines because the log queue was full.\n", static_cast<unsigned long long>(dropped));
+		line = notice;
+	}
+
+	void writeLine(LogLevel level, bool utf8, const String& line)
+	{
+		if (file_)
+		{
+			fwrite(line.data(), 1, line.size(), file_);
+			fileSize_ += line.size();
+		}
+
+		if (!console_)
+		{
+			return;
+		}
+
+		FILE* stream = level == LogLevel::Error ? stderr : stdout;
+
+#ifdef BUILD_WINDOWS
+		// Only this thread writes to the console while it's running, so the code page can be switched for just this line.
+		UINT oldCP = 0;
+		char oldLocale[64] = { 0 };
+		bool oldLocaleSaved = false;
+		if (utf8)
+		{
+			_lock_locales();
+			fflush(stream);
+			oldCP = GetConsoleOutputCP();
+			SetConsoleOutputCP(CP_UTF8);
+
+			/* Getting current locale */
+			const char* old_locale_ptr = std::setlocale(LC_CTYPE, nullptr);
+			if (old_locale_ptr != nullptr)
+			{
+				strcpy_s(oldLocale, old_locale_ptr);
+				oldLocaleSaved = true;
+
+				std::setlocale(LC_CTYPE, ".UTF-8");
+			}
+		}
+#endif
+
+		fwrite(line.data(), 1, line.size(), stream);
+
+#ifdef BUILD_WINDOWS
+		if (utf8)
+		{
+			fflush(stream);
+			if (oldLocaleSaved)
+			{
+				std::setlocale(LC_CTYPE, oldLocale);
+			}
+			SetConsoleOutputCP(oldCP);
+			_unlock_locales();
+		}
+#endif
+	}
+
+	/// Flush the written lines and rotate the log file if it's due
+	void finishBatch()
+	{
+		if (console_)
+		{
+			fflush(stdout);
+			fflush(stderr);
+		}
+		if (file_)
+		{
+			fflush(file_);
+			if ((rotateSize_ && fileSize_ >= rotateSize_) || (rotateInterval_.count() && WorldTime::now() - fileOpened_ >= rotateInterval_))
+			{
+				rotate();
+			}
+		}
+	}
+
+	void open()
+	{
+		file_ = ::fopen(path_.c_str(), "a");
+		fileSize_ = 0;
+		fileOpened_ = WorldTime::now();
+		if (file_ && fseek(file_, 0, SEEK_END) == 0)
+		{
+			const long size = ftell(file_);
+			fileSize_ = size > 0 ? size : 0;
+		}
+	}
+
+	void reopen()
+	{
+		if (file_)
+		{
+			fclose(file_);
+		}
+		open();
+	}
+
+	/// Rename the log file after the time it was rotated at and start a new one
+	void rotate()
+	{
+		fclose(file_);
+		file_ = nullptr;
+
+		const std::time_t now = WorldTime::to_time_t(WorldTime::now());
+		std::tm local;
+#ifdef BUILD_WINDOWS
+		localtime_s(&local, &now);
+#else
+		localtime_r(&now, &local);
+#endif
+		char stamp[32];
+		std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+
+		// log.txt becomes log-20240101-000000.txt, keeping the extension for tools that go by it.
+		const ghc::filesystem::path path(path_);
+		const ghc::filesystem::path rotated = path.parent_path() / (path.stem().string() + "-" + stamp + path.extension().string());
+		std::error_code ec;
+		ghc::filesystem::rename(path, rotated, ec);
+		open();
+	}
+
+	void closeFile()
+	{
+		if (file_)
+		{
+			fclose(file_);
+			file_ = nullptr;
+		}
+	}
+
+	/// Write all the complete lines in the queue then flush them
+	/// @return The number of lines written
+	size_t drain()
+	{
+		size_t written = 0;
+		for (;;)
+		{
+			Entry& entry = entries_[head_ & (QueueSize - 1)];
+			if (entry.sequence.load(std::memory_order_acquire) != head_ + 1)
+			{
+				break;
+			}
+
+			writeLine(entry.level, entry.utf8, entry.line);
+			// Don't let one huge line keep its memory for as long as the slot exists.
+			if (entry.line.capacity() > LineCapacity)
+			{
+				String().swap(entry.line);
+			}
+			entry.sequence.store(head_ + QueueSize, std::memory_order_release);
+			++head_;
+			++written;
+		}
+
+		const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+		if (dropped != droppedReported_)
+		{
+			String notice;
+			droppedNotice_(notice, dropped - droppedReported_);
+			writeLine(LogLevel::Warning, false, notice);
+			droppedReported_ = dropped;
+			++written;
+		}
+
+		if (written)
+		{
+			finishBatch();
+		}
+		return written;
+	}
+
+	void threadProc()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		for (;;)
+		{
+			// Producers don't take the lock to notify, so a missed wake up only delays the batch to the next interval.
+			wake_.wait_for(lock, flushInterval_, [this]()
+				{
+					return stopping_ || wakeRequested_;
+				});
+			wakeRequested_ = false;
+			const bool stopping = stopping_;
+			lock.unlock();
+
+			if (reopen_.exchange(false))
+			{
+				reopen();
+			}
+			drain();
+
+			lock.lock();
+			if (stopping)
+			{
+				break;
+			}
+		}
+	}
+
+	/// Lines are at most this long unless the message itself is longer than the core's format buffer
+	static constexpr size_t LineCapacity = 4096 + 64;
+
+	std::unique_ptr<Entry[]> entries_;
+	std::atomic<size_t> tail_ { 0 };
+	size_t head_ = 0;
+	std::atomic<uint64_t> dropped_ { 0 };
+	uint64_t droppedReported_ = 0;
+
+	const bool console_;
+	DroppedNoticeBuilder droppedNotice_ = &buildDroppedNotice;
+
+	FILE* file_ = nullptr;
+	String path_;
+	uint64_t fileSize_ = 0;
+	WorldTimePoint fileOpened_;
+	uint64_t rotateSize_ = 0;
+	Seconds rotateInterval_ = Seconds(0);
+	std::atomic_bool reopen_ { false };
+	std::atomic_bool wakeRequested_ { false };
+
+	std::thread thread_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	Milliseconds flushInterval_ = Milliseconds(50);
+	std::atomic_bool running_ { false };
+	bool stopping_ = false;
+};
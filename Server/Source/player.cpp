@@ -236,13 +236,11 @@ void Player::streamInForPlayer(IPlayer& other)
 		{
 			++numStreamed;
 			streamedFor_.add(pid, other);
-			NetCode::RPC::PlayerStreamIn playerStreamInRPC(other.getClientVersion() == ClientVersion::ClientVersion_SAMP_03DL);
-			playerStreamInRPC.PlayerID = poolID;
-
-			playerStreamInRPC.Skin = skin_;
-			if (auto models_data = queryExtension<IPlayerCustomModelsData>(this); models_data != nullptr)
+			const bool isDL = other.getClientVersion() == ClientVersion::ClientVersion_SAMP_03DL;
+			DynamicArray<uint8_t>& payload = streamInPayload_[isDL];
+			if (payload.empty())
 			{
-				playerStreamInRPC.CustomSkin = models_data->getCustomSkin();
+				writeStreamIn(isDL);
 			}
 
 			Colour colour;
@@ -252,13 +250,13 @@ void Player::streamInForPlayer(IPlayer& other)
 				colour = colour_;
 			}
 
-			playerStreamInRPC.Team = team_;
-			playerStreamInRPC.Col = colour;
-			playerStreamInRPC.Pos = pos_;
-			playerStreamInRPC.Angle = rot_.ToEuler().z;
-			playerStreamInRPC.FightingStyle = fightingStyle_;
-			playerStreamInRPC.SkillLevel = skillLevels_;
-			PacketHelper::send(playerStreamInRPC, other);
+			// Patch the position, angle and colour, which follow the skin, over the last viewer's.
+			NetworkBitStream patch(payload.data(), payload.size(), false);
+			patch.SetWriteOffset((isDL ? 11 : 7) * 8);
+			patch.writeVEC3(pos_);
+			patch.writeFLOAT(rot_.ToEuler().z);
+			patch.writeUINT32(colour.RGBA());
+			other.sendRPC(NetCode::RPC::PlayerStreamIn::PacketID, Span<uint8_t>(payload.data(), payload.size() * 8), NetCode::RPC::PlayerStreamIn::PacketChannel);
 
 			const Milliseconds expire = duration_cast<Milliseconds>(chatBubbleExpiration_ - Time::now());
 			if (expire.count() > 0)
@@ -277,11 +275,34 @@ void Player::streamInForPlayer(IPlayer& other)
 	}
 }
 
+void Player::writeStreamIn(bool isDL)
+{
+	NetCode::RPC::PlayerStreamIn playerStreamInRPC(isDL);
+	playerStreamInRPC.PlayerID = poolID;
+	playerStreamInRPC.Team = team_;
+	playerStreamInRPC.Skin = skin_;
+	playerStreamInRPC.CustomSkin = 0;
+	if (auto models_data = queryExtension<IPlayerCustomModelsData>(this); models_data != nullptr)
+	{
+		playerStreamInRPC.CustomSkin = models_data->getCustomSkin();
+	}
+	playerStreamInRPC.Pos = pos_;
+	playerStreamInRPC.Angle = 0.f;
+	playerStreamInRPC.Col = colour_;
+	playerStreamInRPC.FightingStyle = fightingStyle_;
+	playerStreamInRPC.SkillLevel = skillLevels_;
+
+	NetworkBitStream bs;
+	playerStreamInRPC.write(bs);
+	streamInPayload_[isDL].assign(bs.GetData(), bs.GetData() + bs.GetNumberOfBytesUsed());
+}
+
 void Player::setSkin(int skin, bool send = true)
 {
 	uint32_t customSkin = 0;
 
 	skin_ = skin;
+	invalidateStreamIn();
 	if (pool_.modelsComponent)
 	{
 		pool_.modelsComponent->getBaseModel(skin_, customSkin);
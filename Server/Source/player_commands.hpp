@@ -0,0 +1,156 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <memory>
+#include <player.hpp>
+
+using namespace Impl;
+
+/// Registered commands in a hash map keyed by lower case name, so a command is one lookup instead of a call in to
+/// every script's OnPlayerCommandText
+class PlayerCommands final : public IPlayerCommands, public NoCopy
+{
+public:
+	bool add(StringView name, PlayerCommandHandler& handler, Milliseconds cooldown) override
+	{
+		String key;
+		if (!makeKey(name, key) || commands_.find(key) != commands_.end())
+		{
+			return false;
+		}
+
+		Command& command = commands_[key];
+		command.name = String(name.front() == '/' ? name.substr(1) : name);
+		command.handler = &handler;
+		command.cooldown = cooldown;
+		if (cooldown.count() > 0)
+		{
+			command.lastUse.reset(new StaticArray<TimePoint, PLAYER_POOL_SIZE>());
+		}
+		return true;
+	}
+
+	bool remove(StringView name) override
+	{
+		String key;
+		return makeKey(name, key) && commands_.erase(key) != 0;
+	}
+
+	PlayerCommandHandler* get(StringView name) const override
+	{
+		String key;
+		if (!makeKey(name, key))
+		{
+			return nullptr;
+		}
+		auto it = commands_.find(key);
+		return it == commands_.end() ? nullptr : it->second.handler;
+	}
+
+	/// Run a command if one is registered with the text's name
+	/// @param text The text the player sent, starting with /
+	/// @param handled Set to whether the handler accepted the command, true when it was ignored because of its cooldown
+	/// @return false if there's no command with this name, and the text should go to onPlayerCommandText
+	bool dispatch(IPlayer& player, StringView text, bool& handled)
+	{
+		const size_t nameEnd = std::min(text.find(' '), text.size());
+		if (!makeKey(text.substr(0, nameEnd), key_))
+		{
+			return false;
+		}
+		auto it = commands_.find(key_);
+		if (it == commands_.end())
+		{
+			return false;
+		}
+
+		Command& command = it->second;
+		handled = true;
+		if (command.lastUse)
+		{
+			const TimePoint now = Time::now();
+			TimePoint& lastUse = (*command.lastUse)[player.getID()];
+			if (now - lastUse < command.cooldown)
+			{
+				return true;
+			}
+			lastUse = now;
+		}
+
+		StringView params = text.substr(nameEnd);
+		const size_t start = params.find_first_not_of(' ');
+		params = start == StringView::npos ? StringView() : params.substr(start, params.find_last_not_of(' ') - start + 1);
+
+		args_.clear();
+		for (size_t pos = 0; pos < params.size();)
+		{
+			const size_t end = std::min(params.find(' ', pos), params.size());
+			args_.push_back(params.substr(pos, end - pos));
+			pos = params.find_first_not_of(' ', end);
+		}
+
+		// Copied as the handler can remove its command.
+		PlayerCommandHandler* handler = command.handler;
+		const String name = command.name;
+		handled = handler->onPlayerCommand(player, name, params, Span<const StringView>(args_.data(), args_.size()));
+		return true;
+	}
+
+	/// Forget a player's last uses so the next player in their slot isn't held by their cooldowns
+	void onPlayerDisconnect(int playerID)
+	{
+		for (auto& it : commands_)
+		{
+			if (it.second.lastUse)
+			{
+				(*it.second.lastUse)[playerID] = TimePoint();
+			}
+		}
+	}
+
+private:
+	struct Command
+	{
+		String name;
+		PlayerCommandHandler* handler = nullptr;
+		Milliseconds cooldown;
+		/// The time each player last used the command, only allocated for commands with a cooldown
+		std::unique_ptr<StaticArray<TimePoint, PLAYER_POOL_SIZE>> lastUse;
+	};
+
+	/// Lower case a command name and strip its leading /
+	/// @return false if the name is empty or has spaces
+	static bool makeKey(StringView name, String& key)
+	{
+		if (!name.empty() && name.front() == '/')
+		{
+			name = name.substr(1);
+		}
+		if (name.empty() || name.find(' ') != StringView::npos)
+		{
+			return false;
+		}
+
+		key.assign(name.data(), name.size());
+		for (char& c : key)
+		{
+			if (c >= 'A' && c <= 'Z')
+			{
+				c += 'a' - 'A';
+			}
+		}
+		return true;
+	}
+
+	FlatHashMap<String, Command> commands_;
+	/// Reused between dispatches
+	String key_;
+	DynamicArray<StringView> args_;
+};
@@ -22,7 +22,6 @@
 #include <network.hpp>
 #include <player.hpp>
 #include <pool.hpp>
-#include <regex>
 #include <types.hpp>
 #include <unordered_map>
 #include <values.hpp>
@@ -140,6 +139,19 @@ struct Player final : public IPlayer, public PoolIDProvider, public NoCopy
 
 	IFixesComponent* fixesComponent_;
 
+	/// The PlayerStreamIn RPC as last written for 0.3.7 and 0.3.DL viewers, reused until the skin, team, fighting style or a
+	/// skill level changes; the position, angle and colour are patched in for each viewer
+	StaticArray<DynamicArray<uint8_t>, 2> streamInPayload_;
+
+	void invalidateStreamIn()
+	{
+		streamInPayload_[0].clear();
+		streamInPayload_[1].clear();
+	}
+
+	/// Write the common part of the PlayerStreamIn RPC in to streamInPayload_
+	void writeStreamIn(bool isDL);
+
 	void clearExtensions()
 	{
 		freeExtensions();
@@ -156,6 +168,7 @@ struct Player final : public IPlayer, public PoolIDProvider, public NoCopy
 		virtualWorld_ = 0;
 		score_ = 0;
 		fightingStyle_ = PlayerFightingStyle_Normal;
+		invalidateStreamIn();
 		controllable_ = true;
 		clockToggled_ = false;
 		keys_ = { 0u, 0, 0 };
@@ -551,6 +564,7 @@ struct Player final : public IPlayer, public PoolIDProvider, public NoCopy
 	void setTeam(int team) override
 	{
 		team_ = team;
+		invalidateStreamIn();
 		NetCode::RPC::SetPlayerTeam setPlayerTeamRPC;
 		setPlayerTeamRPC.PlayerID = poolID;
 		setPlayerTeamRPC.Team = team;
@@ -948,6 +962,7 @@ public:
 		if (skill < skillLevels_.size())
 		{
 			skillLevels_[skill] = level;
+			invalidateStreamIn();
 			NetCode::RPC::SetPlayerSkillLevel setPlayerSkillLevelRPC;
 			setPlayerSkillLevelRPC.PlayerID = poolID;
 			setPlayerSkillLevelRPC.SkillType = skill;
@@ -1081,6 +1096,7 @@ public:
 		}
 
 		fightingStyle_ = style;
+		invalidateStreamIn();
 		NetCode::RPC::SetPlayerFightingStyle setPlayerFightingStyleRPC;
 		setPlayerFightingStyleRPC.PlayerID = poolID;
 		setPlayerFightingStyleRPC.Style = style;
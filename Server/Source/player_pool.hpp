@@ -8,7 +8,10 @@
 
 #pragma once
 
+#include "player_commands.hpp"
 #include "player_impl.hpp"
+#include <Impl/streaming_impl.hpp>
+#include <Impl/text_filter_impl.hpp>
 #include <Server/Components/Console/console.hpp>
 #include <utils.hpp>
 
@@ -36,6 +39,8 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 	ICustomModelsComponent* modelsComponent = nullptr;
 	IFixesComponent* fixesComponent_ = nullptr;
 	StreamConfigHelper streamConfigHelper;
+	TextFilter textFilter;
+	PlayerCommands commands;
 	int* markersShow;
 	int* markersUpdateRate;
 	bool* markersLimit;
@@ -45,8 +50,94 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 	bool* validateAnimations_;
 	bool* allowInteriorWeapons_;
 	int* maxBots;
+	int* streamInBudget;
 	StaticArray<bool, 256> allowNickCharacter;
 
+	struct PlayerStreamSnapshot
+	{
+		int id;
+		Player* player;
+		Vector3 position;
+		int virtualWorld;
+		bool streamable;
+	};
+
+	struct PlayerStreamer final : public ParallelStreamer<PlayerStreamSnapshot, PlayerStreamSnapshot>
+	{
+		PlayerPool& self;
+		float maxDist = 0.f;
+
+		PlayerStreamer(PlayerPool& self)
+			: self(self)
+		{
+		}
+
+		void snapshotEntities(DynamicArray<PlayerStreamSnapshot>& entities) override
+		{
+			maxDist = self.streamConfigHelper.getDistanceSqr();
+			for (IPlayer* p : self.storage.entries())
+			{
+				Player* other = static_cast<Player*>(p);
+				Vector3 otherPos = other->pos_;
+				const PlayerState state = other->state_;
+
+				// Use vehicle pos if player is passenger to keep paused players synced.
+				if (state == PlayerState_Passenger)
+				{
+					auto vehicleData = queryExtension<IPlayerVehicleData>(other);
+
+					if (vehicleData)
+					{
+						auto vehicle = vehicleData->getVehicle();
+
+						if (vehicle)
+						{
+							otherPos = vehicle->getPosition();
+						}
+					}
+				}
+
+				entities.push_back({ other->poolID, other, otherPos, other->virtualWorld_, state != PlayerState_Spectating && state != PlayerState_None });
+			}
+		}
+
+		bool snapshotViewer(IPlayer& p, PlayerStreamSnapshot& viewer) override
+		{
+			Player& player = static_cast<Player&>(p);
+			viewer = { player.poolID, &player, player.pos_, player.virtualWorld_, true };
+			return true;
+		}
+
+		bool shouldStreamIn(const PlayerStreamSnapshot& viewer, const PlayerStreamSnapshot& entity) const override
+		{
+			const Vector2 dist2D = viewer.position - entity.position;
+			return viewer.id != entity.id && entity.streamable && entity.virtualWorld == viewer.virtualWorld && glm::dot(dist2D, dist2D) < maxDist;
+		}
+
+		bool streamedIn(const PlayerStreamSnapshot& viewer, const PlayerStreamSnapshot& entity) const override
+		{
+			return viewer.id != entity.id && entity.player->isStreamedInForPlayer(*viewer.player);
+		}
+
+		void streamIn(IPlayer& player, const PlayerStreamSnapshot& entity) override
+		{
+			Player* other = self.storage.get(entity.id);
+			if (other == entity.player && other != &player)
+			{
+				other->streamInForPlayer(player);
+			}
+		}
+
+		void streamOut(IPlayer& player, const PlayerStreamSnapshot& entity) override
+		{
+			Player* other = self.storage.get(entity.id);
+			if (other == entity.player && other != &player)
+			{
+				other->streamOutForPlayer(player);
+			}
+		}
+	} playerStreamer;
+
 	struct PlayerRequestSpawnRPCHandler : public SingleNetworkInEventHandler
 	{
 		PlayerPool& self;
@@ -377,18 +468,25 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 
 			if (*logDeaths)
 			{
+				IStructuredLogger& logger = self.core.getStructuredLogger();
 				if (killer == nullptr)
 				{
-					self.core.logLn(
+					const LogField fields[] = { { "event", "death" }, { "player", player.poolID }, { "name", StringView(player.name_) }, { "reason", reason } };
+					logger.logRecordF(
+						CoreLogSubsystem,
 						LogLevel::Message,
+						fields,
 						"[death] %.*s died %d",
 						PRINT_VIEW(player.name_),
 						reason);
 				}
 				else
 				{
-					self.core.logLn(
+					const LogField fields[] = { { "event", "kill" }, { "player", player.poolID }, { "name", StringView(player.name_) }, { "killer", killer->getID() }, { "killer_name", killer->getName() }, { "reason", reason } };
+					logger.logRecordF(
+						CoreLogSubsystem,
 						LogLevel::Message,
+						fields,
 						"[kill] %.*s killed %.*s %.*s",
 						PRINT_VIEW(killer->getName()),
 						PRINT_VIEW(player.name_),
@@ -522,28 +620,17 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 				return false;
 			}
 
-			String filteredMessage;
-			if (*filterText)
-			{
-				// Filters ~k, ~K (uppercase). Replace with #.
-				std::regex filter = std::regex("~(k|K)|%");
-				// Filters 6 characters between { and }, keeping out coloring. Replace with whitespace
-				std::regex filterColourNodes = std::regex("\\{[0-9a-fA-F]{6}\\}", std::regex::egrep);
-				filteredMessage = std::regex_replace(String(StringView(playerChatMessageRequest.message)), filter, "#");
-				filteredMessage = std::regex_replace(filteredMessage, filterColourNodes, " ");
-			}
-			else
-			{
-				filteredMessage = String(StringView(playerChatMessageRequest.message));
-			}
+			// Replaces ~k, ~K and % with #, colour embeds with a space and listed words with *.
+			const StringView filteredMessage = self.textFilter.filter(StringView(playerChatMessageRequest.message), *filterText, *filterText);
 
 			if (*logChat)
 			{
-				self.core.printLn("[chat] [%.*s]: %s", PRINT_VIEW(peer.getName()), filteredMessage.c_str());
+				const LogField fields[] = { { "event", "chat" }, { "player", peer.getID() }, { "name", peer.getName() }, { "text", filteredMessage } };
+				self.core.getStructuredLogger().logRecordF(CoreLogSubsystem, LogLevel::Message, fields, "[chat] [%.*s]: %.*s", PRINT_VIEW(peer.getName()), PRINT_VIEW(filteredMessage));
 			}
 
 			bool send = self.playerTextDispatcher.stopAtFalse(
-				[&peer, &filteredMessage](PlayerTextEventHandler* handler)
+				[&peer, filteredMessage](PlayerTextEventHandler* handler)
 				{
 					return handler->onPlayerText(peer, filteredMessage);
 				});
@@ -552,16 +639,12 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 			{
 				if (*limitGlobalChatRadius)
 				{
-					const float limit = *globalChatRadiusLimit * *globalChatRadiusLimit;
-					const Vector3 pos = peer.getPosition();
-					for (IPlayer* other : self.storage.entries())
-					{
-						Vector3 dist3D = pos - other->getPosition();
-						if (glm::dot(dist3D, dist3D) <= limit)
-						{
-							other->sendChatMessage(peer, filteredMessage);
-						}
-					}
+					// Every player is checked, not just those the sender is streamed for, so players in range that haven't
+					// streamed the sender in yet still get the message as they always have.
+					NetCode::RPC::PlayerChatMessage RPC;
+					RPC.PlayerID = peer.getID();
+					RPC.message = filteredMessage;
+					self.sendInRange(RPC, peer, *globalChatRadiusLimit, self.storage.entries());
 				}
 				else
 				{
@@ -595,27 +678,20 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 				return false;
 			}
 
-			String filteredMessage;
-			if (*filterText)
-			{
-				// Filters ~k, ~K (uppercase), %. Replace with #.
-				std::regex filter = std::regex("~(k|K)|%");
-				// Filters 6 characters between { and }, keeping out coloring. Replace with whitespace
-				std::regex filterColourNodes = std::regex("\\{[0-9a-fA-F]{6}\\}", std::regex::egrep);
-				filteredMessage = std::regex_replace(String(StringView(playerRequestCommandMessage.message)), filter, "#");
-				filteredMessage = std::regex_replace(filteredMessage, filterColourNodes, " ");
-			}
-			else
-			{
-				filteredMessage = String(StringView(playerRequestCommandMessage.message));
-			}
+			// Replaces ~k, ~K and % with # and colour embeds with a space, listed words are left alone so commands still match.
+			const StringView filteredMessage = self.textFilter.filter(StringView(playerRequestCommandMessage.message), *filterText, false);
 
 			if (filteredMessage.size() > 1)
 			{
-				bool send = self.playerTextDispatcher.stopAtTrue([&peer, filteredMessage](PlayerTextEventHandler* handler)
-					{
-						return handler->onPlayerCommandText(peer, filteredMessage);
-					});
+				// Registered commands go straight to their handler, anything else is offered to every script in turn.
+				bool send;
+				if (!self.commands.dispatch(peer, filteredMessage, send))
+				{
+					send = self.playerTextDispatcher.stopAtTrue([&peer, filteredMessage](PlayerTextEventHandler* handler)
+						{
+							return handler->onPlayerCommandText(peer, filteredMessage);
+						});
+				}
 
 				if (!send)
 				{
@@ -1328,6 +1404,11 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 		return Colour::FromRGBA(colours[pid % GLM_COUNTOF(colours)]);
 	}
 
+	IPlayerCommands& getPlayerCommands() override
+	{
+		return commands;
+	}
+
 	void initPlayer(Player& player)
 	{
 		player.streamedFor_.add(player.poolID, player);
@@ -1737,8 +1818,11 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 
 		if (config.getBool("logging.log_connection_messages"))
 		{
-			core.logLn(
+			const LogField fields[] = { { "event", "join" }, { "player", player.poolID }, { "name", StringView(player.name_) }, { "bot", player.isBot_ }, { "address", StringView(addressString.data()) } };
+			core.getStructuredLogger().logRecordF(
+				CoreLogSubsystem,
 				LogLevel::Message,
+				fields,
 				"[%sjoin] %.*s has joined the server (%d:%s)",
 				player.isBot_ ? "npc:" : "",
 				PRINT_VIEW(player.name_),
@@ -1755,6 +1839,7 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 
 	void clearPlayer(Player& player, PeerDisconnectReason reason)
 	{
+		playerStreamer.remove(player.poolID);
 		for (IPlayer* p : storage.entries())
 		{
 			if (p == &player)
@@ -1797,8 +1882,11 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 
 		if (core.getConfig().getBool("logging.log_connection_messages"))
 		{
-			core.logLn(
+			const LogField fields[] = { { "event", "part" }, { "player", player.poolID }, { "name", StringView(player.name_) }, { "bot", player.isBot_ }, { "reason", int(reason) } };
+			core.getStructuredLogger().logRecordF(
+				CoreLogSubsystem,
 				LogLevel::Message,
+				fields,
 				"[%spart] %.*s has left the server (%d:%d)",
 				player.isBot_ ? "npc:" : "",
 				PRINT_VIEW(player.name_),
@@ -1814,12 +1902,14 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 	{
 		Player& player = static_cast<Player&>(peer);
 		clearPlayer(player, reason);
+		commands.onPlayerDisconnect(player.poolID);
 		storage.remove(player.poolID);
 	}
 
 	PlayerPool(ICore& core)
 		: core(core)
 		, networks(core.getNetworks())
+		, playerStreamer(*this)
 		, playerRequestSpawnRPCHandler(*this)
 		, playerRequestScoresAndPingsRPCHandler(*this)
 		, onPlayerClickMapRPCHandler(*this)
@@ -1935,6 +2025,50 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 		PacketHelper::broadcast(RPC, *this);
 	}
 
+	/// Send a packet, written once, to the candidates within range of a player
+	template <class Packet>
+	void sendInRange(const Packet& packet, IPlayer& origin, float range, const FlatPtrHashSet<IPlayer>& candidates)
+	{
+		NetworkBitStream bs;
+		packet.write(bs);
+		const Span<uint8_t> data(bs.GetData(), bs.GetNumberOfBitsUsed());
+
+		const float rangeSqr = range * range;
+		const Vector3 pos = origin.getPosition();
+		for (IPlayer* other : candidates)
+		{
+			const Vector3 dist3D = pos - other->getPosition();
+			if (glm::dot(dist3D, dist3D) <= rangeSqr)
+			{
+				other->sendRPC(Packet::PacketID, data, Packet::PacketChannel);
+			}
+		}
+	}
+
+	/// Get the players that need checking for a range-limited send
+	/// When the range is inside the stream radius only the players the origin is streamed for are checked, so players
+	/// in range that haven't streamed the origin in yet are left out
+	const FlatPtrHashSet<IPlayer>& getInRangeCandidates(IPlayer& origin, float range)
+	{
+		return range * range <= streamConfigHelper.getDistanceSqr() ? origin.streamedForPlayers() : storage.entries();
+	}
+
+	void sendClientMessageInRange(IPlayer& origin, const Colour& colour, StringView message, float range) override
+	{
+		NetCode::RPC::SendClientMessage RPC;
+		RPC.Col = colour;
+		RPC.Message = message;
+		sendInRange(RPC, origin, range, getInRangeCandidates(origin, range));
+	}
+
+	void sendChatMessageInRange(IPlayer& from, StringView message, float range) override
+	{
+		NetCode::RPC::PlayerChatMessage RPC;
+		RPC.PlayerID = static_cast<Player&>(from).poolID;
+		RPC.message = message;
+		sendInRange(RPC, from, range, getInRangeCandidates(from, range));
+	}
+
 	void sendGameTextToAll(StringView message, Milliseconds time, int style) override
 	{
 		if (fixesComponent)
@@ -2004,6 +2138,9 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 		streamConfigHelper = StreamConfigHelper(config);
 		playerTextRPCHandler.init(config);
 		playerCommandRPCHandler.init(config);
+		DynamicArray<StringView> filterWords(config.getStringsCount("chat_input_filter_words"));
+		config.getStrings("chat_input_filter_words", Span<StringView>(filterWords.data(), filterWords.size()));
+		textFilter.setWords(Span<const StringView>(filterWords.data(), filterWords.size()));
 		playerDeathRPCHandler.init(config);
 		markersShow = config.getInt("game.player_marker_mode");
 		markersLimit = config.getBool("game.use_player_marker_draw_radius");
@@ -2014,6 +2151,20 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 		validateAnimations_ = config.getBool("game.validate_animations");
 		allowInteriorWeapons_ = config.getBool("game.allow_interior_weapons");
 		maxBots = config.getInt("max_bots");
+		streamInBudget = config.getInt("network.player_stream_in_budget");
+
+		ITickProfiler& profiler = core.getTickProfiler();
+		playerSpawnDispatcher.setProfiler(&profiler, "PlayerSpawnEventHandler");
+		playerConnectDispatcher.setProfiler(&profiler, "PlayerConnectEventHandler");
+		playerStreamDispatcher.setProfiler(&profiler, "PlayerStreamEventHandler");
+		playerTextDispatcher.setProfiler(&profiler, "PlayerTextEventHandler");
+		playerShotDispatcher.setProfiler(&profiler, "PlayerShotEventHandler");
+		playerChangeDispatcher.setProfiler(&profiler, "PlayerChangeEventHandler");
+		playerDamageDispatcher.setProfiler(&profiler, "PlayerDamageEventHandler");
+		playerClickDispatcher.setProfiler(&profiler, "PlayerClickEventHandler");
+		playerCheckDispatcher.setProfiler(&profiler, "PlayerCheckEventHandler");
+		playerUpdateDispatcher.setProfiler(&profiler, "PlayerUpdateEventHandler");
+		storage.getEventDispatcher().setProfiler(&profiler, "PlayerPoolEventHandler");
 
 		playerUpdateDispatcher.addEventHandler(this);
 		core.getEventDispatcher().addEventHandler(this, EventPriority_FairlyLow /* want this to execute after others */);
@@ -2044,7 +2195,6 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 	bool onPlayerUpdate(IPlayer& p, TimePoint now) override
 	{
 		Player& player = static_cast<Player&>(p);
-		const float maxDist = streamConfigHelper.getDistanceSqr();
 		const Milliseconds gameTimeUpdateRateMS(*gameTimeUpdateRate);
 		const Milliseconds markersUpdateRateMS(*markersUpdateRate);
 		const bool shouldStream = streamConfigHelper.shouldStream(player.poolID, now);
@@ -2058,45 +2208,7 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 
 		if (shouldStream)
 		{
-			for (IPlayer* other : storage.entries())
-			{
-				if (&player == other)
-				{
-					continue;
-				}
-
-				Vector3 otherPos = other->getPosition();
-				const PlayerState state = other->getState();
-
-				// Use vehicle pos if player is passenger to keep paused players synced.
-				if (state == PlayerState_Passenger)
-				{
-					auto vehicleData = queryExtension<IPlayerVehicleData>(other);
-
-					if (vehicleData)
-					{
-						auto vehicle = vehicleData->getVehicle();
-
-						if (vehicle)
-						{
-							otherPos = vehicle->getPosition();
-						}
-					}
-				}
-
-				const Vector2 dist2D = player.pos_ - otherPos;
-				const bool shouldBeStreamedIn = state != PlayerState_Spectating && state != PlayerState_None && other->getVirtualWorld() == player.virtualWorld_ && glm::dot(dist2D, dist2D) < maxDist;
-
-				const bool isStreamedIn = other->isStreamedInForPlayer(player);
-				if (!isStreamedIn && shouldBeStreamedIn)
-				{
-					other->streamInForPlayer(player);
-				}
-				else if (isStreamedIn && !shouldBeStreamedIn)
-				{
-					other->streamOutForPlayer(player);
-				}
-			}
+			playerStreamer.queue(player);
 		}
 
 		return true;
@@ -2104,6 +2216,9 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 
 	void onTick(Microseconds elapsed, TimePoint now) override
 	{
+		playerStreamer.setStreamInBudget(std::max(*streamInBudget, 0));
+		playerStreamer.update(core);
+
 		for (auto it = storage.entries().begin(); it != storage.entries().end();)
 		{
 			Player* player = static_cast<Player*>(*it);
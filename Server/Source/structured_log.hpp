@@ -0,0 +1,514 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include "log_sink.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+using namespace Impl;
+
+/// Filters log records by their subsystem's level and writes them to the structured log
+///
+/// JSON lines format, one object per line:
+/// `{"ts":"2024-01-01T00:00:00.000000Z","level":"info","subsystem":"Pawn","msg":"...","fields":{"key":value}}`
+///
+/// Binary format, little endian, one record after another:
+/// ```
+/// uint32 size of the rest of the record
+/// uint8 format version, 1
+/// int64 microseconds since the Unix epoch
+/// uint8 level, as LogLevel
+/// uint64 subsystem UID, 0 for the core
+/// uint16 message length, message bytes
+/// uint8 field count, then per field:
+///     uint8 key length, key bytes, uint8 type as LogField::Type,
+///     int64 | float64 | uint8 | uint16 length and bytes for Int | Float | Bool | String
+/// ```
+class StructuredLog final : public NoCopy
+{
+public:
+	enum class Format
+	{
+		None,
+		JSON,
+		Binary
+	};
+
+	StructuredLog()
+		: records_(false)
+	{
+	}
+
+	/// Set up the subsystems that can have their own level and parse `logging.levels`
+	/// Entries are `name=level`, where the name is a component's name, its UID in hex, `core`, or `*` for the default
+	/// Only called before other threads log, the table isn't changed afterwards
+	void setSubsystems(const DynamicArray<Pair<UID, StringView>>& subsystems, const DynamicArray<String>* levels, ILogger& logger)
+	{
+		subsystems_.reset(new Subsystem[subsystems.size() + 1]);
+		subsystemCount_ = subsystems.size() + 1;
+		subsystems_[0].uid = CoreLogSubsystem;
+		subsystems_[0].name = "core";
+		subsystemLookup_.clear();
+		subsystemLookup_.emplace(CoreLogSubsystem, 0);
+		for (size_t i = 0; i != subsystems.size(); ++i)
+		{
+			subsystems_[i + 1].uid = subsystems[i].first;
+			subsystems_[i + 1].name = String(subsystems[i].second);
+			subsystemLookup_.emplace(subsystems[i].first, i + 1);
+		}
+		for (size_t i = 0; i != subsystemCount_; ++i)
+		{
+			subsystems_[i].level = -1;
+		}
+
+		if (levels == nullptr)
+		{
+			return;
+		}
+
+		for (const String& entry : *levels)
+		{
+			const size_t separator = entry.find('=');
+			int level = separator == String::npos ? -1 : parseLevel(StringView(entry).substr(separator + 1));
+			if (level < 0)
+			{
+				logger.logLn(LogLevel::Warning, "Invalid `logging.levels` entry \"%s\", expected `name=debug|info|warning|error|none`", entry.c_str());
+				continue;
+			}
+
+			const StringView name = StringView(entry).substr(0, separator);
+			if (!setLevel(name, level))
+			{
+				logger.logLn(LogLevel::Warning, "Unknown `logging.levels` subsystem \"%.*s\"", PRINT_VIEW(name));
+			}
+		}
+	}
+
+	/// Start writing records to a file, from `logging.structured_*`
+	bool open(Format format, const String& path, uint64_t rotateBytes, Seconds rotateInterval)
+	{
+		format_ = format;
+		if (format_ == Format::None)
+		{
+			return true;
+		}
+
+		records_.setRotation(rotateBytes, rotateInterval);
+		records_.setDroppedNotice(format_ == Format::JSON ? &buildDroppedJSON : &buildDroppedBinary);
+		if (!records_.openFile(path))
+		{
+			format_ = Format::None;
+			return false;
+		}
+		return true;
+	}
+
+	void start(Milliseconds flushInterval)
+	{
+		if (format_ != Format::None)
+		{
+			records_.start(flushInterval);
+		}
+	}
+
+	void stop()
+	{
+		records_.stop();
+	}
+
+	bool reopen()
+	{
+		return records_.reopenFile();
+	}
+
+	bool isEnabled(UID subsystem, LogLevel level) const
+	{
+		return level >= getLevel(subsystem);
+	}
+
+	LogLevel getLevel(UID subsystem) const
+	{
+		int level = -1;
+		auto it = subsystemLookup_.find(subsystem);
+		if (it != subsystemLookup_.end())
+		{
+			level = subsystems_[it->second].level.load(std::memory_order_relaxed);
+		}
+		return LogLevel(level < 0 ? defaultLevel_.load(std::memory_order_relaxed) : level);
+	}
+
+	bool setLevel(UID subsystem, LogLevel level)
+	{
+		auto it = subsystemLookup_.find(subsystem);
+		if (it == subsystemLookup_.end())
+		{
+			return false;
+		}
+		subsystems_[it->second].level.store(level, std::memory_order_relaxed);
+		return true;
+	}
+
+	/// Set a subsystem's level by its name or UID in hex, or the default level with `*`
+	bool setLevel(StringView name, int level)
+	{
+		if (name == "*")
+		{
+			defaultLevel_ = level;
+			return true;
+		}
+
+		Subsystem* subsystem = findByName(name);
+		if (subsystem == nullptr)
+		{
+			return false;
+		}
+		subsystem->level = level;
+		return true;
+	}
+
+	/// Write a record to the structured log, if there is one
+	void write(UID subsystem, LogLevel level, StringView message, Span<const LogField> fields)
+	{
+		if (format_ == Format::None)
+		{
+			return;
+		}
+
+		const int64_t time = duration_cast<Microseconds>(WorldTime::now().time_since_epoch()).count();
+		if (format_ == Format::JSON)
+		{
+			records_.write(level, false, [this, time, subsystem, level, message, fields](String& line)
+				{
+					buildJSON(line, time, subsystem, level, message, fields);
+				});
+		}
+		else
+		{
+			records_.write(level, false, [time, subsystem, level, message, fields](String& line)
+				{
+					buildBinary(line, time, subsystem, level, message, fields);
+				});
+		}
+	}
+
+	/// Parse a level name, returning -1 if it isn't one
+	/// `none` gives a level above all others to write nothing
+	static int parseLevel(StringView name)
+	{
+		static const char* const Names[] = { "debug", "info", "warning", "error", "none" };
+		for (int i = 0; i != 5; ++i)
+		{
+			if (name == Names[i])
+			{
+				return i;
+			}
+		}
+		return -1;
+	}
+
+private:
+	struct Subsystem
+	{
+		UID uid;
+		String name;
+		/// The subsystem's level, or -1 to use the default
+		std::atomic<int> level;
+	};
+
+	Subsystem* findByName(StringView name)
+	{
+		char* end;
+		const UID uid = strtoull(String(name).c_str(), &end, 16);
+		const bool isUID = name.size() > 2 && name.substr(0, 2) == "0x" && *end == 0;
+		for (size_t i = 0; i != subsystemCount_; ++i)
+		{
+			Subsystem& subsystem = subsystems_[i];
+			if ((isUID && subsystem.uid == uid) || std::equal(subsystem.name.begin(), subsystem.name.end(), name.begin(), name.end(), [](char a, char b)
+					{
+						return tolower(static_cast<unsigned char>(a)) == tolower(static_cast<unsigned char>(b));
+					}))
+			{
+				return &subsystem;
+			}
+		}
+		return nullptr;
+	}
+
+	static const char* levelName(LogLevel level)
+	{
+		static const char* const Names[] = { "debug", "info", "warning", "error" };
+		return level >= LogLevel::Debug && level <= LogLevel::Error ? Names[level] : "unknown";
+	}
+
+	/// Get the length of the UTF-8 sequence starting at `at`, or 0 if it isn't a valid one
+	static size_t getUTF8SequenceLength(StringView value, size_t at)
+	{
+		const unsigned char lead = value[at];
+		size_t length;
+		unsigned char min = 0x80, max = 0xBF;
+		if (lead >= 0xC2 && lead <= 0xDF)
+		{
+			length = 2;
+		}
+		else if (lead >= 0xE0 && lead <= 0xEF)
+		{
+			length = 3;
+			// Overlong encodings and UTF-16 surrogates
+			min = lead == 0xE0 ? 0xA0 : 0x80;
+			max = lead == 0xED ? 0x9F : 0xBF;
+		}
+		else if (lead >= 0xF0 && lead <= 0xF4)
+		{
+			length = 4;
+			// Overlong encodings and code points above U+10FFFF
+			min = lead == 0xF0 ? 0x90 : 0x80;
+			max = lead == 0xF4 ? 0x8F : 0xBF;
+		}
+		else
+		{
+			return 0;
+		}
+
+		if (at + length > value.size())
+		{
+			return 0;
+		}
+		for (size_t i = 1; i != length; ++i)
+		{
+			const unsigned char c = value[at + i];
+			if (c < min || c > max)
+			{
+				return 0;
+			}
+			min = 0x80;
+			max = 0xBF;
+		}
+		return length;
+	}
+
+	/// Messages are often in the server's legacy code page rather than UTF-8, so bytes that aren't part of a valid
+	/// UTF-8 sequence are escaped as the Latin-1 character of the same value to keep the line valid JSON
+	static void appendJSONString(String& out, StringView value)
+	{
+		static const char Hex[] = "0123456789abcdef";
+		out += '"';
+		for (size_t i = 0; i != value.size(); ++i)
+		{
+			const unsigned char c = value[i];
+			switch (c)
+			{
+			case '"':
+				out += "\\\"";
+				break;
+			case '\\':
+				out += "\\\\";
+				break;
+			case '\n':
+				out += "\\n";
+				break;
+			case '\r':
+				out += "\\r";
+				break;
+			case '\t':
+				out += "\\t";
+				break;
+			default:
+				if (c < 0x20 || c >= 0x80)
+				{
+					const size_t length = c >= 0x80 ? getUTF8SequenceLength(value, i) : 0;
+					if (length)
+					{
+						out.append(value.data() + i, length);
+						i += length - 1;
+					}
+					else
+					{
+						out += "\\u00";
+						out += Hex[c >> 4];
+						out += Hex[c & 0xF];
+					}
+				}
+				else
+				{
+					out += char(c);
+				}
+			}
+		}
+		out += '"';
+	}
+
+	/// Format microseconds since the Unix epoch as an ISO 8601 UTC time with microseconds
+	static void formatJSONTime(char (&buffer)[64], int64_t time)
+	{
+		const std::time_t seconds = time / 1000000;
+		std::tm utc;
+#ifdef BUILD_WINDOWS
+		gmtime_s(&utc, &seconds);
+#else
+		gmtime_r(&seconds, &utc);
+#endif
+		const size_t len = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &utc);
+		snprintf(buffer + len, sizeof(buffer) - len, ".%06dZ", int(time % 1000000));
+	}
+
+	void buildJSON(String& line, int64_t time, UID subsystem, LogLevel level, StringView message, Span<const LogField> fields) const
+	{
+		char buffer[64];
+		formatJSONTime(buffer, time);
+
+		line += "{\"ts\":\"";
+		line += buffer;
+		line += "\",\"level\":\"";
+		line += levelName(level);
+		line += "\",\"subsystem\":";
+		auto it = subsystemLookup_.find(subsystem);
+		if (it != subsystemLookup_.end())
+		{
+			appendJSONString(line, subsystems_[it->second].name);
+		}
+		else
+		{
+			snprintf(buffer, sizeof(buffer), "\"0x%016llx\"", static_cast<unsigned long long>(subsystem));
+			line += buffer;
+		}
+		line += ",\"msg\":";
+		appendJSONString(line, message);
+
+		if (!fields.empty())
+		{
+			line += ",\"fields\":{";
+			for (size_t i = 0; i != fields.size(); ++i)
+			{
+				const LogField& field = fields[i];
+				if (i)
+				{
+					line += ',';
+				}
+				appendJSONString(line, field.key);
+				line += ':';
+				switch (field.type)
+				{
+				case LogField::Type::Int:
+					snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(field.intValue));
+					line += buffer;
+					break;
+				case LogField::Type::Float:
+					if (std::isfinite(field.floatValue))
+					{
+						snprintf(buffer, sizeof(buffer), "%.17g", field.floatValue);
+						line += buffer;
+					}
+					else
+					{
+						line += "null";
+					}
+					break;
+				case LogField::Type::Bool:
+					line += field.boolValue ? "true" : "false";
+					break;
+				case LogField::Type::String:
+					appendJSONString(line, field.stringValue);
+					break;
+				}
+			}
+			line += '}';
+		}
+		line += "}\n";
+	}
+
+	template <typename T>
+	static void appendBinary(String& out, T value)
+	{
+		out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	static void appendBinaryString(String& out, StringView value, size_t maxLength)
+	{
+		const size_t length = std::min(value.size(), maxLength);
+		if (maxLength == UINT8_MAX)
+		{
+			appendBinary<uint8_t>(out, length);
+		}
+		else
+		{
+			appendBinary<uint16_t>(out, length);
+		}
+		out.append(value.data(), length);
+	}
+
+	static void buildBinary(String& line, int64_t time, UID subsystem, LogLevel level, StringView message, Span<const LogField> fields)
+	{
+		appendBinary<uint32_t>(line, 0);
+		appendBinary<uint8_t>(line, 1);
+		appendBinary<int64_t>(line, time);
+		appendBinary<uint8_t>(line, level);
+		appendBinary<uint64_t>(line, subsystem);
+		appendBinaryString(line, message, UINT16_MAX);
+
+		const size_t count = std::min<size_t>(fields.size(), UINT8_MAX);
+		appendBinary<uint8_t>(line, count);
+		for (size_t i = 0; i != count; ++i)
+		{
+			const LogField& field = fields[i];
+			appendBinaryString(line, field.key, UINT8_MAX);
+			appendBinary<uint8_t>(line, uint8_t(field.type));
+			switch (field.type)
+			{
+			case LogField::Type::Int:
+				appendBinary<int64_t>(line, field.intValue);
+				break;
+			case LogField::Type::Float:
+				appendBinary<double>(line, field.floatValue);
+				break;
+			case LogField::Type::Bool:
+				appendBinary<uint8_t>(line, field.boolValue);
+				break;
+			case LogField::Type::String:
+				appendBinaryString(line, field.stringValue, UINT16_MAX);
+				break;
+			}
+		}
+
+		const uint32_t size = line.size() - sizeof(uint32_t);
+		memcpy(&line[0], &size, sizeof(size));
+	}
+
+	static void buildDroppedJSON(String& line, uint64_t dropped)
+	{
+		char time[64];
+		formatJSONTime(time, duration_cast<Microseconds>(WorldTime::now().time_since_epoch()).count());
+		char buffer[224];
+		snprintf(buffer, sizeof(buffer), "{\"ts\":\"%s\",\"level\":\"warning\",\"subsystem\":\"core\",\"msg\":\"Dropped log records because the log queue was full.\",\"fields\":{\"dropped\":%llu}}\n", time, static_cast<unsigned long long>(dropped));
+		line = buffer;
+	}
+
+	static void buildDroppedBinary(String& line, uint64_t dropped)
+	{
+		const LogField fields[] = { LogField("dropped", dropped) };
+		line.clear();
+		buildBinary(line, duration_cast<Microseconds>(WorldTime::now().time_since_epoch()).count(), CoreLogSubsystem, LogLevel::Warning,
+			"Dropped log records because the log queue was full.", Span<const LogField>(fields, 1));
+	}
+
+#ifdef _DEBUG
+	static constexpr int DefaultLevel = LogLevel::Debug;
+#else
+	static constexpr int DefaultLevel = LogLevel::Message;
+#endif
+
+	LogSink records_;
+	Format format_ = Format::None;
+	std::unique_ptr<Subsystem[]> subsystems_;
+	size_t subsystemCount_ = 0;
+	FlatHashMap<UID, size_t> subsystemLookup_;
+	std::atomic<int> defaultLevel_ { DefaultLevel };
+};
@@ -0,0 +1,246 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <profiler.hpp>
+#include <types.hpp>
+
+using namespace Impl;
+
+/// Aggregates per-tick section times into a ring of one second histograms
+/// Each section's time is summed over a tick, then added to the current second's histogram when the tick ends
+class TickProfiler final : public ITickProfiler, public NoCopy
+{
+public:
+	bool isEnabled() const override
+	{
+		return enabled_;
+	}
+
+	void setEnabled(bool enabled) override
+	{
+		if (enabled == enabled_)
+		{
+			return;
+		}
+
+		enabled_ = enabled;
+		for (int section : ran_)
+		{
+			sections_[section].current = Nanoseconds(0);
+		}
+		ran_.clear();
+	}
+
+	int addSection(StringView name) override
+	{
+		for (size_t i = 0; i != sections_.size(); ++i)
+		{
+			if (sections_[i].name == name)
+			{
+				return i;
+			}
+		}
+
+		sections_.emplace_back();
+		sections_.back().name = String(name);
+		return sections_.size() - 1;
+	}
+
+	void record(int section, Nanoseconds time) override
+	{
+		if (section < 0 || section >= int(sections_.size()))
+		{
+			return;
+		}
+
+		Section& data = sections_[section];
+		if (data.current == Nanoseconds(0))
+		{
+			ran_.push_back(section);
+		}
+		// Keep a section that ran in no measurable time distinguishable from one that didn't run.
+		data.current += std::max(time, Nanoseconds(1));
+	}
+
+	bool getStats(int section, TickProfileWindow window, TickProfileStats& stats) const override
+	{
+		if (section < 0 || section >= int(sections_.size()) || window < 0 || window >= TickProfileWindow_End)
+		{
+			return false;
+		}
+
+		static const size_t WindowLengths[TickProfileWindow_End] = { 1, 10, 60 };
+
+		// Merge the last complete seconds, the current one is still being filled.
+		const Section& data = sections_[section];
+		Histogram merged {};
+		for (size_t i = 1; i <= WindowLengths[window]; ++i)
+		{
+			const Histogram& second = data.seconds[(slot_ + HistorySeconds - i) % HistorySeconds];
+			for (size_t bucket = 0; bucket != BucketCount; ++bucket)
+			{
+				merged.counts[bucket] += second.counts[bucket];
+			}
+			merged.ticks += second.ticks;
+			merged.max = std::max(merged.max, second.max);
+		}
+
+		stats.ticks = merged.ticks;
+		stats.max = Microseconds(merged.max);
+		stats.p50 = percentile(merged, 0.5);
+		stats.p99 = percentile(merged, 0.99);
+		return true;
+	}
+
+	void enumSections(TickProfileEnumeratorCallback& callback) const override
+	{
+		for (size_t i = 0; i != sections_.size(); ++i)
+		{
+			if (!callback.proc(i, sections_[i].name))
+			{
+				break;
+			}
+		}
+	}
+
+	void reset() override
+	{
+		for (Section& section : sections_)
+		{
+			section.current = Nanoseconds(0);
+			for (Histogram& second : section.seconds)
+			{
+				second.clear();
+			}
+		}
+		ran_.clear();
+	}
+
+	/// Move the sections' times for the ended tick into the histograms
+	void endTick(TimePoint now)
+	{
+		if (now - slotStart_ >= Seconds(1))
+		{
+			// Skip over and clear any seconds in which no tick ended, e.g. while the server was stalled.
+			const long long elapsed = std::min<long long>(duration_cast<Seconds>(now - slotStart_).count(), HistorySeconds);
+			for (long long i = 0; i != elapsed; ++i)
+			{
+				slot_ = (slot_ + 1) % HistorySeconds;
+				for (Section& section : sections_)
+				{
+					section.seconds[slot_].clear();
+				}
+			}
+			slotStart_ = now;
+		}
+
+		for (int section : ran_)
+		{
+			Section& data = sections_[section];
+			data.seconds[slot_].add(duration_cast<Microseconds>(data.current).count());
+			data.current = Nanoseconds(0);
+		}
+		ran_.clear();
+	}
+
+private:
+	/// 8 exact buckets then 8 buckets per power of two up to 2^24us, giving at most 12.5% error
+	static constexpr size_t SubBuckets = 8;
+	static constexpr size_t BucketCount = SubBuckets * 22;
+	/// A minute of complete seconds plus the one being filled
+	static constexpr size_t HistorySeconds = 61;
+
+	struct Histogram
+	{
+		StaticArray<uint32_t, BucketCount> counts;
+		long long max;
+		unsigned ticks;
+
+		void clear()
+		{
+			counts.fill(0);
+			max = 0;
+			ticks = 0;
+		}
+
+		void add(long long us)
+		{
+			++counts[bucketOf(us)];
+			max = std::max(max, us);
+			++ticks;
+		}
+	};
+
+	struct Section
+	{
+		String name;
+		Nanoseconds current = Nanoseconds(0);
+		StaticArray<Histogram, HistorySeconds> seconds;
+
+		Section()
+		{
+			for (Histogram& second : seconds)
+			{
+				second.clear();
+			}
+		}
+	};
+
+	static size_t bucketOf(long long us)
+	{
+		if (us < static_cast<long long>(SubBuckets))
+		{
+			return std::max(us, 0ll);
+		}
+
+		const int msb = 63 - __builtin_clzll(us);
+		const size_t bucket = (msb - 2) * SubBuckets + ((us >> (msb - 3)) & (SubBuckets - 1));
+		return std::min(bucket, BucketCount - 1);
+	}
+
+	static long long bucketUpperBound(size_t bucket)
+	{
+		if (bucket < SubBuckets)
+		{
+			return bucket;
+		}
+
+		const int shift = bucket / SubBuckets - 1;
+		return ((SubBuckets + bucket % SubBuckets + 1ll) << shift) - 1;
+	}
+
+	static Microseconds percentile(const Histogram& histogram, float fraction)
+	{
+		if (histogram.ticks == 0)
+		{
+			return Microseconds(0);
+		}
+
+		const unsigned target = std::max(1u, unsigned(std::ceil(histogram.ticks * fraction)));
+		unsigned seen = 0;
+		for (size_t bucket = 0; bucket != BucketCount; ++bucket)
+		{
+			seen += histogram.counts[bucket];
+			if (seen >= target)
+			{
+				return Microseconds(std::min(bucketUpperBound(bucket), histogram.max));
+			}
+		}
+		return Microseconds(histogram.max);
+	}
+
+	bool enabled_ = false;
+	DynamicArray<Section> sections_;
+	DynamicArray<int> ran_;
+	size_t slot_ = 0;
+	TimePoint slotStart_ = Time::now();
+};
@@ -0,0 +1,145 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <core.hpp>
+#include <mutex>
+#include <thread>
+
+/// A fork-join pool of worker threads used by ICore::runParallel
+/// The calling thread takes part in the work and blocks until every item is processed
+class WorkerPool final : public NoCopy
+{
+public:
+	~WorkerPool()
+	{
+		stop();
+	}
+
+	/// Start the given number of threads besides the main one
+	void start(unsigned count)
+	{
+		stop();
+		stopping_ = false;
+		for (unsigned i = 0; i != count; ++i)
+		{
+			threads_.emplace_back(&WorkerPool::threadProc, this, generation_);
+		}
+	}
+
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopping_ = true;
+		}
+		wake_.notify_all();
+		for (std::thread& thread : threads_)
+		{
+			thread.join();
+		}
+		threads_.clear();
+	}
+
+	size_t size() const
+	{
+		return threads_.size();
+	}
+
+	void run(IParallelTask& task, size_t count)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		// Split the work into a few chunks per thread so slow ranges can be balanced out.
+		const size_t chunk = std::max<size_t>(1, count / ((threads_.size() + 1) * 4));
+		if (threads_.empty() || count <= chunk)
+		{
+			task.process(0, count);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			task_ = &task;
+			count_ = count;
+			chunk_ = chunk;
+			next_ = 0;
+			busy_ = threads_.size();
+			++generation_;
+		}
+		wake_.notify_all();
+
+		work();
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		done_.wait(lock, [this]()
+			{
+				return busy_ == 0;
+			});
+		task_ = nullptr;
+	}
+
+private:
+	void work()
+	{
+		for (;;)
+		{
+			const size_t begin = next_.fetch_add(chunk_);
+			if (begin >= count_)
+			{
+				break;
+			}
+			task_->process(begin, std::min(begin + chunk_, count_));
+		}
+	}
+
+	void threadProc(unsigned seen)
+	{
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				wake_.wait(lock, [this, seen]()
+					{
+						return stopping_ || generation_ != seen;
+					});
+				if (stopping_)
+				{
+					return;
+				}
+				seen = generation_;
+			}
+
+			work();
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (--busy_ == 0)
+			{
+				done_.notify_one();
+			}
+		}
+	}
+
+	Impl::DynamicArray<std::thread> threads_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable done_;
+	IParallelTask* task_ = nullptr;
+	size_t count_ = 0;
+	size_t chunk_ = 1;
+	std::atomic<size_t> next_ { 0 };
+	size_t busy_ = 0;
+	unsigned generation_ = 0;
+	bool stopping_ = false;
+};